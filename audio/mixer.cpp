@@ -26,6 +26,7 @@
 
 #include "audio/mixer_intern.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
@@ -134,6 +135,11 @@ public:
 	*/
 	void resetRate();
 
+	/**
+	 * Get the native sample rate of the channel's AudioStream.
+	 */
+	uint32 getNativeRate() { return _stream->getRate(); }
+
 	/**
 	 * Notifies the channel that the global sound type
 	 * volume settings changed.
@@ -197,17 +203,29 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _resamplerQuality(kResamplerLinear), _soundTypeSettings(),
+	  _queueMutex(), _useCommandQueue(false), _commandRead(0), _commandWrite(0) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = nullptr;
+
+	// Share the resampling filters before the audio thread starts
+	PolyphaseFilterCache::createInstance();
 }
 
 MixerImpl::~MixerImpl() {
+	// Channels which were posted but never picked up by the audio thread
+	for (uint i = _commandRead; i != _commandWrite; i = (i + 1) % COMMAND_QUEUE_SIZE) {
+		if (_commands[i].type == ChannelCommand::kCmdPlay)
+			delete _commands[i].chan;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	PolyphaseFilterCache::destroyInstance();
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -216,6 +234,41 @@ void MixerImpl::setReady(bool ready) {
 	_mixerReady = ready;
 }
 
+void MixerImpl::setCommandQueueEnabled(bool enable) {
+	Common::StackLock lock(_mutex);
+
+	if (_useCommandQueue == enable)
+		return;
+
+	if (_useCommandQueue)
+		processCommands();
+
+	Common::StackLock queueLock(_queueMutex);
+
+	_useCommandQueue = enable;
+	if (!enable)
+		return;
+
+	// Seed the shadow state from the current channels
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		ChannelShadow &shadow = _shadow[i];
+		shadow = ChannelShadow();
+
+		if (!_channels[i])
+			continue;
+
+		shadow.active = true;
+		shadow.handle = _channels[i]->getHandle()._val;
+		shadow.id = _channels[i]->getId();
+		shadow.type = _channels[i]->getType();
+		shadow.permanent = _channels[i]->isPermanent();
+		shadow.volume = _channels[i]->getVolume();
+		shadow.balance = _channels[i]->getBalance();
+		shadow.rate = _channels[i]->getRate();
+		shadow.nativeRate = _channels[i]->getNativeRate();
+	}
+}
+
 uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
@@ -253,6 +306,116 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		*handle = chanHandle;
 }
 
+#pragma mark -
+#pragma mark --- Command queue ---
+#pragma mark -
+
+MixerImpl::ChannelShadow *MixerImpl::findShadow(SoundHandle handle) {
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_shadow[index].active || _shadow[index].handle != handle._val)
+		return nullptr;
+
+	return &_shadow[index];
+}
+
+void MixerImpl::postCommand(ChannelCommand::Type type, int index, uint32 handle, int value, Channel *chan) {
+	ChannelCommand cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.handle = handle;
+	cmd.value = value;
+	cmd.chan = chan;
+
+	for (;;) {
+		{
+			Common::StackLock lock(_queueMutex);
+
+			const uint next = (_commandWrite + 1) % COMMAND_QUEUE_SIZE;
+			if (next != _commandRead) {
+				_commands[_commandWrite] = cmd;
+				_commandWrite = next;
+				return;
+			}
+		}
+
+		// The audio thread is not keeping up (or not running at all),
+		// so apply the pending commands ourselves.
+		Common::StackLock lock(_mutex);
+		processCommands();
+	}
+}
+
+void MixerImpl::processCommands() {
+	uint count = 0;
+
+	{
+		Common::StackLock lock(_queueMutex);
+
+		while (_commandRead != _commandWrite) {
+			_pendingCommands[count++] = _commands[_commandRead];
+			_commandRead = (_commandRead + 1) % COMMAND_QUEUE_SIZE;
+		}
+	}
+
+	// Apply the commands outside of the queue lock, since stopping a
+	// channel may have to free its stream.
+	for (uint i = 0; i < count; i++)
+		applyCommand(_pendingCommands[i]);
+}
+
+void MixerImpl::applyCommand(const ChannelCommand &cmd) {
+	if (cmd.type == ChannelCommand::kCmdGlobalVolume) {
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)cmd.value)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+	}
+
+	if (cmd.type == ChannelCommand::kCmdPlay) {
+		// The slot may still hold a channel which was stopped by another
+		// thread, but whose stop command was queued after this one.
+		delete _channels[cmd.index];
+		_channels[cmd.index] = cmd.chan;
+		return;
+	}
+
+	Channel *chan = _channels[cmd.index];
+	if (!chan || chan->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case ChannelCommand::kCmdStop:
+		delete chan;
+		_channels[cmd.index] = nullptr;
+		break;
+	case ChannelCommand::kCmdPause:
+		chan->pause(cmd.value != 0);
+		break;
+	case ChannelCommand::kCmdSetVolume:
+		chan->setVolume((byte)cmd.value);
+		break;
+	case ChannelCommand::kCmdSetBalance:
+		chan->setBalance((int8)cmd.value);
+		break;
+	case ChannelCommand::kCmdSetRate:
+		chan->setRate((uint32)cmd.value);
+		break;
+	case ChannelCommand::kCmdResetRate:
+		chan->resetRate();
+		break;
+	case ChannelCommand::kCmdLoop:
+		chan->loop();
+		break;
+	default:
+		break;
+	}
+}
+
+#pragma mark -
+#pragma mark --- Mixer API ---
+#pragma mark -
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -261,6 +424,11 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
+	if (_useCommandQueue) {
+		postPlayStream(type, handle, stream, id, volume, balance, autofreeStream, permanent, reverseStereo);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	if (stream == nullptr) {
@@ -298,11 +466,93 @@ void MixerImpl::playStream(
 	insertChannel(handle, chan);
 }
 
+void MixerImpl::postPlayStream(
+			SoundType type,
+			SoundHandle *handle,
+			AudioStream *stream,
+			int id, byte volume, int8 balance,
+			DisposeAfterUse::Flag autofreeStream,
+			bool permanent,
+			bool reverseStereo) {
+	if (stream == nullptr) {
+		warning("stream is 0");
+		return;
+	}
+
+	assert(_mixerReady);
+
+	int index = -1;
+	SoundHandle chanHandle;
+
+	{
+		Common::StackLock lock(_queueMutex);
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (!_shadow[i].active)
+				continue;
+
+			// Prevent duplicate sounds (see playStream())
+			if (id != -1 && _shadow[i].id == id) {
+				if (autofreeStream == DisposeAfterUse::YES)
+					delete stream;
+				return;
+			}
+		}
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (!_shadow[i].active) {
+				index = i;
+				break;
+			}
+		}
+		if (index == -1) {
+			warning("MixerImpl::out of mixer slots");
+			if (autofreeStream == DisposeAfterUse::YES)
+				delete stream;
+			return;
+		}
+
+		chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+		_handleSeed++;
+
+		ChannelShadow &shadow = _shadow[index];
+		shadow.active = true;
+		shadow.handle = chanHandle._val;
+		shadow.id = id;
+		shadow.type = type;
+		shadow.permanent = permanent;
+		shadow.ownsStream = (autofreeStream == DisposeAfterUse::YES);
+		shadow.volume = volume;
+		shadow.balance = balance;
+		shadow.rate = stream->getRate();
+		shadow.nativeRate = stream->getRate();
+	}
+
+#ifdef AUDIO_REVERSE_STEREO
+	reverseStereo = !reverseStereo;
+#endif
+
+	// The channel is created on the calling thread and then handed over
+	// to the audio thread.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	chan->setVolume(volume);
+	chan->setBalance(balance);
+	chan->setHandle(chanHandle);
+
+	if (handle)
+		*handle = chanHandle;
+
+	postCommand(ChannelCommand::kCmdPlay, index, chanHandle._val, 0, chan);
+}
+
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
 	Common::StackLock lock(_mutex);
 
+	if (_useCommandQueue)
+		processCommands();
+
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
@@ -321,10 +571,13 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	}
 
 	// mix all channels
+	uint32 finished[NUM_CHANNELS];
+	int numFinished = 0;
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
+				finished[numFinished++] = _channels[i]->getHandle()._val;
 				delete _channels[i];
 				_channels[i] = nullptr;
 			} else if (!_channels[i]->isPaused()) {
@@ -335,10 +588,47 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			}
 		}
 
+	// Release the slots of finished channels, unless the engine side
+	// has already reused them.
+	if (_useCommandQueue && numFinished) {
+		Common::StackLock queueLock(_queueMutex);
+		for (int i = 0; i < numFinished; i++) {
+			ChannelShadow &shadow = _shadow[finished[i] % NUM_CHANNELS];
+			if (shadow.handle == finished[i])
+				shadow.active = false;
+		}
+	}
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
+	if (_useCommandQueue) {
+		uint32 handles[NUM_CHANNELS];
+		int count = 0;
+		bool mustSync = false;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_shadow[i].active && !_shadow[i].permanent) {
+					_shadow[i].active = false;
+					mustSync |= !_shadow[i].ownsStream;
+					handles[count++] = _shadow[i].handle;
+				}
+			}
+		}
+
+		for (int i = 0; i < count; i++)
+			postCommand(ChannelCommand::kCmdStop, handles[i] % NUM_CHANNELS, handles[i]);
+
+		if (mustSync) {
+			Common::StackLock lock(_mutex);
+			processCommands();
+		}
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
@@ -349,6 +639,32 @@ void MixerImpl::stopAll() {
 }
 
 void MixerImpl::stopID(int id) {
+	if (_useCommandQueue) {
+		uint32 handles[NUM_CHANNELS];
+		int count = 0;
+		bool mustSync = false;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_shadow[i].active && _shadow[i].id == id) {
+					_shadow[i].active = false;
+					mustSync |= !_shadow[i].ownsStream;
+					handles[count++] = _shadow[i].handle;
+				}
+			}
+		}
+
+		for (int i = 0; i < count; i++)
+			postCommand(ChannelCommand::kCmdStop, handles[i] % NUM_CHANNELS, handles[i]);
+
+		if (mustSync) {
+			Common::StackLock lock(_mutex);
+			processCommands();
+		}
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
@@ -359,6 +675,28 @@ void MixerImpl::stopID(int id) {
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
+	if (_useCommandQueue) {
+		bool mustSync;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			ChannelShadow *shadow = findShadow(handle);
+			if (!shadow)
+				return;
+
+			shadow->active = false;
+			mustSync = !shadow->ownsStream;
+		}
+
+		postCommand(ChannelCommand::kCmdStop, handle._val % NUM_CHANNELS, handle._val);
+
+		if (mustSync) {
+			Common::StackLock lock(_mutex);
+			processCommands();
+		}
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
@@ -374,6 +712,11 @@ void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
+	if (_useCommandQueue) {
+		postCommand(ChannelCommand::kCmdGlobalVolume, 0, 0, type);
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
 			_channels[i]->notifyGlobalVolChange();
@@ -386,6 +729,20 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			ChannelShadow *shadow = findShadow(handle);
+			if (!shadow)
+				return;
+
+			shadow->volume = volume;
+		}
+
+		postCommand(ChannelCommand::kCmdSetVolume, handle._val % NUM_CHANNELS, handle._val, volume);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -396,6 +753,12 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		ChannelShadow *shadow = findShadow(handle);
+		return shadow ? shadow->volume : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -404,6 +767,20 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			ChannelShadow *shadow = findShadow(handle);
+			if (!shadow)
+				return;
+
+			shadow->balance = balance;
+		}
+
+		postCommand(ChannelCommand::kCmdSetBalance, handle._val % NUM_CHANNELS, handle._val, balance);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -414,6 +791,12 @@ void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		ChannelShadow *shadow = findShadow(handle);
+		return shadow ? shadow->balance : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -422,6 +805,20 @@ int8 MixerImpl::getChannelBalance(SoundHandle handle) {
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			ChannelShadow *shadow = findShadow(handle);
+			if (!shadow)
+				return;
+
+			shadow->rate = rate;
+		}
+
+		postCommand(ChannelCommand::kCmdSetRate, handle._val % NUM_CHANNELS, handle._val, rate);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -432,6 +829,12 @@ void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		ChannelShadow *shadow = findShadow(handle);
+		return shadow ? shadow->rate : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -440,6 +843,20 @@ uint32 MixerImpl::getChannelRate(SoundHandle handle) {
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			ChannelShadow *shadow = findShadow(handle);
+			if (!shadow)
+				return;
+
+			shadow->rate = shadow->nativeRate;
+		}
+
+		postCommand(ChannelCommand::kCmdResetRate, handle._val % NUM_CHANNELS, handle._val);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -454,8 +871,13 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
+	// The elapsed time is tracked by the channel itself, so this has to
+	// wait for the mixer even in command queue mode.
 	Common::StackLock lock(_mutex);
 
+	if (_useCommandQueue)
+		processCommands();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return Timestamp(0, _sampleRate);
@@ -464,6 +886,17 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			if (!findShadow(handle))
+				return;
+		}
+
+		postCommand(ChannelCommand::kCmdLoop, handle._val % NUM_CHANNELS, handle._val);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -474,6 +907,23 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 }
 
 void MixerImpl::pauseAll(bool paused) {
+	if (_useCommandQueue) {
+		uint32 handles[NUM_CHANNELS];
+		int count = 0;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_shadow[i].active)
+					handles[count++] = _shadow[i].handle;
+			}
+		}
+
+		for (int i = 0; i < count; i++)
+			postCommand(ChannelCommand::kCmdPause, handles[i] % NUM_CHANNELS, handles[i], paused);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr) {
@@ -483,6 +933,26 @@ void MixerImpl::pauseAll(bool paused) {
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
+	if (_useCommandQueue) {
+		uint32 handle = 0;
+		bool found = false;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_shadow[i].active && _shadow[i].id == id) {
+					handle = _shadow[i].handle;
+					found = true;
+					break;
+				}
+			}
+		}
+
+		if (found)
+			postCommand(ChannelCommand::kCmdPause, handle % NUM_CHANNELS, handle, paused);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
@@ -493,6 +963,17 @@ void MixerImpl::pauseID(int id, bool paused) {
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
+	if (_useCommandQueue) {
+		{
+			Common::StackLock lock(_queueMutex);
+			if (!findShadow(handle))
+				return;
+		}
+
+		postCommand(ChannelCommand::kCmdPause, handle._val % NUM_CHANNELS, handle._val, paused);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
@@ -504,12 +985,20 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_shadow[i].active && _shadow[i].id == id)
+				return true;
+		return false;
+	}
+
+	Common::StackLock lock(_mutex);
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -517,6 +1006,12 @@ bool MixerImpl::isSoundIDActive(int id) {
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		ChannelShadow *shadow = findShadow(handle);
+		return shadow ? shadow->id : 0;
+	}
+
 	Common::StackLock lock(_mutex);
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
@@ -525,17 +1020,30 @@ int MixerImpl::getSoundID(SoundHandle handle) {
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		return findShadow(handle) != nullptr;
+	}
+
+	Common::StackLock lock(_mutex);
+
 	const int index = handle._val % NUM_CHANNELS;
 	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
+	if (_useCommandQueue) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_shadow[i].active && _shadow[i].type == type)
+				return true;
+		return false;
+	}
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
@@ -552,6 +1060,12 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
+	if (_useCommandQueue) {
+		_soundTypeSettings[type].volume = volume;
+		postCommand(ChannelCommand::kCmdGlobalVolume, 0, 0, type);
+		return;
+	}
+
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
@@ -567,6 +1081,14 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	return _soundTypeSettings[type].volume;
 }
 
+void MixerImpl::setResamplerQuality(ResamplerQuality quality) {
+	_resamplerQuality = quality;
+}
+
+ResamplerQuality MixerImpl::getResamplerQuality() const {
+	return _resamplerQuality;
+}
+
 
 #pragma mark -
 #pragma mark --- Channel implementations ---
@@ -582,7 +1104,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), mixer->getOutputStereo(), reverseStereo, mixer->getResamplerQuality());
 }
 
 Channel::~Channel() {
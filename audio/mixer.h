@@ -26,6 +26,8 @@
 #include "common/types.h"
 #include "common/noncopyable.h"
 
+#include "audio/rate.h"
+
 namespace Audio {
 
 class AudioStream;
@@ -321,6 +323,20 @@ public:
 	 */
 	virtual int getVolumeForSoundType(SoundType type) const = 0;
 
+	/**
+	 * Set the resampling algorithm for sounds started from now on.
+	 *
+	 * @param quality  The resampling algorithm.
+	 */
+	virtual void setResamplerQuality(ResamplerQuality quality) = 0;
+
+	/**
+	 * Check which resampling algorithm is used for new sounds.
+	 *
+	 * @return The resampling algorithm.
+	 */
+	virtual ResamplerQuality getResamplerQuality() const = 0;
+
 	/**
 	 * Return the output sample rate of the system.
 	 *
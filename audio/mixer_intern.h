@@ -49,6 +49,12 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Optionally, the mixer can run in command queue mode (see
+ * setCommandQueueEnabled()). In that mode, engine-side calls which modify
+ * channels do not contend for the mixer mutex. Instead, they post channel
+ * commands to a small ring buffer, which the audio thread drains at the
+ * start of each mixCallback(), so the mix never waits for the engine thread.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -58,7 +64,8 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		COMMAND_QUEUE_SIZE = 256
 	};
 
 	Common::Mutex _mutex;
@@ -68,6 +75,7 @@ private:
 	const uint _outBufSize;
 	bool _mixerReady;
 	uint32 _handleSeed;
+	ResamplerQuality _resamplerQuality;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
@@ -79,6 +87,63 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * A command posted by the engine side in command queue mode. Commands
+	 * are applied in order by the audio thread, and only affect the channel
+	 * in slot @c index if its handle still matches @c handle.
+	 */
+	struct ChannelCommand {
+		enum Type {
+			kCmdPlay,
+			kCmdStop,
+			kCmdPause,
+			kCmdSetVolume,
+			kCmdSetBalance,
+			kCmdSetRate,
+			kCmdResetRate,
+			kCmdLoop,
+			kCmdGlobalVolume
+		};
+
+		Type type;
+		int index;
+		uint32 handle;
+		int value;
+		Channel *chan;
+	};
+
+	/**
+	 * Engine-side view of a channel slot in command queue mode. It reflects
+	 * all posted commands, so that queries made right after a command was
+	 * posted are answered consistently without touching the channels.
+	 */
+	struct ChannelShadow {
+		ChannelShadow() : active(false), handle(0), id(-1), type(kPlainSoundType), permanent(false),
+			ownsStream(false), volume(kMaxChannelVolume), balance(0), rate(0), nativeRate(0) {}
+
+		bool active;
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		bool ownsStream;
+		byte volume;
+		int8 balance;
+		uint32 rate;
+		uint32 nativeRate;
+	};
+
+	/** Protects the command ring and the shadow state. Never held for long. */
+	Common::Mutex _queueMutex;
+	bool _useCommandQueue;
+	ChannelCommand _commands[COMMAND_QUEUE_SIZE];
+	uint _commandRead;
+	uint _commandWrite;
+	ChannelShadow _shadow[NUM_CHANNELS];
+
+	/** Commands taken off the ring by the audio thread, owned by it. */
+	ChannelCommand _pendingCommands[COMMAND_QUEUE_SIZE];
+
 
 public:
 
@@ -132,6 +197,9 @@ public:
 	virtual void setVolumeForSoundType(SoundType type, int volume);
 	virtual int getVolumeForSoundType(SoundType type) const;
 
+	virtual void setResamplerQuality(ResamplerQuality quality);
+	virtual ResamplerQuality getResamplerQuality() const;
+
 	virtual uint getOutputRate() const;
 	virtual bool getOutputStereo() const;
 	virtual uint getOutputBufSize() const;
@@ -139,6 +207,41 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/**
+	 * Command queue mode counterpart of playStream(). Allocates the handle
+	 * from the shadow state and posts the new channel to the audio thread.
+	 */
+	void postPlayStream(
+		SoundType type,
+		SoundHandle *handle,
+		AudioStream *input,
+		int id, byte volume, int8 balance,
+		DisposeAfterUse::Flag autofreeStream,
+		bool permanent,
+		bool reverseStereo);
+
+	/**
+	 * Post a command to the command queue. If the queue is full, the pending
+	 * commands are applied synchronously first. Must not be called with
+	 * _queueMutex held.
+	 */
+	void postCommand(ChannelCommand::Type type, int index, uint32 handle, int value = 0, Channel *chan = nullptr);
+
+	/**
+	 * Apply all queued commands to the channels. Must be called with _mutex held.
+	 */
+	void processCommands();
+
+	void applyCommand(const ChannelCommand &cmd);
+
+	/**
+	 * Look up the shadow slot of a handle in command queue mode.
+	 * Must be called with _queueMutex held.
+	 *
+	 * @return the shadow slot, or nullptr if the handle is not active
+	 */
+	ChannelShadow *findShadow(SoundHandle handle);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -157,6 +260,16 @@ public:
 	 * their audio system has been completed.
 	 */
 	void setReady(bool ready);
+
+	/**
+	 * Switch command queue mode on or off. Backends may enable it if their
+	 * audio callback runs on a separate, high priority thread.
+	 *
+	 * In this mode, stopping a channel whose stream is not disposed by the
+	 * mixer still waits for the mixer, as the caller may free the stream
+	 * right after the call returns.
+	 */
+	void setCommandQueueEnabled(bool enable);
 };
 
 /** @} */
@@ -29,25 +29,95 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/config-manager.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
 
-/**
- * The default fractional type in frac.h (with 16 fractional bits) limits
- * the rate conversion code to 65536Hz audio: we need to able to handle
- * 96kHz audio, so we use fewer fractional bits in this code.
- */
-enum {
-	FRAC_BITS_LOW = 15,
-	FRAC_ONE_LOW = (1L << FRAC_BITS_LOW),
-	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
-};
+#pragma mark -
+#pragma mark --- Kernels ---
+#pragma mark -
+
+RateKernels::MixFunc RateKernels::mixFunc = nullptr;
+RateKernels::InterpolateFunc RateKernels::interpolateFunc = nullptr;
+RateKernels::FilterFunc RateKernels::filterFunc = nullptr;
+
+void RateKernels::selectKernels() {
+	mixFunc = mixGeneric;
+	interpolateFunc = interpolateGeneric;
+	filterFunc = filterGeneric;
+
+	// The SIMD kernels rely on saturating signed arithmetic
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		mixFunc = mixSSE2;
+		interpolateFunc = interpolateSSE2;
+		filterFunc = filterSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		mixFunc = mixAVX2;
+		interpolateFunc = interpolateAVX2;
+		filterFunc = filterAVX2;
+	}
+#endif
+#endif
+}
+
+void RateKernels::mixGeneric(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR) {
+	for (uint i = 0; i < frames; i++) {
+		st_sample_t outL, outR;
+		outL = (in[0] * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (in[1] * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+		in += 2;
+
+		if (outStereo) {
+			clampedAdd(out[0], outL);
+			clampedAdd(out[1], outR);
+			out += 2;
+		} else {
+			clampedAdd(out[0], (outL + outR) / 2);
+			out += 1;
+		}
+	}
+}
+
+void RateKernels::interpolateGeneric(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames) {
+	for (uint i = 0; i < frames; i++) {
+		const int frac = coefs[0];
+		out[0] = (st_sample_t)(pairs[1] + (((pairs[0] - pairs[1]) * frac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+		out[1] = (st_sample_t)(pairs[3] + (((pairs[2] - pairs[3]) * frac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+		out += 2;
+		pairs += 4;
+		coefs += 2;
+	}
+}
+
+st_sample_t RateKernels::filterGeneric(const st_sample_t *history, const int16 *filter) {
+	int sum = 0;
+	for (int i = 0; i < POLYPHASE_TAPS; i++)
+		sum += history[i] * filter[i];
+
+	return (st_sample_t)CLIP<int>((sum + FRAC_HALF_LOW) >> FRAC_BITS_LOW, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+#pragma mark -
+#pragma mark --- Rate converter ---
+#pragma mark -
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
 private:
+	enum {
+		/** Number of frames gathered before they are handed to the kernels */
+		BLOCK_FRAMES = 256
+	};
+
 	/** Input and output rates */
 	st_rate_t _inRate, _outRate;
 
@@ -76,10 +146,35 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	st_sample_t _inCurL, _inCurR;
 
+	/** Block of resampled stereo frames, in output channel order */
+	st_sample_t _block[2 * BLOCK_FRAMES];
+
+	/** Interpolation input for each frame of the block, see RateKernels::InterpolateFunc */
+	st_sample_t _pairs[4 * BLOCK_FRAMES];
+	int16 _coefs[2 * BLOCK_FRAMES];
+
 	int copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int simpleConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 	int interpolateConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r);
 
+	/** Store a frame into a block, swapping the channels for reversed stereo */
+	static void storeFrame(st_sample_t *frame, st_sample_t inL, st_sample_t inR) {
+		frame[reverseStereo    ] = inL;
+		frame[reverseStereo ^ 1] = inR;
+	}
+
+	void mixBlock(st_sample_t *outBuffer, const st_sample_t *block, uint frames, st_volume_t volL, st_volume_t volR) {
+		if (reverseStereo)
+			RateKernels::mix(outBuffer, block, frames, outStereo, volR, volL);
+		else
+			RateKernels::mix(outBuffer, block, frames, outStereo, volL, volR);
+	}
+
+	void mixInterpolated(st_sample_t *outBuffer, uint frames, st_volume_t volL, st_volume_t volR) {
+		RateKernels::interpolate(_block, _pairs, _coefs, frames);
+		mixBlock(outBuffer, _block, frames, volL, volR);
+	}
+
 public:
 	RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
 	virtual ~RateConverter_Impl() {}
@@ -97,48 +192,46 @@ public:
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 int RateConverter_Impl<inStereo, outStereo, reverseStereo>::copyConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
-	st_sample_t *outStart, *outEnd;
-
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	const int inChannels = inStereo ? 2 : 1;
+	st_size_t done = 0;
 
-	while (outBuffer < outEnd) {
+	while (done < numSamples) {
 		// Check if we have to refill the buffer
 		if (_bufferSize == 0) {
 			_bufferPos = _buffer;
 			_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
 			if (_bufferSize <= 0)
-				return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				break;
 		}
 
-		// Mix the data into the output buffer
-		st_sample_t inL, inR;
-		inL = *_bufferPos++;
-		inR = (inStereo ? *_bufferPos++ : inL);
-		_bufferSize -= (inStereo ? 2 : 1);
-
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// Output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
+		uint frames = MIN<uint>(numSamples - done, _bufferSize / inChannels);
+		if (frames == 0) {
+			// Drop an incomplete trailing frame
+			_bufferSize = 0;
+			continue;
+		}
 
-			// Output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+		// Plain stereo input can be mixed straight from the input cache
+		const st_sample_t *block = _bufferPos;
+		if (!inStereo || reverseStereo) {
+			frames = MIN<uint>(frames, BLOCK_FRAMES);
+			for (uint i = 0; i < frames; i++) {
+				const st_sample_t inL = _bufferPos[i * inChannels];
+				const st_sample_t inR = _bufferPos[i * inChannels + inChannels - 1];
+				storeFrame(&_block[2 * i], inL, inR);
+			}
+			block = _block;
+		}
 
-			outBuffer += 2;
-		} else {
-			// Output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
+		mixBlock(outBuffer + done * (outStereo ? 2 : 1), block, frames, volL, volR);
 
-			outBuffer += 1;
-		}
+		_bufferPos += frames * inChannels;
+		_bufferSize -= frames * inChannels;
+		done += frames;
 	}
 
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+	return done;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -146,12 +239,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 	// How much to increment _outPos by
 	frac_t outPos_inc = _inRate / _outRate;
 
-	st_sample_t *outStart, *outEnd;
+	st_size_t done = 0;
+	uint frames = 0;
 
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
-
-	while (outBuffer < outEnd) {
+	while (done + frames < numSamples) {
 		// Read enough input samples so that _outPos >= 0
 		do {
 			// Check if we have to refill the buffer
@@ -159,8 +250,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 				_bufferPos = _buffer;
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				if (_bufferSize <= 0) {
+					mixBlock(outBuffer + done * (outStereo ? 2 : 1), _block, frames, volL, volR);
+					return done + frames;
+				}
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -178,26 +271,16 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::simpleConvert(AudioS
 		// Increment output position
 		_outPos += outPos_inc;
 
-		st_sample_t outL, outR;
-		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-		if (outStereo) {
-			// output left channel
-			clampedAdd(outBuffer[reverseStereo    ], outL);
-
-			// output right channel
-			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-			outBuffer += 2;
-		} else {
-			// output mono channel
-			clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-			outBuffer += 1;
+		storeFrame(&_block[2 * frames], inL, inR);
+		if (++frames == BLOCK_FRAMES) {
+			mixBlock(outBuffer + done * (outStereo ? 2 : 1), _block, frames, volL, volR);
+			done += frames;
+			frames = 0;
 		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+
+	mixBlock(outBuffer + done * (outStereo ? 2 : 1), _block, frames, volL, volR);
+	return done + frames;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -205,11 +288,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 	// How much to increment _outPosFrac by
 	frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
 
-	st_sample_t *outStart, *outEnd;
-	outStart = outBuffer;
-	outEnd = outBuffer + numSamples * (outStereo ? 2 : 1);
+	st_size_t done = 0;
+	uint frames = 0;
 
-	while (outBuffer < outEnd) {
+	while (done + frames < numSamples) {
 		// Read enough input samples so that _outPosFrac < 0
 		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
 			// Check if we have to refill the buffer
@@ -217,8 +299,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 				_bufferPos = _buffer;
 				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
 
-				if (_bufferSize <= 0)
-					return (outBuffer - outStart) / (outStereo ? 2 : 1);
+				if (_bufferSize <= 0) {
+					mixInterpolated(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+					return done + frames;
+				}
 			}
 
 			_bufferSize -= (inStereo ? 2 : 1);
@@ -235,38 +319,30 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 
 		// Loop as long as the _outPos trails behind, and as long as there is
 		// still space in the output buffer.
-		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
-			// Interpolate
-			st_sample_t inL, inR;
-			inL = (st_sample_t)(_inLastL + (((_inCurL - _inLastL) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			inR = (inStereo ?
-						(st_sample_t)(_inLastR + (((_inCurR - _inLastR) * _outPosFrac + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						inL);
-
-			st_sample_t outL, outR;
-			outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
-			outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
-
-			if (outStereo) {
-				// Output left channel
-				clampedAdd(outBuffer[reverseStereo    ], outL);
-
-				// Output right channel
-				clampedAdd(outBuffer[reverseStereo ^ 1], outR);
-
-				outBuffer += 2;
-			} else {
-				// Output mono channel
-				clampedAdd(outBuffer[0], (outL + outR) / 2);
-
-				outBuffer += 1;
-			}
+		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && done + frames < numSamples) {
+			// Queue the frame for interpolation
+			st_sample_t *pairL = &_pairs[4 * frames + 2 * reverseStereo];
+			st_sample_t *pairR = &_pairs[4 * frames + 2 * (reverseStereo ^ 1)];
+			pairL[0] = _inCurL;
+			pairL[1] = _inLastL;
+			pairR[0] = (inStereo ? _inCurR : _inCurL);
+			pairR[1] = (inStereo ? _inLastR : _inLastL);
+			_coefs[2 * frames] = (int16)_outPosFrac;
+			_coefs[2 * frames + 1] = (int16)-_outPosFrac;
 
 			// Increment output position
 			_outPosFrac += outPos_inc;
+
+			if (++frames == BLOCK_FRAMES) {
+				mixInterpolated(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+				done += frames;
+				frames = 0;
+			}
 		}
 	}
-	return (outBuffer - outStart) / (outStereo ? 2 : 1);
+
+	mixInterpolated(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+	return done + frames;
 }
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
@@ -297,7 +373,10 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream
 	}
 }
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, ResamplerQuality quality) {
+	if (quality == kResamplerPolyphase)
+		return makePolyphaseRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
 	if (inStereo) {
 		if (outStereo) {
 			if (reverseStereo)
@@ -314,4 +393,11 @@ RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inSte
 	}
 }
 
+ResamplerQuality getResamplerQualityFromConfig() {
+	if (ConfMan.hasKey("audio_resampler") && ConfMan.get("audio_resampler") == "polyphase")
+		return kResamplerPolyphase;
+
+	return kResamplerLinear;
+}
+
 } // End of namespace Audio
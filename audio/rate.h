@@ -104,7 +104,26 @@ public:
 	virtual bool needsDraining() const = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+/**
+ * Resampling algorithms offered by makeRateConverter().
+ */
+enum ResamplerQuality {
+	kResamplerLinear,    /*!< Nearest sample or linear interpolation. Cheapest, but aliases audibly. */
+	kResamplerPolyphase  /*!< Band-limited windowed-sinc polyphase filter. */
+};
+
+/**
+ * Create a rate converter for the given rates and channel layouts.
+ *
+ * @param quality Resampling algorithm to use whenever the rates differ.
+ */
+RateConverter *makeRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo, ResamplerQuality quality = kResamplerLinear);
+
+/**
+ * Get the resampling algorithm selected by the "audio_resampler" config key,
+ * which may be set to "linear" (the default) or "polyphase".
+ */
+ResamplerQuality getResamplerQualityFromConfig();
 
 /** @} */
 } // End of namespace Audio
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// See rate_sse2.cpp for a description of the helpers below. Packing and
+// unpacking work within 128-bit lanes, which keeps the order of the samples
+// intact for scaling, but not for downmixing and interpolation.
+
+static FORCEINLINE __m256i scaleAVX2(__m256i in, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(in, vol);
+	const __m256i hi = _mm256_mulhi_epi16(in, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), _mm256_set1_epi32(255))), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), _mm256_set1_epi32(255))), 8);
+	return _mm256_packs_epi32(p0, p1);
+}
+
+static FORCEINLINE __m256i downmixAVX2(__m256i in) {
+	const __m256i sum = _mm256_madd_epi16(in, _mm256_set1_epi16(1));
+	return _mm256_srai_epi32(_mm256_sub_epi32(sum, _mm256_srai_epi32(sum, 31)), 1);
+}
+
+static FORCEINLINE __m256i interpolatePairsAVX2(__m256i pairs, __m256i coefs) {
+	const __m256i delta = _mm256_madd_epi16(pairs, coefs);
+	const __m256i last = _mm256_slli_epi32(_mm256_srai_epi32(pairs, 16), FRAC_BITS_LOW);
+	return _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(last, delta), _mm256_set1_epi32(FRAC_HALF_LOW)), FRAC_BITS_LOW);
+}
+
+void RateKernels::mixAVX2(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+	uint i = 0;
+
+	if (outStereo) {
+		for (; i + 8 <= frames; i += 8) {
+			const __m256i s = scaleAVX2(_mm256_loadu_si256((const __m256i *)(in + 2 * i)), vol);
+			const __m256i d = _mm256_loadu_si256((const __m256i *)(out + 2 * i));
+			_mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_adds_epi16(d, s));
+		}
+	} else {
+		for (; i + 16 <= frames; i += 16) {
+			const __m256i s0 = downmixAVX2(scaleAVX2(_mm256_loadu_si256((const __m256i *)(in + 2 * i)), vol));
+			const __m256i s1 = downmixAVX2(scaleAVX2(_mm256_loadu_si256((const __m256i *)(in + 2 * i + 16)), vol));
+			const __m256i m = _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), _MM_SHUFFLE(3, 1, 2, 0));
+			const __m256i d = _mm256_loadu_si256((const __m256i *)(out + i));
+			_mm256_storeu_si256((__m256i *)(out + i), _mm256_adds_epi16(d, m));
+		}
+	}
+
+	mixGeneric(out + i * (outStereo ? 2 : 1), in + 2 * i, frames - i, outStereo, volL, volR);
+}
+
+void RateKernels::interpolateAVX2(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames) {
+	const __m256i spread = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	uint i = 0;
+
+	for (; i + 8 <= frames; i += 8) {
+		const __m256i c0 = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(coefs + 2 * i))), spread);
+		const __m256i c1 = _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(coefs + 2 * i + 8))), spread);
+		const __m256i r0 = interpolatePairsAVX2(_mm256_loadu_si256((const __m256i *)(pairs + 4 * i)), c0);
+		const __m256i r1 = interpolatePairsAVX2(_mm256_loadu_si256((const __m256i *)(pairs + 4 * i + 16)), c1);
+		_mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	interpolateGeneric(out + 2 * i, pairs + 4 * i, coefs + 2 * i, frames - i);
+}
+
+st_sample_t RateKernels::filterAVX2(const st_sample_t *history, const int16 *filter) {
+	const __m256i prod = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)history), _mm256_loadu_si256((const __m256i *)filter));
+	__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(prod), _mm256_extracti128_si256(prod, 1));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return (st_sample_t)CLIP<int>((_mm_cvtsi128_si32(sum) + FRAC_HALF_LOW) >> FRAC_BITS_LOW, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+#include "common/array.h"
+#include "common/mutex.h"
+
+namespace Audio {
+
+/**
+ * The default fractional type in frac.h (with 16 fractional bits) limits
+ * the rate conversion code to 65536Hz audio: we need to able to handle
+ * 96kHz audio, so we use fewer fractional bits in this code.
+ */
+enum {
+	FRAC_BITS_LOW = 15,
+	FRAC_ONE_LOW = (1L << FRAC_BITS_LOW),
+	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
+};
+
+enum {
+	/** Number of taps of every polyphase sub-filter */
+	POLYPHASE_TAPS = 16
+};
+
+/**
+ * Sample processing kernels used by the rate converters.
+ *
+ * The converters first gather a block of frames from their input, then hand
+ * it over to these kernels for interpolation, volume scaling and clamped
+ * accumulation into the mixer buffer. Like Graphics::BlendBlit, the best
+ * implementation for the running CPU is selected on first use. All
+ * implementations produce bit-identical output.
+ */
+class RateKernels {
+public:
+	/**
+	 * Scale a block of stereo frames by the channel volumes and add them to
+	 * the output buffer, clamping the result.
+	 *
+	 * @param out       output buffer, stereo or mono
+	 * @param in        input frames, interleaved in output channel order
+	 * @param frames    number of frames to mix
+	 * @param outStereo whether the output buffer is stereo
+	 * @param volL      volume of the first channel of each input frame
+	 * @param volR      volume of the second channel of each input frame
+	 */
+	typedef void (*MixFunc)(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR);
+
+	/**
+	 * Linearly interpolate a block of stereo frames.
+	 *
+	 * @param out    output frames, interleaved stereo
+	 * @param pairs  (current, last) input sample pairs, four per frame
+	 * @param coefs  (frac, -frac) coefficient pair for each frame, with
+	 *               frac in FRAC_BITS_LOW fixed point and below FRAC_ONE_LOW
+	 * @param frames number of frames to interpolate
+	 */
+	typedef void (*InterpolateFunc)(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames);
+
+	/**
+	 * Apply a polyphase sub-filter to the input history of one channel.
+	 *
+	 * @param history POLYPHASE_TAPS input samples, oldest first
+	 * @param filter  POLYPHASE_TAPS coefficients in FRAC_BITS_LOW fixed point,
+	 *                whose absolute values add up to less than 2 * FRAC_ONE_LOW
+	 * @return the filtered sample, rounded and clamped
+	 */
+	typedef st_sample_t (*FilterFunc)(const st_sample_t *history, const int16 *filter);
+
+	static void mix(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR) {
+		if (!mixFunc)
+			selectKernels();
+		mixFunc(out, in, frames, outStereo, volL, volR);
+	}
+
+	static void interpolate(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames) {
+		if (!interpolateFunc)
+			selectKernels();
+		interpolateFunc(out, pairs, coefs, frames);
+	}
+
+	static st_sample_t filter(const st_sample_t *history, const int16 *filter) {
+		if (!filterFunc)
+			selectKernels();
+		return filterFunc(history, filter);
+	}
+
+	static void mixGeneric(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR);
+	static void interpolateGeneric(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames);
+	static st_sample_t filterGeneric(const st_sample_t *history, const int16 *filter);
+#ifdef SCUMMVM_SSE2
+	static void mixSSE2(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR);
+	static void interpolateSSE2(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames);
+	static st_sample_t filterSSE2(const st_sample_t *history, const int16 *filter);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void mixAVX2(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR);
+	static void interpolateAVX2(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames);
+	static st_sample_t filterAVX2(const st_sample_t *history, const int16 *filter);
+#endif
+
+	static MixFunc mixFunc;
+	static InterpolateFunc interpolateFunc;
+	static FilterFunc filterFunc;
+
+private:
+	static void selectKernels();
+};
+
+/**
+ * Tables of polyphase sub-filters, shared by all the polyphase converters
+ * using the same cutoff frequency.
+ *
+ * Every table is built once, on first use, and kept until the cache is
+ * destroyed. The converters thus never build filters on the audio thread
+ * when changing to a ratio already in use, and never free them.
+ */
+class PolyphaseFilterCache {
+public:
+	enum {
+		TAPS = POLYPHASE_TAPS,
+		/** Index of the tap at the integer part of the output position */
+		CENTER_TAP = TAPS / 2 - 1,
+		/** Number of phases between two input frames, as a power of two */
+		PHASE_BITS = 7,
+		PHASES = 1 << PHASE_BITS
+	};
+
+	/**
+	 * Create the cache shared by all the converters.
+	 *
+	 * This is done by the mixer, before the audio thread starts, and the
+	 * cache must outlive all the polyphase converters.
+	 */
+	static void createInstance();
+	static void destroyInstance();
+
+	/** Return the cache shared by all the converters. */
+	static PolyphaseFilterCache &instance();
+
+	/**
+	 * Return the sub-filters for converting between the given rates:
+	 * PHASES + 1 phases of TAPS coefficients, in FRAC_BITS_LOW fixed point.
+	 * The last phase sits on the next input frame.
+	 */
+	const int16 *getFilter(st_rate_t inRate, st_rate_t outRate);
+
+private:
+	struct Entry {
+		/** The output to input rate ratio, reduced, or 1/1 when upsampling */
+		st_rate_t num, den;
+		int16 *filter;
+	};
+
+	PolyphaseFilterCache() {}
+	~PolyphaseFilterCache();
+
+	static int16 *buildFilter(double cutoff);
+
+	Common::Mutex _mutex;
+	Common::Array<Entry> _entries;
+
+	static PolyphaseFilterCache *_instance;
+};
+
+/**
+ * Create a band-limited polyphase rate converter.
+ * @see makeRateConverter()
+ */
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo);
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,323 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "common/algorithm.h"
+#include "common/util.h"
+
+namespace Audio {
+
+PolyphaseFilterCache *PolyphaseFilterCache::_instance = nullptr;
+
+void PolyphaseFilterCache::createInstance() {
+	if (!_instance)
+		_instance = new PolyphaseFilterCache();
+}
+
+void PolyphaseFilterCache::destroyInstance() {
+	delete _instance;
+	_instance = nullptr;
+}
+
+PolyphaseFilterCache &PolyphaseFilterCache::instance() {
+	// Without a mixer, like in the unit tests, there is no audio thread
+	// which could race with this
+	if (!_instance)
+		createInstance();
+	return *_instance;
+}
+
+PolyphaseFilterCache::~PolyphaseFilterCache() {
+	for (uint i = 0; i < _entries.size(); i++)
+		delete[] _entries[i].filter;
+}
+
+const int16 *PolyphaseFilterCache::getFilter(st_rate_t inRate, st_rate_t outRate) {
+	// All the upsampling ratios share the same cutoff frequency
+	st_rate_t num = 1, den = 1;
+	if (outRate < inRate) {
+		const st_rate_t divisor = Common::gcd(inRate, outRate);
+		num = outRate / divisor;
+		den = inRate / divisor;
+	}
+
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _entries.size(); i++) {
+		if (_entries[i].num == num && _entries[i].den == den)
+			return _entries[i].filter;
+	}
+
+	// Remove the frequencies above the output Nyquist frequency when
+	// downsampling, and leave some room for the filter transition band.
+	Entry entry;
+	entry.num = num;
+	entry.den = den;
+	entry.filter = buildFilter(0.9 * num / den);
+	_entries.push_back(entry);
+	return entry.filter;
+}
+
+int16 *PolyphaseFilterCache::buildFilter(double cutoff) {
+	int16 *filters = new int16[(PHASES + 1) * TAPS];
+
+	for (int phase = 0; phase <= PHASES; phase++) {
+		const double frac = (double)phase / PHASES;
+		double coefs[TAPS];
+		double sum = 0.0;
+
+		for (int tap = 0; tap < TAPS; tap++) {
+			// Distance of the tap from the output position, in input frames
+			const double d = tap - CENTER_TAP - frac;
+			const double x = M_PI * cutoff * d;
+			const double sinc = (x == 0.0) ? 1.0 : sin(x) / x;
+
+			// Blackman window spanning all taps
+			const double w = 2.0 * M_PI * (d / (TAPS + 1) + 0.5);
+			const double window = 0.42 - 0.5 * cos(w) + 0.08 * cos(2.0 * w);
+
+			coefs[tap] = sinc * window;
+			sum += coefs[tap];
+		}
+
+		// Normalize every phase to unity gain, and put the rounding error on
+		// the largest tap, so that constant signals pass through unchanged.
+		int16 *filter = &filters[phase * TAPS];
+		int total = 0, largest = 0;
+		for (int tap = 0; tap < TAPS; tap++) {
+			filter[tap] = (int16)floor(coefs[tap] / sum * FRAC_ONE_LOW + 0.5);
+			total += filter[tap];
+			if (filter[tap] > filter[largest])
+				largest = tap;
+		}
+		filter[largest] += FRAC_ONE_LOW - total;
+	}
+
+	return filters;
+}
+
+/**
+ * Band-limited rate converter, using a windowed-sinc filter split into
+ * a table of polyphase sub-filters.
+ *
+ * For every output frame, the sub-filter closest to the fractional output
+ * position is applied to the last TAPS input frames. The cost per output
+ * frame is thus fixed, regardless of the conversion ratio. Compared to
+ * linear interpolation, this adds a latency of TAPS / 2 input frames,
+ * which are flushed with silence at the end of the stream.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+class PolyphaseRateConverter_Impl : public RateConverter {
+private:
+	enum {
+		TAPS = PolyphaseFilterCache::TAPS,
+		CENTER_TAP = PolyphaseFilterCache::CENTER_TAP,
+		PHASE_BITS = PolyphaseFilterCache::PHASE_BITS,
+		/** Number of input frames following the one at the output position */
+		LATENCY = TAPS - 1 - CENTER_TAP,
+		/** Number of frames gathered before they are mixed */
+		BLOCK_FRAMES = 256
+	};
+
+	/** Input and output rates */
+	st_rate_t _inRate, _outRate;
+
+	/** The intermediate input cache */
+	st_sample_t _buffer[512];
+
+	/** Current position inside the buffer */
+	const st_sample_t *_bufferPos;
+
+	/** Size of data currently loaded into the buffer */
+	int _bufferSize;
+
+	/** Fractional position of the output stream in input stream unit */
+	frac_t _outPosFrac;
+
+	/**
+	 * The last TAPS input frames of each channel. Every frame is stored
+	 * twice, so that the filter can always read TAPS contiguous samples.
+	 */
+	st_sample_t _historyL[2 * TAPS], _historyR[2 * TAPS];
+	uint _historyPos;
+
+	/** Number of silent frames to push once the input has ended */
+	uint _drainFrames;
+
+	/** The shared sub-filters for the current rates, or null when passing through */
+	const int16 *_filter;
+
+	/** Block of resampled stereo frames, in output channel order */
+	st_sample_t _block[2 * BLOCK_FRAMES];
+
+	void updateFilter() {
+		_filter = (_inRate == _outRate) ? nullptr : PolyphaseFilterCache::instance().getFilter(_inRate, _outRate);
+	}
+
+	void pushFrame(st_sample_t inL, st_sample_t inR);
+
+	void mixBlock(st_sample_t *outBuffer, uint frames, st_volume_t volL, st_volume_t volR) {
+		if (reverseStereo)
+			RateKernels::mix(outBuffer, _block, frames, outStereo, volR, volL);
+		else
+			RateKernels::mix(outBuffer, _block, frames, outStereo, volL, volR);
+	}
+
+public:
+	PolyphaseRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate);
+	virtual ~PolyphaseRateConverter_Impl() {}
+
+	int convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t vol_l, st_volume_t vol_r) override;
+
+	void setInputRate(st_rate_t inputRate) override { _inRate = inputRate; updateFilter(); }
+	void setOutputRate(st_rate_t outputRate) override { _outRate = outputRate; updateFilter(); }
+
+	st_rate_t getInputRate() const override { return _inRate; }
+	st_rate_t getOutputRate() const override { return _outRate; }
+
+	bool needsDraining() const override { return _bufferSize != 0 || _drainFrames != 0; }
+};
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::PolyphaseRateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
+	_inRate(inputRate),
+	_outRate(outputRate),
+	_bufferPos(nullptr),
+	_bufferSize(0),
+	_outPosFrac(FRAC_ONE_LOW),
+	_historyPos(0),
+	_drainFrames(0) {
+	memset(_historyL, 0, sizeof(_historyL));
+	memset(_historyR, 0, sizeof(_historyR));
+	updateFilter();
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+void PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::pushFrame(st_sample_t inL, st_sample_t inR) {
+	_historyL[_historyPos] = _historyL[_historyPos + TAPS] = inL;
+	if (inStereo)
+		_historyR[_historyPos] = _historyR[_historyPos + TAPS] = inR;
+
+	if (++_historyPos == TAPS)
+		_historyPos = 0;
+}
+
+template<bool inStereo, bool outStereo, bool reverseStereo>
+int PolyphaseRateConverter_Impl<inStereo, outStereo, reverseStereo>::convert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL, st_volume_t volR) {
+	assert(input.isStereo() == inStereo);
+
+	// How much to increment _outPosFrac by
+	const frac_t outPos_inc = (_inRate << FRAC_BITS_LOW) / _outRate;
+
+	// Half the distance between two phases, to pick the closest one
+	const frac_t phaseRound = 1 << (FRAC_BITS_LOW - PHASE_BITS - 1);
+
+	st_size_t done = 0;
+	uint frames = 0;
+
+	while (done + frames < numSamples) {
+		// Read input frames until the output position lies within the
+		// center of the filter.
+		while ((frac_t)FRAC_ONE_LOW <= _outPosFrac) {
+			// Check if we have to refill the buffer
+			if (_bufferSize == 0) {
+				_bufferPos = _buffer;
+				_bufferSize = input.readBuffer(_buffer, ARRAYSIZE(_buffer));
+
+				if (_bufferSize > 0) {
+					_drainFrames = LATENCY;
+				} else {
+					_bufferSize = 0;
+
+					// Flush the last input frames out of the filter once
+					// the stream has really ended
+					if (!_drainFrames || !input.endOfStream()) {
+						mixBlock(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+						return done + frames;
+					}
+
+					_drainFrames--;
+					pushFrame(0, 0);
+					_outPosFrac -= FRAC_ONE_LOW;
+					continue;
+				}
+			}
+
+			_bufferSize -= (inStereo ? 2 : 1);
+			const st_sample_t inL = *_bufferPos++;
+			const st_sample_t inR = (inStereo ? *_bufferPos++ : inL);
+			pushFrame(inL, inR);
+
+			_outPosFrac -= FRAC_ONE_LOW;
+		}
+
+		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && done + frames < numSamples) {
+			const st_sample_t *historyL = &_historyL[_historyPos];
+			const st_sample_t *historyR = &_historyR[_historyPos];
+			st_sample_t outL, outR;
+
+			if (!_filter) {
+				outL = historyL[CENTER_TAP];
+				outR = (inStereo ? historyR[CENTER_TAP] : outL);
+			} else {
+				const int16 *filter = &_filter[((_outPosFrac + phaseRound) >> (FRAC_BITS_LOW - PHASE_BITS)) * TAPS];
+				outL = RateKernels::filter(historyL, filter);
+				outR = (inStereo ? RateKernels::filter(historyR, filter) : outL);
+			}
+
+			_block[2 * frames + reverseStereo    ] = outL;
+			_block[2 * frames + (reverseStereo ^ 1)] = outR;
+
+			// Increment output position
+			_outPosFrac += outPos_inc;
+
+			if (++frames == BLOCK_FRAMES) {
+				mixBlock(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+				done += frames;
+				frames = 0;
+			}
+		}
+	}
+
+	mixBlock(outBuffer + done * (outStereo ? 2 : 1), frames, volL, volR);
+	return done + frames;
+}
+
+RateConverter *makePolyphaseRateConverter(st_rate_t inRate, st_rate_t outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+	if (inStereo) {
+		if (outStereo) {
+			if (reverseStereo)
+				return new PolyphaseRateConverter_Impl<true, true, true>(inRate, outRate);
+			else
+				return new PolyphaseRateConverter_Impl<true, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter_Impl<true, false, false>(inRate, outRate);
+	} else {
+		if (outStereo) {
+			return new PolyphaseRateConverter_Impl<false, true, false>(inRate, outRate);
+		} else
+			return new PolyphaseRateConverter_Impl<false, false, false>(inRate, outRate);
+	}
+}
+
+} // End of namespace Audio
@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Audio {
+
+// Multiply eight samples by their volume and divide by kMaxMixerVolume,
+// rounding towards zero like the generic code does.
+static FORCEINLINE __m128i scaleSSE2(__m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), _mm_set1_epi32(255))), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), _mm_set1_epi32(255))), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+// Average the two channels of four scaled frames, rounding towards zero.
+static FORCEINLINE __m128i downmixSSE2(__m128i in) {
+	const __m128i sum = _mm_madd_epi16(in, _mm_set1_epi16(1));
+	return _mm_srai_epi32(_mm_sub_epi32(sum, _mm_srai_epi32(sum, 31)), 1);
+}
+
+// Interpolate two frames of (current, last) pairs. The coefficients hold
+// (frac, -frac), so the multiply-add yields (current - last) * frac.
+static FORCEINLINE __m128i interpolatePairsSSE2(__m128i pairs, __m128i coefs) {
+	const __m128i delta = _mm_madd_epi16(pairs, coefs);
+	const __m128i last = _mm_slli_epi32(_mm_srai_epi32(pairs, 16), FRAC_BITS_LOW);
+	return _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(last, delta), _mm_set1_epi32(FRAC_HALF_LOW)), FRAC_BITS_LOW);
+}
+
+void RateKernels::mixSSE2(st_sample_t *out, const st_sample_t *in, uint frames, bool outStereo, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = _mm_set_epi16(volR, volL, volR, volL, volR, volL, volR, volL);
+	uint i = 0;
+
+	if (outStereo) {
+		for (; i + 4 <= frames; i += 4) {
+			const __m128i s = scaleSSE2(_mm_loadu_si128((const __m128i *)(in + 2 * i)), vol);
+			const __m128i d = _mm_loadu_si128((const __m128i *)(out + 2 * i));
+			_mm_storeu_si128((__m128i *)(out + 2 * i), _mm_adds_epi16(d, s));
+		}
+	} else {
+		for (; i + 8 <= frames; i += 8) {
+			const __m128i s0 = downmixSSE2(scaleSSE2(_mm_loadu_si128((const __m128i *)(in + 2 * i)), vol));
+			const __m128i s1 = downmixSSE2(scaleSSE2(_mm_loadu_si128((const __m128i *)(in + 2 * i + 8)), vol));
+			const __m128i d = _mm_loadu_si128((const __m128i *)(out + i));
+			_mm_storeu_si128((__m128i *)(out + i), _mm_adds_epi16(d, _mm_packs_epi32(s0, s1)));
+		}
+	}
+
+	mixGeneric(out + i * (outStereo ? 2 : 1), in + 2 * i, frames - i, outStereo, volL, volR);
+}
+
+void RateKernels::interpolateSSE2(st_sample_t *out, const st_sample_t *pairs, const int16 *coefs, uint frames) {
+	uint i = 0;
+
+	for (; i + 4 <= frames; i += 4) {
+		const __m128i c = _mm_loadu_si128((const __m128i *)(coefs + 2 * i));
+		const __m128i r0 = interpolatePairsSSE2(_mm_loadu_si128((const __m128i *)(pairs + 4 * i)), _mm_unpacklo_epi32(c, c));
+		const __m128i r1 = interpolatePairsSSE2(_mm_loadu_si128((const __m128i *)(pairs + 4 * i + 8)), _mm_unpackhi_epi32(c, c));
+		_mm_storeu_si128((__m128i *)(out + 2 * i), _mm_packs_epi32(r0, r1));
+	}
+
+	interpolateGeneric(out + 2 * i, pairs + 4 * i, coefs + 2 * i, frames - i);
+}
+
+st_sample_t RateKernels::filterSSE2(const st_sample_t *history, const int16 *filter) {
+	const __m128i lo = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)history), _mm_loadu_si128((const __m128i *)filter));
+	const __m128i hi = _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(history + 8)), _mm_loadu_si128((const __m128i *)(filter + 8)));
+	__m128i sum = _mm_add_epi32(lo, hi);
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return (st_sample_t)CLIP<int>((_mm_cvtsi128_si32(sum) + FRAC_HALF_LOW) >> FRAC_BITS_LOW, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+} // End of namespace Audio
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
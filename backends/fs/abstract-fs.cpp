@@ -39,3 +39,7 @@ const char *AbstractFSNode::lastPathComponent(const Common::String &str, const c
 Common::SeekableReadStream *AbstractFSNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 	return nullptr;
 }
+
+Common::MappedReadStream *AbstractFSNode::createMappedReadStream() {
+	return nullptr;
+}
@@ -182,6 +182,16 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a MappedReadStream instance giving direct access to the whole
+	 * contents of the file referred by this node, mapped into memory. Backends
+	 * which are able to map files should override it; the default
+	 * implementation fails.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::MappedReadStream *createMappedReadStream();
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to an alternate
 	 * stream of the file referred by this node. This assumes that the node
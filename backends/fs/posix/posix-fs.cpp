@@ -34,6 +34,7 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
 #include "common/algorithm.h"
+#include "common/memstream.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -55,6 +56,27 @@
 #include <os2.h>
 #endif
 
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#include <sys/mman.h>
+
+/**
+ * A read-only mapping of a whole file, unmapped when the stream is deleted.
+ */
+class PosixMappedReadStream final : public Common::MappedReadStream {
+private:
+	void *_mapping;
+	size_t _length;
+
+public:
+	PosixMappedReadStream(void *mapping, uint32 length) :
+		Common::MappedReadStream((const byte *)mapping, length), _mapping(mapping), _length(length) {}
+
+	~PosixMappedReadStream() override {
+		munmap(_mapping, _length);
+	}
+};
+#endif
+
 bool POSIXFilesystemNode::exists() const {
 	return access(_path.c_str(), F_OK) == 0;
 }
@@ -269,6 +291,30 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+Common::MappedReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+	int fd = open(_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (uint64)st.st_size > 0xFFFFFFFF) {
+		close(fd);
+		return nullptr;
+	}
+
+	// Empty files cannot be mapped
+	void *mapping = st.st_size ? mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+	// The mapping stays valid once the descriptor is closed
+	close(fd);
+
+	if (mapping != MAP_FAILED)
+		return new PosixMappedReadStream(mapping, st.st_size);
+#endif
+
+	return nullptr;
+}
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 #ifdef MACOSX
 	if (altStreamType == Common::AltStreamType::MacResourceFork) {
@@ -25,8 +25,10 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/translation.h"
 #include "common/util.h"
 #include "common/file.h"
@@ -137,6 +139,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_dirtyTiles(nullptr), _dirtyTileUpdates(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0) {
 
@@ -172,6 +175,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	_scaler = nullptr;
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
+	_scalerBands = 1;
 
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
 	_videoMode.filtering = ConfMan.getBool("filtering");
@@ -186,6 +190,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
+	delete _dirtyTiles;
 	delete _scaler;
 	delete _mouseScaler;
 	if (_mouseOrigSurface) {
@@ -693,6 +698,11 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	_scaler->setFactor(_videoMode.scaleFactor);
 	_extraPixels = _scalerPlugin->extraPixels();
 	_useOldSrc = _scalerPlugin->useOldSource();
+	// Thread safe scalers split large areas between the worker threads,
+	// the thread waiting for them takes one band itself.
+	_scalerBands = 1;
+	if (_scalerPlugin->isThreadSafe())
+		_scalerBands = Common::WorkerPool::instance().getNumThreads() + 1;
 	if (_useOldSrc) {
 		_scaler->enableSource(true);
 		_scaler->setSource((byte *)_tmpscreen->pixels, _tmpscreen->pitch,
@@ -928,6 +938,13 @@ void SurfaceSdlGraphicsManager::initGraphicsSurface() {
 bool SurfaceSdlGraphicsManager::loadGFXMode() {
 	_forceRedraw = true;
 
+	delete _dirtyTiles;
+	_dirtyTiles = nullptr;
+	if (ConfMan.getBool("dirty_tile_detection"))
+		_dirtyTiles = new Graphics::DirtyTileTracker();
+	_gameScreenChangedRect = Common::Rect();
+	_dirtyTileUpdates = 0;
+
 	setupHardwareSize();
 
 	//
@@ -1309,6 +1326,10 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_isInOverlayPalette = _overlayVisible;
 	}
 
+	// Find out which parts of the game screen really changed
+	if (_dirtyTiles && !_overlayVisible && !_gameScreenChangedRect.isEmpty())
+		addChangedTiles();
+
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
 	if (_isDoubleBuf && _numDirtyRects)
@@ -1404,8 +1425,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 				if (_videoMode.aspectRatioCorrection && !_overlayInGUI)
 					dst_y = real2Aspect(dst_y);
 
-				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
-						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				const byte *scaleSrc = (byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch;
+				byte *scaleDst = (byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch;
+
+				// Handing small rects to the worker threads costs more than it saves
+				if (_scalerBands > 1 && dst_w * dst_h >= 128 * 128)
+					_scaler->scaleInBands(Common::WorkerPool::instance(), MIN<uint>(_scalerBands, dst_h / 16),
+							scaleSrc, srcPitch, scaleDst, dstPitch, dst_w, dst_h, src_x, src_y);
+				else
+					_scaler->scale(scaleSrc, srcPitch, scaleDst, dstPitch, dst_w, dst_h, src_x, src_y);
 
 				r->x = dst_x;
 				r->y = dst_y;
@@ -1653,7 +1681,12 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
-	addDirtyRect(x, y, w, h, false);
+	if (!_dirtyTiles)
+		addDirtyRect(x, y, w, h, false);
+	else if (_gameScreenChangedRect.isEmpty())
+		_gameScreenChangedRect = Common::Rect(x, y, x + w, y + h);
+	else
+		_gameScreenChangedRect.extend(Common::Rect(x, y, x + w, y + h));
 
 	// Try to lock the screen surface
 	if (SDL_LockSurface(_screen) == -1)
@@ -1704,8 +1737,11 @@ void SurfaceSdlGraphicsManager::unlockScreen() {
 	// Unlock the screen surface
 	SDL_UnlockSurface(_screen);
 
-	// Trigger a full screen update
-	_forceRedraw = true;
+	// Trigger a full screen update, or a check of the whole screen
+	if (_dirtyTiles)
+		_gameScreenChangedRect = Common::Rect(_videoMode.screenWidth, _videoMode.screenHeight);
+	else
+		_forceRedraw = true;
 
 	// Finally unlock the graphics mutex
 	_graphicsMutex.unlock();
@@ -1794,6 +1830,34 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	}
 }
 
+void SurfaceSdlGraphicsManager::addChangedTiles() {
+	if (SDL_LockSurface(_screen) == -1)
+		error("SDL_LockSurface failed: %s", SDL_GetError());
+
+	Graphics::Surface screen;
+	screen.init(_screen->w, _screen->h, _screen->pitch, _screen->pixels, _screenFormat);
+	_dirtyTiles->update(screen, _gameScreenChangedRect, _changedTiles);
+	_gameScreenChangedRect = Common::Rect();
+
+	SDL_UnlockSurface(_screen);
+
+	for (uint i = 0; i < _changedTiles.size(); i++) {
+		const Common::Rect &r = _changedTiles[i];
+		addDirtyRect(r.left, r.top, r.width(), r.height(), false);
+	}
+
+	if (++_dirtyTileUpdates == 100) {
+		const uint64 checked = _dirtyTiles->getCheckedPixels();
+		if (checked) {
+			const uint64 skipped = checked - _dirtyTiles->getChangedPixels();
+			debugC(1, kDebugLevelDirtyTiles, "Dirty tiles: skipped %.1f%% of the pixels updated in the last %d frames",
+				skipped * 100.0 / checked, _dirtyTileUpdates);
+		}
+		_dirtyTiles->resetStatistics();
+		_dirtyTileUpdates = 0;
+	}
+}
+
 int16 SurfaceSdlGraphicsManager::getHeight() const {
 	return _videoMode.screenHeight;
 }
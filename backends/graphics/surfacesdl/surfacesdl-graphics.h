@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirtytiles.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -335,6 +336,7 @@ protected:
 	Scaler *_scaler, *_mouseScaler;
 	uint _maxExtraPixels;
 	uint _extraPixels;
+	uint _scalerBands;
 
 	bool _screenIsLocked;
 	Graphics::Surface _framebuffer;
@@ -356,6 +358,15 @@ protected:
 	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
 	int _numPrevDirtyRects;
 
+	// Optional detection of the changed parts of the game screen, for
+	// engines which copy their whole screen every frame. When enabled, the
+	// areas updated by the engine are accumulated in _gameScreenChangedRect
+	// and compared with the previous frame before being scaled.
+	Graphics::DirtyTileTracker *_dirtyTiles;
+	Common::Rect _gameScreenChangedRect;
+	Common::Array<Common::Rect> _changedTiles;
+	int _dirtyTileUpdates;
+
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
 		int16 w, h;
@@ -418,6 +429,7 @@ protected:
 #endif
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool inOverlay, bool realCoordinates = false);
+	void addChangedTiles();
 
 	virtual void drawMouse();
 	virtual void undrawMouse();
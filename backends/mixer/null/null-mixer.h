@@ -46,7 +46,20 @@ public:
 
 	bool isNullDevice() const override;
 
+	/**
+	 * Function called right before and right after every mixer callback
+	 * done by any null mixer. It is used by the headless benchmark to time
+	 * the mixing.
+	 */
+	typedef void (*CallbackProfiler)(bool finished);
+
+	static void setCallbackProfiler(CallbackProfiler profiler) {
+		_callbackProfiler = profiler;
+	}
+
 private:
+	static CallbackProfiler _callbackProfiler;
+
 	uint32 _outputRate;
 	uint32 _callsCounter;
 	uint32 _samples;
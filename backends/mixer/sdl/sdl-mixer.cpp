@@ -123,6 +123,11 @@ void SdlMixerManager::init() {
 
 	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desired.samples);
 	assert(_mixer);
+
+	// Let engine calls post channel commands instead of waiting for the audio callback
+	if (ConfMan.hasKey("mixer_command_queue") && ConfMan.getBool("mixer_command_queue"))
+		_mixer->setCommandQueueEnabled(true);
+
 	_mixer->setReady(true);
 
 	startAudio();
@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "backends/platform/null/benchmark.h"
+
+#include "common/algorithm.h"
+
+Benchmark::Benchmark() : _frameLimit(0), _maxFrameTimeP99(0) {
+}
+
+bool Benchmark::parseCommandLine(int &argc, char *argv[]) {
+	int remaining = 1;
+	for (int i = 1; i < argc; i++) {
+		Common::String option(argv[i]);
+		if (option.hasPrefix("--bench-frames=")) {
+			int frames = atoi(option.c_str() + 15);
+			if (frames <= 0)
+				return false;
+			_frameLimit = frames;
+		} else if (option.hasPrefix("--bench-max-p99=")) {
+			double milliseconds = atof(option.c_str() + 16);
+			if (milliseconds <= 0)
+				return false;
+			_maxFrameTimeP99 = MAX<uint32>((uint32)(milliseconds * 1000), 1);
+		} else if (option.hasPrefix("--bench-")) {
+			return false;
+		} else {
+			argv[remaining++] = argv[i];
+		}
+	}
+	argc = remaining;
+	argv[argc] = nullptr;
+	return true;
+}
+
+void Benchmark::addFrame(uint32 frameTime, uint32 updateTime, uint32 allocations) {
+	_frameTimes.push_back(frameTime);
+	_updateTimes.push_back(updateTime);
+	_allocations.push_back(allocations);
+}
+
+void Benchmark::addMixerCallback(uint32 time) {
+	_mixerTimes.push_back(time);
+}
+
+bool Benchmark::isFinished() const {
+	return _frameLimit && _frameTimes.size() >= _frameLimit;
+}
+
+uint32 Benchmark::percentile(const Common::Array<uint32> &sorted, uint p) {
+	// Nearest rank method
+	uint rank = (p * sorted.size() + 99) / 100;
+	return sorted[rank ? rank - 1 : 0];
+}
+
+void Benchmark::reportSeries(Common::String &output, const char *name, const Common::Array<uint32> &samples, bool isTime) {
+	output += Common::String::format("%-24s", name);
+	if (samples.empty()) {
+		output += "no samples\n";
+		return;
+	}
+
+	Common::Array<uint32> sorted(samples);
+	Common::sort(sorted.begin(), sorted.end());
+
+	uint64 sum = 0;
+	for (uint i = 0; i < sorted.size(); i++)
+		sum += sorted[i];
+
+	const uint32 values[] = {
+		sorted.front(), percentile(sorted, 50), percentile(sorted, 90),
+		percentile(sorted, 95), percentile(sorted, 99), sorted.back()
+	};
+	for (uint i = 0; i < ARRAYSIZE(values); i++) {
+		if (isTime)
+			output += Common::String::format(" %9.3f", values[i] / 1000.0);
+		else
+			output += Common::String::format(" %9u", values[i]);
+	}
+	if (isTime)
+		output += Common::String::format(" %9.3f\n", (double)sum / sorted.size() / 1000.0);
+	else
+		output += Common::String::format(" %9.1f\n", (double)sum / sorted.size());
+}
+
+bool Benchmark::report(Common::String &output) const {
+	output = Common::String::format("Benchmark results for %u frames and %u mixer callbacks\n",
+	                                _frameTimes.size(), _mixerTimes.size());
+	output += Common::String::format("%-24s %9s %9s %9s %9s %9s %9s %9s\n", "", "min", "p50", "p90", "p95", "p99", "max", "mean");
+	reportSeries(output, "Frame time (ms)", _frameTimes, true);
+	reportSeries(output, "updateScreen (ms)", _updateTimes, true);
+	reportSeries(output, "Mixer callback (ms)", _mixerTimes, true);
+	reportSeries(output, "Allocations per frame", _allocations, false);
+
+	if (!_maxFrameTimeP99)
+		return true;
+
+	if (_frameTimes.empty()) {
+		output += "FAILED: no frame was rendered\n";
+		return false;
+	}
+
+	Common::Array<uint32> sorted(_frameTimes);
+	Common::sort(sorted.begin(), sorted.end());
+	const uint32 p99 = percentile(sorted, 99);
+	if (p99 > _maxFrameTimeP99) {
+		output += Common::String::format("FAILED: p99 frame time %.3f ms is above %.3f ms\n", p99 / 1000.0, _maxFrameTimeP99 / 1000.0);
+		return false;
+	}
+	output += Common::String::format("PASSED: p99 frame time %.3f ms is below %.3f ms\n", p99 / 1000.0, _maxFrameTimeP99 / 1000.0);
+	return true;
+}
@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BACKENDS_PLATFORM_NULL_BENCHMARK_H
+#define BACKENDS_PLATFORM_NULL_BENCHMARK_H
+
+#include "common/array.h"
+#include "common/str.h"
+
+/**
+ * Statistics gathered by the headless benchmark harness, scummvm-bench.
+ *
+ * The null backend feeds it with the time spent on every frame, in
+ * updateScreen() and in every mixer callback, along with the number of
+ * allocations done during each frame, and it turns them into a
+ * percentile report.
+ */
+class Benchmark {
+public:
+	Benchmark();
+
+	/**
+	 * Remove the benchmark options from the command line, so that the rest
+	 * of it can be handled by scummvm_main():
+	 *
+	 *   --bench-frames=NUM   Stop after NUM frames
+	 *   --bench-max-p99=MS   Fail if the 99th percentile of the frame time
+	 *                        is above MS milliseconds
+	 *
+	 * @return false if one of these options has an invalid value.
+	 */
+	bool parseCommandLine(int &argc, char *argv[]);
+
+	/**
+	 * Add a frame. The times are in microseconds.
+	 *
+	 * @param frameTime    Time spent since the previous frame, not counting
+	 *                     the time spent sleeping.
+	 * @param updateTime   Time spent in updateScreen().
+	 * @param allocations  Number of allocations done since the previous frame.
+	 */
+	void addFrame(uint32 frameTime, uint32 updateTime, uint32 allocations);
+
+	/** Add the time spent in one mixer callback, in microseconds. */
+	void addMixerCallback(uint32 time);
+
+	/** Return whether the number of frames given by --bench-frames was reached. */
+	bool isFinished() const;
+
+	/**
+	 * Write the report to output.
+	 *
+	 * @return false if the threshold given by --bench-max-p99 is exceeded.
+	 */
+	bool report(Common::String &output) const;
+
+private:
+	static void reportSeries(Common::String &output, const char *name, const Common::Array<uint32> &samples, bool isTime);
+	static uint32 percentile(const Common::Array<uint32> &sorted, uint p);
+
+	Common::Array<uint32> _frameTimes;
+	Common::Array<uint32> _updateTimes;
+	Common::Array<uint32> _mixerTimes;
+	Common::Array<uint32> _allocations;
+
+	uint32 _frameLimit;
+	uint32 _maxFrameTimeP99;
+};
+
+#endif
@@ -58,6 +58,14 @@ typedef void (*sighandler_t)(int);
 #include "backends/mixer/null/null-mixer.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
+
+#ifdef ENABLE_EVENTRECORDER
+#include "gui/EventRecorder.h"
+#endif
+#endif
+
+#ifdef NULL_DRIVER_BENCHMARK
+#include "backends/platform/null/benchmark.h"
 #endif
 
 /*
@@ -89,6 +97,12 @@ public:
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	virtual MixerManager *getMixerManager();
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void quit();
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
@@ -122,8 +136,96 @@ OSystem_NULL::OSystem_NULL(bool silenceLogs) :
 }
 
 OSystem_NULL::~OSystem_NULL() {
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	// The timer manager is owned by the event recorder
+	delete g_eventRec.getTimerManager();
+	_timerManager = nullptr;
+#endif
+}
+
+#ifdef NULL_DRIVER_BENCHMARK
+/*
+ * Headless benchmark harness, built as scummvm-bench by null-bench.cpp.
+ * A frame ends with each updateScreen() call; its time is the wall time
+ * since the previous frame, minus the time spent in delayMillis().
+ */
+#ifdef POSIX
+static uint64 getMicroseconds() {
+	timeval curTime;
+	gettimeofday(&curTime, 0);
+	return (uint64)curTime.tv_sec * 1000000 + curTime.tv_usec;
+}
+#elif defined(WIN32)
+static uint64 getMicroseconds() {
+	return (uint64)GetTickCount() * 1000;
+}
+#else
+static uint64 getMicroseconds() {
+	return 0;
+}
+#endif
+
+static Benchmark *benchmark = nullptr;
+static uint64 benchmarkLastFrame = 0;
+static uint64 benchmarkSleepTime = 0;
+static uint64 benchmarkMixerStart = 0;
+static uint32 benchmarkAllocations = 0;
+static uint32 benchmarkLastAllocations = 0;
+
+// Count the allocations. The null backend does not run any thread, so
+// the counter does not need to be atomic.
+void *operator new(size_t size) {
+	benchmarkAllocations++;
+	return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept {
+	free(ptr);
+}
+
+static bool finishBenchmark() {
+	static bool finished = false;
+	static bool passed = true;
+	if (!finished) {
+		finished = true;
+		Common::String report;
+		passed = benchmark->report(report);
+		fputs(report.c_str(), stdout);
+		fflush(stdout);
+	}
+	return passed;
 }
 
+static void profileMixerCallback(bool finished) {
+	if (!finished)
+		benchmarkMixerStart = getMicroseconds();
+	else
+		benchmark->addMixerCallback(getMicroseconds() - benchmarkMixerStart);
+}
+
+class BenchmarkGraphicsManager : public NullGraphicsManager {
+public:
+	void updateScreen() override {
+		const uint64 start = getMicroseconds();
+		NullGraphicsManager::updateScreen();
+		const uint64 end = getMicroseconds();
+
+		// The first frame is only used as the starting point, it would
+		// otherwise account for the whole engine initialization
+		if (benchmarkLastFrame) {
+			benchmark->addFrame(end - benchmarkLastFrame - benchmarkSleepTime, end - start,
+			                    benchmarkAllocations - benchmarkLastAllocations);
+		}
+		benchmarkLastFrame = end;
+		benchmarkSleepTime = 0;
+		benchmarkLastAllocations = benchmarkAllocations;
+
+		if (benchmark->isFinished())
+			g_system->quit();
+	}
+};
+#endif
+
 #if defined(POSIX) && !defined(NULL_DRIVER_USE_FOR_TEST)
 static volatile bool intReceived = false;
 
@@ -147,13 +249,24 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
-	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
+#ifdef NULL_DRIVER_BENCHMARK
+	_graphicsManager = new BenchmarkGraphicsManager();
+	NullMixerManager::setCallbackProfiler(profileMixerCallback);
+#else
 	_graphicsManager = new NullGraphicsManager();
+#endif
 	_mixerManager = new NullMixerManager();
 	// Setup and start mixer
 	_mixerManager->init();
+
+#ifdef ENABLE_EVENTRECORDER
+	g_eventRec.registerMixerManager(_mixerManager);
+	g_eventRec.registerTimerManager(new DefaultTimerManager());
+#else
+	_timerManager = new DefaultTimerManager();
+#endif
 #endif
 
 	BaseBackend::initBackend();
@@ -196,21 +309,40 @@ uint32 OSystem_NULL::getMillis(bool skipRecord) {
 
 	gettimeofday(&curTime, 0);
 
-	return (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
+	uint32 millis = (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
 			((curTime.tv_usec - _startTime.tv_usec) / 1000));
 #elif defined(WIN32)
-	return GetTickCount() - _startTime;
+	uint32 millis = GetTickCount() - _startTime;
 #else
-	return 0;
+	uint32 millis = 0;
 #endif
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	g_eventRec.processMillis(millis, skipRecord);
+#endif
+
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	if (g_eventRec.processDelayMillis())
+		return;
+#endif
+
+#ifdef NULL_DRIVER_BENCHMARK
+	const uint64 start = getMicroseconds();
+#endif
+
 #ifdef POSIX
 	usleep(msecs * 1000);
 #elif defined(WIN32)
 	Sleep(msecs);
 #endif
+
+#ifdef NULL_DRIVER_BENCHMARK
+	benchmarkSleepTime += getMicroseconds() - start;
+#endif
 }
 
 void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
@@ -223,11 +355,33 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	td.tm_mon = t.tm_mon;
 	td.tm_year = t.tm_year;
 	td.tm_wday = t.tm_wday;
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	g_eventRec.processTimeAndDate(td, skipRecord);
+#endif
+}
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+MixerManager *OSystem_NULL::getMixerManager() {
+	return g_eventRec.getMixerManager();
 }
 
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 void OSystem_NULL::quit() {
+#ifdef NULL_DRIVER_BENCHMARK
+	exit(finishBenchmark() ? 0 : 1);
+#else
 	exit(0);
+#endif
 }
 #endif
 
@@ -257,12 +411,28 @@ OSystem *OSystem_NULL_create(bool silenceLogs) {
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 int main(int argc, char *argv[]) {
+#ifdef NULL_DRIVER_BENCHMARK
+	benchmark = new Benchmark();
+	if (!benchmark->parseCommandLine(argc, argv)) {
+		fputs("Usage: scummvm-bench [--bench-frames=NUM] [--bench-max-p99=MS] [SCUMMVM OPTIONS]\n", stderr);
+		delete benchmark;
+		return 1;
+	}
+#endif
+
 	g_system = OSystem_NULL_create(false);
 	assert(g_system);
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+#ifdef NULL_DRIVER_BENCHMARK
+	if (!finishBenchmark() && res == 0)
+		res = 1;
+#endif
 	g_system->destroy();
+#ifdef NULL_DRIVER_BENCHMARK
+	delete benchmark;
+#endif
 	return res;
 }
 #endif
@@ -0,0 +1,28 @@
+# Headless benchmark harness. It is linked from the same objects as the
+# ScummVM executable, with the null backend replaced by its profiling
+# variant, and is run like ScummVM with some additional options:
+#
+#   ./scummvm-bench --bench-frames=2000 --bench-max-p99=16 \
+#       --record-mode=playback --record-file-name=monkey.r00 monkey
+#
+# Scripted input requires configuring with --enable-eventrecorder.
+BENCH_EXECUTABLE := scummvm-bench$(EXEEXT)
+BENCH_OBJS := \
+	backends/platform/null/benchmark.o \
+	backends/platform/null/null-bench.o
+
+$(BENCH_EXECUTABLE): $(BENCH_OBJS) $(DETECT_OBJS) $(filter-out backends/platform/null/null.o,$(OBJS))
+	+$(QUIET_LINK)$(LD) $(LDFLAGS) $(PRE_OBJS_FLAGS) $+ $(POST_OBJS_FLAGS) $(LIBS) -o $@
+
+ifneq ($(BENCH_EXECUTABLE),scummvm-bench)
+scummvm-bench: $(BENCH_EXECUTABLE)
+.PHONY: scummvm-bench
+endif
+
+clean: clean-bench
+clean-bench:
+	$(RM) $(BENCH_EXECUTABLE) $(BENCH_OBJS)
+
+.PHONY: clean-bench
+
+include $(srcdir)/ports.mk
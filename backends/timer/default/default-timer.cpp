@@ -23,6 +23,7 @@
 #include "backends/timer/default/default-timer.h"
 #include "common/util.h"
 #include "common/system.h"
+#include "common/textconsole.h"
 
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
@@ -34,84 +35,195 @@ struct TimerSlot {
 	uint32 nextFireTimeMicro;	// microseconds part of nextFire
 
 	TimerSlot *next;
+	TimerSlot **prev;	// the link pointing to this slot
+	bool removed;	// removed while its callback was running
+
+	uint32 calls;
+	uint32 overruns;
+	uint32 maxLatency;
+	uint32 totalLatency;
+	uint32 maxRunTime;
+
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0),
+		next(nullptr), prev(nullptr), removed(false) {
+		resetStatistics();
+	}
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
+	void resetStatistics() {
+		calls = 0;
+		overruns = 0;
+		maxLatency = 0;
+		totalLatency = 0;
+		maxRunTime = 0;
+	}
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = nullptr;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == nullptr || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+static void linkSlot(TimerSlot *&list, TimerSlot *slot) {
+	slot->next = list;
+	if (list)
+		list->prev = &slot->next;
+	slot->prev = &list;
+	list = slot;
+}
+
+static void unlinkSlot(TimerSlot *slot) {
+	if (!slot->prev)
+		return;
+	*slot->prev = slot->next;
+	if (slot->next)
+		slot->next->prev = slot->prev;
+	slot->next = nullptr;
+	slot->prev = nullptr;
 }
 
 
 DefaultTimerManager::DefaultTimerManager() :
-	_timerCallbackNext(0),
-	_head(nullptr) {
+	_expired(nullptr),
+	_running(nullptr),
+	_nextTick(0),
+	_timerCallbackNext(0) {
 
-	_head = new TimerSlot();
+	memset(_root, 0, sizeof(_root));
+	memset(_levels, 0, sizeof(_levels));
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
+	Common::StackLock handlerLock(_handlerMutex);
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
+	for (TimerProcMap::iterator i = _slots.begin(); i != _slots.end(); ++i)
+		delete i->_value;
+	_slots.clear();
+}
+
+void DefaultTimerManager::schedule(TimerSlot *slot) {
+	// The root wheel holds one list per millisecond for the next kRootSize
+	// milliseconds, every further level covers kLevelSize times the range
+	// of the previous one. Slots are moved down a level by cascade() when
+	// the root wheel wraps around to their part of the timeline.
+	uint32 expires = slot->nextFireTime;
+	int32 delta = (int32)(expires - _nextTick);
+	if (delta < 0) {
+		// Overdue, fire on the next tick
+		expires = _nextTick;
+		delta = 0;
+	}
+
+	if (delta < kRootSize) {
+		linkSlot(_root[expires & (kRootSize - 1)], slot);
+		return;
+	}
+
+	for (int level = 0; level < kWheelLevels - 1; level++) {
+		const uint shift = kRootBits + (level + 1) * kLevelBits;
+		if ((uint32)delta < (1U << shift) || level == kWheelLevels - 2) {
+			// Beyond the range of the wheel: park the slot at its end,
+			// it is rescheduled when its list cascades.
+			if ((uint32)delta >= (1U << shift))
+				expires = _nextTick + (1U << shift) - 1;
+
+			linkSlot(_levels[level][(expires >> (shift - kLevelBits)) & (kLevelSize - 1)], slot);
+			return;
+		}
+	}
+}
+
+void DefaultTimerManager::cascade(int level, uint index) {
+	TimerSlot *slot = _levels[level][index];
+	_levels[level][index] = nullptr;
+
 	while (slot) {
 		TimerSlot *next = slot->next;
-		delete slot;
+		slot->prev = nullptr;
+		schedule(slot);
 		slot = next;
 	}
-	_head = nullptr;
 }
 
-void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
-
-	uint32 curTime = g_system->getMillis(true);
-
-	// On slow systems this could still be run after destructor
-	if (!_head)
-		return;
+void DefaultTimerManager::runExpired(uint32 curTime) {
+	while (_expired) {
+		TimerSlot *slot = _expired;
+		unlinkSlot(slot);
 
-	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
+		const uint32 latency = curTime - slot->nextFireTime;
+		slot->calls++;
+		slot->totalLatency += latency;
+		slot->maxLatency = MAX(slot->maxLatency, latency);
+		if ((uint64)latency * 1000 > slot->interval)
+			slot->overruns++;
 
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+		// Advance the fire time by exactly one interval, so that late
+		// invocations do not make the timer drift.
 		assert(slot->interval > 0);
 		slot->nextFireTime += (slot->interval / 1000);
 		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
+		if (slot->nextFireTimeMicro >= 1000) {
 			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
 			slot->nextFireTimeMicro %= 1000;
 		}
-		insertPrioQueue(_head, slot);
 
-		// Invoke the timer callback
+		// Timers with intervals below the wheel resolution fire again
+		// within the tick which was just processed.
+		if ((int32)(slot->nextFireTime - _nextTick) < 0)
+			linkSlot(_expired, slot);
+		else
+			schedule(slot);
+
+		// Invoke the timer callback. The wheel is unlocked meanwhile, so
+		// the callback and other threads may install and remove timers.
 		assert(slot->callback);
-		slot->callback(slot->refCon);
+		TimerProc callback = slot->callback;
+		void *refCon = slot->refCon;
+		_running = slot;
+		_mutex.unlock();
+
+		const uint32 startTime = g_system->getMillis(true);
+		callback(refCon);
+		const uint32 runTime = g_system->getMillis(true) - startTime;
+
+		_mutex.lock();
+		_running = nullptr;
+		if (slot->removed)
+			delete slot;
+		else
+			slot->maxRunTime = MAX(slot->maxRunTime, runTime);
+	}
+}
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+void DefaultTimerManager::runTimers(uint32 curTime) {
+	Common::StackLock handlerLock(_handlerMutex);
+	_mutex.lock();
+
+	// Without timers there is nothing to catch up with
+	if (_slots.empty())
+		_nextTick = curTime;
+
+	// Process every millisecond before the current one
+	while ((int32)(curTime - _nextTick) > 0) {
+		const uint index = _nextTick & (kRootSize - 1);
+		if (index == 0) {
+			for (int level = 0; level < kWheelLevels - 1; level++) {
+				const uint levelIndex = (_nextTick >> (kRootBits + level * kLevelBits)) & (kLevelSize - 1);
+				cascade(level, levelIndex);
+				if (levelIndex != 0)
+					break;
+			}
+		}
+
+		_expired = _root[index];
+		_root[index] = nullptr;
+		if (_expired)
+			_expired->prev = &_expired;
+		_nextTick++;
+
+		runExpired(curTime);
 	}
+
+	_mutex.unlock();
+}
+
+void DefaultTimerManager::handler() {
+	runTimers(g_system->getMillis(true));
 }
 
 void DefaultTimerManager::checkTimers(uint32 interval) {
@@ -133,58 +245,96 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 			error("Different callbacks are referred by same name (%s)", id.c_str());
 		}
 	}
-	TimerSlotMap::const_iterator i;
-
-	for (i = _callbacks.begin(); i != _callbacks.end(); ++i) {
-		if (i->_value == callback) {
-			error("Same callback added twice (old name: %s, new name: %s)", i->_key.c_str(), id.c_str());
-		}
+	TimerProcMap::const_iterator i = _slots.find(callback);
+	if (i != _slots.end()) {
+		error("Same callback added twice (old name: %s, new name: %s)", i->_value->id.c_str(), id.c_str());
 	}
 	_callbacks[id] = callback;
 
+	const uint32 curTime = g_system->getMillis();
+	if (_slots.empty())
+		_nextTick = curTime;
+
 	TimerSlot *slot = new TimerSlot;
 	slot->callback = callback;
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
+	slot->nextFireTime = curTime + interval / 1000;
 	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = nullptr;
 
-	insertPrioQueue(_head, slot);
+	_slots[callback] = slot;
+	schedule(slot);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
-
-	TimerSlot *slot = _head;
-
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
+	bool running = false;
+
+	_mutex.lock();
+
+	TimerProcMap::iterator i = _slots.find(callback);
+	if (i != _slots.end()) {
+		TimerSlot *slot = i->_value;
+		_slots.erase(i);
+		unlinkSlot(slot);
+
+		// We need to remove the name referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// returns to launcher and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		_callbacks.erase(slot->id);
+
+		// A running slot is deleted by the handler once the callback returned
+		if (slot == _running) {
+			slot->removed = true;
+			running = true;
 		} else {
-			slot = slot->next;
+			delete slot;
 		}
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// returns to launcher and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	_mutex.unlock();
+
+	// No instance of the callback may be running after returning, so wait
+	// for the handler. The mutex is recursive, which lets callbacks remove
+	// themselves.
+	if (running) {
+		Common::StackLock handlerLock(_handlerMutex);
 	}
 }
+
+void DefaultTimerManager::getTimerStatistics(Common::Array<TimerStatistics> &stats) {
+	Common::StackLock lock(_mutex);
+
+	stats.clear();
+	for (TimerProcMap::const_iterator i = _slots.begin(); i != _slots.end(); ++i) {
+		const TimerSlot *slot = i->_value;
+
+		TimerStatistics timer;
+		timer.id = slot->id;
+		timer.interval = slot->interval;
+		timer.calls = slot->calls;
+		timer.overruns = slot->overruns;
+		timer.maxLatency = slot->maxLatency;
+		timer.totalLatency = slot->totalLatency;
+		timer.maxRunTime = slot->maxRunTime;
+		stats.push_back(timer);
+	}
+}
+
+void DefaultTimerManager::resetTimerStatistics() {
+	Common::StackLock lock(_mutex);
+
+	for (TimerProcMap::iterator i = _slots.begin(); i != _slots.end(); ++i)
+		i->_value->resetStatistics();
+}
@@ -24,32 +24,70 @@
 
 #include "common/str.h"
 #include "common/hash-str.h"
+#include "common/hash-ptr.h"
 #include "common/timer.h"
 #include "common/mutex.h"
 
 struct TimerSlot;
 
+/**
+ * Timer manager scheduling the timer procs on a hierarchical timing wheel
+ * with a resolution of one millisecond.
+ *
+ * Installing and removing a timer proc takes constant time. The callbacks
+ * are invoked without holding the lock protecting the wheel, so installing
+ * or removing other timers does not wait for running callbacks.
+ */
 class DefaultTimerManager : public Common::TimerManager {
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
+	typedef Common::HashMap<TimerProc, TimerSlot *> TimerProcMap;
 
-	Common::Mutex _mutex;
-	TimerSlot *_head;
+	enum {
+		kWheelLevels = 4,
+		kRootBits = 8,
+		kLevelBits = 6,
+		kRootSize = 1 << kRootBits,
+		kLevelSize = 1 << kLevelBits
+	};
+
+	Common::Mutex _mutex;        ///< Protects the wheel and the slots
+	Common::Mutex _handlerMutex; ///< Held while the handler runs callbacks
 	TimerSlotMap _callbacks;
+	TimerProcMap _slots;
+
+	TimerSlot *_root[kRootSize];
+	TimerSlot *_levels[kWheelLevels - 1][kLevelSize];
+	TimerSlot *_expired;
+	TimerSlot *_running;
+	uint32 _nextTick;	///< The next millisecond the wheel has to process
 
 	uint32 _timerCallbackNext;
 
+	void schedule(TimerSlot *slot);
+	void cascade(int level, uint index);
+	void runExpired(uint32 curTime);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
+	virtual void getTimerStatistics(Common::Array<TimerStatistics> &stats);
+	virtual void resetTimerStatistics();
 
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
 
+	/**
+	 * Invoke all timer callbacks scheduled before @p curTime, in milliseconds.
+	 * A timer which is late by several intervals is invoked once per missed
+	 * interval, so that it keeps its long term rate.
+	 */
+	void runTimers(uint32 curTime);
+
 	/*
 	 * Ensure that the callback is called at regular time intervals.
 	 * Should be called from pollEvents() on backends without threads.
@@ -176,6 +176,16 @@ char Archive::getPathSeparator() const {
 	return '/';
 }
 
+SharedArchiveContents::SharedArchiveContents(const SharedPtr<MappedReadStream> &mappedFile, uint32 offset, uint32 contentSize) :
+	_strongRef(const_cast<byte *>(mappedFile->getMappedData()) + offset, MappedFileDeleter(mappedFile)), _weakRef(_strongRef),
+	_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {
+}
+
+void SharedArchiveContents::MappedFileDeleter::operator()(byte *) {
+	// The deleter outlives the contents as long as weak references remain
+	_mappedFile.reset();
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
 	return createReadStreamForMemberImpl(path, false, Common::AltStreamType::Invalid);
 }
@@ -284,6 +294,7 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -374,6 +385,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -397,6 +409,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -415,17 +428,75 @@ void SearchSet::setPriority(const String &name, int priority) {
 	insert(node);
 }
 
-bool SearchSet::hasFile(const Path &path) const {
-	if (path.empty())
-		return false;
+void SearchSet::invalidateIndex() {
+	_indexValid = false;
+	_indexEntries.clear();
+	_indexEnd.clear();
+	_index.clear();
+}
 
+void SearchSet::ensureIndex() const {
+	if (_indexValid)
+		return;
+
+	uint rank = 0;
+	for (ArchiveNodeList::const_iterator it = _list.begin(); it != _list.end(); ++it, ++rank) {
+		if (it->_arc->isMemberListIndexable()) {
+			ArchiveMemberList members;
+			it->_arc->listMembers(members);
+			for (ArchiveMemberList::const_iterator m = members.begin(); m != members.end(); ++m) {
+				const Path path = (*m)->getPathInArchive();
+				if (!_index.contains(path))
+					_index[path] = _indexEntries.size();
+				_indexEntries.push_back(IndexEntry(path, *m, rank));
+			}
+		}
+		_indexEnd.push_back(_indexEntries.size());
+	}
+
+	_indexValid = true;
+}
+
+/**
+ * Find the first archive which has the given file, like walking the list
+ * and calling hasFile() on each archive would. Only the archives which
+ * are not indexed are asked; the indexed ones are answered from the index.
+ */
+const SearchSet::Node *SearchSet::findFileArchive(const Path &path, uint &rank) const {
+	ensureIndex();
+
+	IndexMap::const_iterator entry = _index.find(path);
+	const uint indexRank = (entry != _index.end()) ? _indexEntries[entry->_value]._rank : _indexEnd.size();
+
+	rank = 0;
 	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path))
-			return true;
+	for (; it != _list.end(); ++it, ++rank) {
+		if (rank == indexRank) {
+			// The index may be out of date if the file has been removed
+			// since, or may point to a directory
+			if (it->_arc->hasFile(path))
+				return &*it;
+		} else if ((rank > indexRank || !it->_arc->isMemberListIndexable()) && it->_arc->hasFile(path)) {
+			return &*it;
+		}
 	}
 
-	return false;
+	return nullptr;
+}
+
+bool SearchSet::matchIndexEntry(const IndexEntry &entry, const Path &pattern, const String &patternStr, bool matchPathComponents) const {
+	// Same rules as FSDirectory::listMatchingMembers()
+	if (matchPathComponents)
+		return entry._path.toString().matchString(patternStr, true, nullptr);
+	return entry._path.matchPattern(pattern);
+}
+
+bool SearchSet::hasFile(const Path &path) const {
+	if (path.empty())
+		return false;
+
+	uint rank;
+	return findFileArchive(path, rank) != nullptr;
 }
 
 bool SearchSet::isPathDirectory(const Path &path) const {
@@ -452,24 +523,53 @@ bool SearchSet::isPathDirectory(const Path &path) const {
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const Path &pattern, bool matchPathComponents) const {
+	ensureIndex();
+
 	int matches = 0;
+	const String patternStr = matchPathComponents ? pattern.toString() : String();
 
+	uint rank = 0;
 	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it)
-		matches += it->_arc->listMatchingMembers(list, pattern, matchPathComponents);
+	for (; it != _list.end(); ++it, ++rank) {
+		if (!it->_arc->isMemberListIndexable()) {
+			matches += it->_arc->listMatchingMembers(list, pattern, matchPathComponents);
+			continue;
+		}
+
+		for (uint i = rank ? _indexEnd[rank - 1] : 0; i < _indexEnd[rank]; ++i) {
+			if (matchIndexEntry(_indexEntries[i], pattern, patternStr, matchPathComponents)) {
+				list.push_back(_indexEntries[i]._member);
+				++matches;
+			}
+		}
+	}
 
 	return matches;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberDetailsList &list, const Path &pattern, bool matchPathComponents) const {
+	ensureIndex();
+
 	int matches = 0;
+	const String patternStr = matchPathComponents ? pattern.toString() : String();
 
+	uint rank = 0;
 	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		List<ArchiveMemberPtr> matchingMembers;
-		matches += it->_arc->listMatchingMembers(matchingMembers, pattern, matchPathComponents);
-		for (ArchiveMemberPtr &member : matchingMembers)
-			list.push_back(ArchiveMemberDetails(member, it->_name));
+	for (; it != _list.end(); ++it, ++rank) {
+		if (!it->_arc->isMemberListIndexable()) {
+			List<ArchiveMemberPtr> matchingMembers;
+			matches += it->_arc->listMatchingMembers(matchingMembers, pattern, matchPathComponents);
+			for (ArchiveMemberPtr &member : matchingMembers)
+				list.push_back(ArchiveMemberDetails(member, it->_name));
+			continue;
+		}
+
+		for (uint i = rank ? _indexEnd[rank - 1] : 0; i < _indexEnd[rank]; ++i) {
+			if (matchIndexEntry(_indexEntries[i], pattern, patternStr, matchPathComponents)) {
+				list.push_back(ArchiveMemberDetails(_indexEntries[i]._member, it->_name));
+				++matches;
+			}
+		}
 	}
 
 	return matches;
@@ -489,17 +589,15 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path)) {
-			if (container) {
-				*container = it->_arc;
-			}
-			return it->_arc->getMember(path);
-		}
-	}
+	uint rank;
+	const Node *node = findFileArchive(path, rank);
+	if (!node)
+		return ArchiveMemberPtr();
 
-	return ArchiveMemberPtr();
+	if (container) {
+		*container = node->_arc;
+	}
+	return node->_arc->getMember(path);
 }
 
 const ArchiveMemberPtr SearchSet::getMember(const Path &path) const {
@@ -510,8 +608,23 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	uint rank;
+	const Node *node = findFileArchive(path, rank);
+	if (node) {
+		SeekableReadStream *stream = node->_arc->createReadStreamForMember(path);
+		if (stream)
+			return stream;
+	}
+
+	// Some archives open members which they do not report with hasFile(),
+	// and the file may be unreadable, so try all the archives which were not
+	// asked for the file yet.
+	uint curRank = 0;
 	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
+	for (; it != _list.end(); ++it, ++curRank) {
+		if (node ? curRank <= rank : it->_arc->isMemberListIndexable())
+			continue;
+
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
 		if (stream)
 			return stream;
@@ -22,6 +22,7 @@
 #ifndef COMMON_ARCHIVE_H
 #define COMMON_ARCHIVE_H
 
+#include "common/array.h"
 #include "common/error.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -45,6 +46,7 @@ namespace Common {
 
 class ArchiveMember;
 class FSNode;
+class MappedReadStream;
 class SeekableReadStream;
 
 enum class AltStreamType {
@@ -202,6 +204,14 @@ public:
 		return createReadStreamForMember(path);
 	}
 
+	/**
+	 * Check whether the members returned by listMembers() are all the files
+	 * of the archive, and whether listMatchingMembers() matches their paths
+	 * case-insensitively like FSDirectory does. SearchSet keeps an index of
+	 * the members of such archives instead of asking them on every lookup.
+	 */
+	virtual bool isMemberListIndexable() const { return false; }
+
 	/**
 	 * Dump all files from the archive to the given directory
 	 */
@@ -227,11 +237,22 @@ public:
 		_strongRef(contents, ArrayDeleter<byte>()), _weakRef(_strongRef),
 		_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {}
 	SharedArchiveContents() : _strongRef(nullptr), _weakRef(nullptr), _contentSize(0), _missingFile(true), _bypass(nullptr) {}
+	/**
+	 * Borrow a part of a mapped file instead of copying it. The mapping is
+	 * kept alive for as long as the contents are referenced.
+	 */
+	SharedArchiveContents(const SharedPtr<MappedReadStream> &mappedFile, uint32 offset, uint32 contentSize);
 	static SharedArchiveContents bypass(SeekableReadStream *stream) {
 		return SharedArchiveContents(stream);
 	}
 
 private:
+	struct MappedFileDeleter {
+		MappedFileDeleter(const SharedPtr<MappedReadStream> &mappedFile) : _mappedFile(mappedFile) {}
+		void operator()(byte *);
+		SharedPtr<MappedReadStream> _mappedFile;
+	};
+
 	SharedArchiveContents(SeekableReadStream *stream) : _strongRef(nullptr), _weakRef(nullptr), _contentSize(0), _missingFile(false), _bypass(stream) {}
 
 	bool isFileMissing() const { return _missingFile; }
@@ -329,8 +350,31 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	/**
+	 * Member of an indexable archive. The entries are sorted by archive
+	 * priority, in the order in which the archives listed them.
+	 */
+	struct IndexEntry {
+		Path _path;
+		ArchiveMemberPtr _member;
+		uint _rank; ///< Position of the archive in _list
+
+		IndexEntry(const Path &path, const ArchiveMemberPtr &member, uint rank) : _path(path), _member(member), _rank(rank) {}
+	};
+	typedef HashMap<Path, uint, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> IndexMap;
+
+	mutable Array<IndexEntry> _indexEntries;
+	mutable IndexMap _index;       ///< First entry in _indexEntries for each path
+	mutable Array<uint> _indexEnd; ///< End of the entries of each archive in _indexEntries
+	mutable bool _indexValid;
+
+	void invalidateIndex();
+	void ensureIndex() const;
+	const Node *findFileArchive(const Path &path, uint &rank) const;
+	bool matchIndexEntry(const IndexEntry &entry, const Path &pattern, const String &patternStr, bool matchPathComponents) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _indexValid(false) { }
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -66,6 +66,41 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * A SeekableReadStream which reads the block following the current one in
+ * the background, on a Common::WorkerPool thread.
+ */
+class PrefetchingReadStream : public SeekableReadStream {
+public:
+	struct Stats {
+		uint32 hits;      ///< Blocks which were prefetched when needed.
+		uint32 misses;    ///< Blocks which had to be waited for or read on the spot.
+		uint32 stallTime; ///< Time spent waiting for blocks, in milliseconds.
+	};
+
+	virtual const Stats &getStats() const = 0;
+};
+
+/**
+ * Take an arbitrary SeekableReadStream and wrap it in a custom stream that
+ * reads ahead of the consumer, so that sequential reads are served from
+ * memory while the next block is read on a worker thread.
+ * Seeking outside of the current and next blocks restarts prefetching at
+ * the new position. If the backend has no threads, the blocks are read on
+ * the spot when they are needed, like wrapBufferedSeekableReadStream() does.
+ *
+ * The parent stream is accessed from the worker thread, so it must not be
+ * used directly while the wrapper exists.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param parentStream        The SeekableReadStream to wrap in a custom stream.
+ * @param blockSize           Size of the blocks read ahead.
+ * @param disposeParentStream Flag indicating whether to dispose of the wrapped stream.
+ */
+PrefetchingReadStream *wrapPrefetchingReadStream(SeekableReadStream *parentStream, uint32 blockSize, DisposeAfterUse::Flag disposeParentStream);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream that
  * transparently provides buffering.
@@ -227,7 +227,8 @@ int unzGetCurrentFileInfo(unzFile file,
    from it, and close it (you can close it before reading all the file)
    */
 
-Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
+Common::SharedArchiveContents unzOpenCurrentFile(unzFile file,
+		const Common::SharedPtr<Common::MappedReadStream> &mappedFile
 #ifndef USE_ZLIB
 		, const Common::CRC32& crc
 #endif
@@ -955,8 +956,10 @@ static int unzlocal_CheckCurrentFileCoherencyHeader(unz_s *s, uInt *piSizeVar,
 /*
   Open for reading data the current file in the zipfile.
   If there is no error and the file is opened, the return value is UNZ_OK.
+  Stored files are borrowed from mappedFile when the zipfile is mapped.
 */
-Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
+Common::SharedArchiveContents unzOpenCurrentFile (unzFile file,
+		const Common::SharedPtr<Common::MappedReadStream> &mappedFile
 #ifndef USE_ZLIB
 		, const Common::CRC32 &crc
 #endif
@@ -982,9 +985,28 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	}
 
 	uint32 crc32_wait = s->cur_file_info.crc;
+	const uLong offset_data = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+	if (mappedFile && s->cur_file_info.compression_method == 0) {
+		if (offset_data + s->cur_file_info.uncompressed_size > (uLong)mappedFile->size())
+			return Common::SharedArchiveContents();
+
+		const byte *data = mappedFile->getMappedData() + offset_data;
+#ifndef USE_ZLIB
+		uint32 crc32_data = crc.crcFast(data, s->cur_file_info.uncompressed_size);
+#else
+		uint32 crc32_data = crc32(0, data, s->cur_file_info.uncompressed_size);
+#endif
+		if (crc32_data != crc32_wait) {
+			warning("CRC32 mismatch: %08x, %08x", crc32_data, crc32_wait);
+			return Common::SharedArchiveContents();
+		}
+
+		return Common::SharedArchiveContents(mappedFile, offset_data, s->cur_file_info.uncompressed_size);
+	}
 
 	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
+	s->_stream->seek(offset_data);
 	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
 	byte *uncompressedBuffer = nullptr;
 
@@ -1028,9 +1050,10 @@ class ZipArchive : public MemcachingCaseInsensitiveArchive {
 	Common::CRC32 _crc;
 #endif
 	bool _flattenTree;
+	SharedPtr<MappedReadStream> _mappedFile;
 
 public:
-	ZipArchive(unzFile zipFile, bool flattenTree);
+	ZipArchive(unzFile zipFile, bool flattenTree, const SharedPtr<MappedReadStream> &mappedFile = SharedPtr<MappedReadStream>());
 
 
 	~ZipArchive();
@@ -1063,7 +1086,8 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree) : _zipFile(zipFile), _flattenTree(flattenTree) {
+ZipArchive::ZipArchive(unzFile zipFile, bool flattenTree, const SharedPtr<MappedReadStream> &mappedFile) :
+	_zipFile(zipFile), _flattenTree(flattenTree), _mappedFile(mappedFile) {
 	assert(_zipFile);
 }
 
@@ -1110,9 +1134,9 @@ Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
 #ifndef USE_ZLIB
-	return unzOpenCurrentFile(_zipFile, _crc);
+	return unzOpenCurrentFile(_zipFile, _mappedFile, _crc);
 #else
-	return unzOpenCurrentFile(_zipFile);
+	return unzOpenCurrentFile(_zipFile, _mappedFile);
 #endif
 }
 
@@ -1121,7 +1145,16 @@ Archive *makeZipArchive(const Path &name, bool flattenTree) {
 }
 
 Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+	// Map the file where possible, so that the stored members are borrowed
+	// from the mapping instead of being read into memory
+	SharedPtr<MappedReadStream> mappedFile(node.createMappedReadStream());
+	if (!mappedFile)
+		return makeZipArchive(node.createReadStream(), flattenTree);
+
+	unzFile zipFile = unzOpen(new MemoryReadStream(mappedFile->getMappedData(), mappedFile->size()), flattenTree);
+	if (!zipFile)
+		return nullptr;
+	return new ZipArchive(zipFile, flattenTree, mappedFile);
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
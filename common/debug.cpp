@@ -36,6 +36,7 @@ const DebugChannelDef gDebugChannels[] = {
 	{ kDebugGlobalDetection, "detection", "debug messages for advancedDetector" },
 	{ kDebugLevelMainGUI,    "maingui",   "debug messages for GUI" },
 	{ kDebugLevelMacGUI,     "macgui",    "debug messages for MacGUI" },
+	{ kDebugLevelDirtyTiles, "dirtytiles", "statistics of the dirty tile detection" },
 	DEBUG_CHANNEL_END
 };
 namespace Common {
@@ -165,6 +165,7 @@ enum GlobalDebugLevels {
 	kDebugLevelEventRec,
 	kDebugLevelMainGUI,
 	kDebugLevelMacGUI,
+	kDebugLevelDirtyTiles,
 };
 
 extern const DebugChannelDef gDebugChannels[];
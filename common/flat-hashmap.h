@@ -0,0 +1,652 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// The flat hash map in this file stores its nodes inline in an open
+// addressing table. Its layout follows the "Swiss table" design: every slot
+// has a control byte holding seven bits of the hash, and lookups compare a
+// whole group of sixteen control bytes at once.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/endian.h"
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * keeps keys and values inline in its table instead of allocating a node for
+ * each entry.
+ *
+ * Each slot caches the full hash of its key, so that growing the table never
+ * calls the hash function again and most mismatching keys are rejected
+ * without calling the equality functor. Probing is done one group of
+ * sixteen slots at a time, using SSE2 when the compiler targets it.
+ *
+ * Unlike HashMap, growing the table moves the entries around, so references
+ * to values are only valid until the next insertion. Erasing never moves
+ * entries.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_GROUP_SIZE = 16,
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The table grows once the used and deleted slots exceed
+		// this fraction of the capacity.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/**
+	 * Values of the control bytes. Used slots store the top seven bits of
+	 * their (mixed) hash, so only free slots have their high bit set.
+	 */
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+	};
+
+	struct Slot {
+		size_type _hash;
+		Node _node;
+
+		Slot(size_type hash, const Key &key) : _hash(hash), _node(key) {}
+	};
+
+	static const size_type NONE_FOUND = (size_type)-1;
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;        ///< Control bytes, one per slot.
+	Slot *_slots;       ///< Uninitialized storage of capacity slots.
+	size_type _mask;    ///< Capacity of the FlatHashMap minus one; capacity is a power of two.
+	size_type _size;
+	size_type _deleted; ///< Number of slots marked as kCtrlDeleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static size_type mixHash(size_type hash) {
+		// Spread weak hashes (e.g. the identity hash of integers) over all
+		// bits. A multiplication alone only carries the differences to the
+		// higher bits, so keys with a power of two stride would share their
+		// low bits and thus their group; this is the MurmurHash3 finalizer.
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6BU;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35U;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	/** The group index uses the low bits of the mixed hash, the tag the top seven. */
+	static byte hashTag(size_type mixed) {
+		return (byte)(mixed >> 25);
+	}
+
+	/**
+	 * Match the group of control bytes starting at @p ctrl against @p tag.
+	 * Sets a bit in @p match for every slot with that tag, and a bit in
+	 * @p freeSlots for every empty or deleted slot.
+	 */
+	static void matchGroup(const byte *ctrl, byte tag, uint &match, uint &freeSlots) {
+#if defined(__SSE2__) && defined(__GNUC__)
+		typedef char Group __attribute__((vector_size(16)));
+		Group group;
+		memcpy(&group, ctrl, sizeof(group));
+		match = (uint)__builtin_ia32_pmovmskb128((Group)(group == (char)tag));
+		freeSlots = (uint)__builtin_ia32_pmovmskb128(group);
+#else
+		// Process the group as two 64-bit words
+		const uint64 lowBits = 0x7F7F7F7F7F7F7F7FULL;
+		const uint64 pattern = tag * 0x0101010101010101ULL;
+		match = 0;
+		freeSlots = 0;
+		for (uint half = 0; half < 2; half++) {
+			const uint64 word = READ_LE_UINT64(ctrl + half * 8);
+			const uint64 diff = word ^ pattern;
+			const uint64 zeroBytes = ~(((diff & lowBits) + lowBits) | diff | lowBits);
+			match |= packHighBits(zeroBytes) << (half * 8);
+			freeSlots |= packHighBits(word & ~lowBits) << (half * 8);
+		}
+#endif
+	}
+
+	/** Gather the high bit of each byte of @p bytes into the low eight bits. */
+	static uint packHighBits(uint64 bytes) {
+		return (uint)(((bytes >> 7) * 0x0102040810204080ULL) >> 56);
+	}
+
+	static uint lowestBit(uint mask) {
+#if defined(__GNUC__)
+		return __builtin_ctz(mask);
+#else
+		uint bit = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			bit++;
+		}
+		return bit;
+#endif
+	}
+
+	/** Check whether one of the @p freeSlots of the group at @p ctrl is empty rather than deleted. */
+	static bool hasEmpty(const byte *ctrl, uint freeSlots) {
+		for (; freeSlots; freeSlots &= freeSlots - 1) {
+			if (ctrl[lowestBit(freeSlots)] == kCtrlEmpty)
+				return true;
+		}
+		return false;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type findFreeSlot(size_type mixed) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void resize(size_type newCapacity);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(!(_hashmap->_ctrl[_idx] & 0x80));
+			return &_hashmap->_slots[_idx]._node;
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextUsed(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextUsed(size_type idx) const {
+		for (; idx <= _mask; ++idx) {
+			if (!(_ctrl[idx] & 0x80))
+				return idx;
+		}
+		return NONE_FOUND;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextUsed(0), this);
+	}
+	iterator	end() {
+		return iterator(NONE_FOUND, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextUsed(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator(NONE_FOUND, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+	_mask = capacity - 1;
+	_ctrl = new byte[capacity];
+	memset(_ctrl, kCtrlEmpty, capacity);
+	_slots = (Slot *)malloc(capacity * sizeof(Slot));
+	assert(_slots != nullptr);
+	_size = 0;
+	_deleted = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			_slots[ctr].~Slot();
+	}
+	delete[] _ctrl;
+	free(_slots);
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The layout stays the same, so the slots can be copied one by one
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			new (&_slots[ctr]) Slot(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (!(_ctrl[ctr] & 0x80))
+			_slots[ctr].~Slot();
+	}
+	memset(_ctrl, kCtrlEmpty, _mask + 1);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Find the first free slot on the probe sequence of the given mixed hash.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(size_type mixed) const {
+	const size_type groupMask = _mask & ~(size_type)(FLATHASHMAP_GROUP_SIZE - 1);
+	size_type group = (mixed * FLATHASHMAP_GROUP_SIZE) & groupMask;
+	for (size_type step = FLATHASHMAP_GROUP_SIZE; ; step += FLATHASHMAP_GROUP_SIZE) {
+		uint match, freeSlots;
+		matchGroup(_ctrl + group, kCtrlEmpty, match, freeSlots);
+		if (freeSlots)
+			return group + lowestBit(freeSlots);
+		// Triangular probing visits every group once the table is a power of two
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::resize(size_type newCapacity) {
+#ifndef NDEBUG
+	const size_type old_size = _size;
+#endif
+	const size_type old_mask = _mask;
+	byte *old_ctrl = _ctrl;
+	Slot *old_slots = _slots;
+
+	allocStorage(newCapacity);
+
+	// Move all the old elements over, using their cached hash. Since we know
+	// that no key exists twice in the old table, we don't have to call
+	// _equal().
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] & 0x80)
+			continue;
+
+		const size_type mixed = mixHash(old_slots[ctr]._hash);
+		const size_type idx = findFreeSlot(mixed);
+		_ctrl[idx] = hashTag(mixed);
+		new (&_slots[idx]) Slot(old_slots[ctr]);
+		old_slots[ctr].~Slot();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+
+	delete[] old_ctrl;
+	free(old_slots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = _hash(key);
+	const size_type mixed = mixHash(hash);
+	const byte tag = hashTag(mixed);
+	const size_type groupMask = _mask & ~(size_type)(FLATHASHMAP_GROUP_SIZE - 1);
+	size_type group = (mixed * FLATHASHMAP_GROUP_SIZE) & groupMask;
+	for (size_type step = FLATHASHMAP_GROUP_SIZE; ; step += FLATHASHMAP_GROUP_SIZE) {
+		uint match, freeSlots;
+		matchGroup(_ctrl + group, tag, match, freeSlots);
+		for (; match; match &= match - 1) {
+			const size_type ctr = group + lowestBit(match);
+			if (_slots[ctr]._hash == hash && _equal(_slots[ctr]._node._key, key))
+				return ctr;
+		}
+		// A group with an empty slot ends every probe sequence passing through it
+		if (hasEmpty(_ctrl + group, freeSlots))
+			return NONE_FOUND;
+		group = (group + step) & groupMask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return ctr;
+
+	// Keep the load factor below a certain threshold.
+	// Deleted slots are also counted
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only rehash in place if enough deleted slots can be reclaimed
+		if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR * 2 > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity *= 2;
+		resize(capacity);
+	}
+
+	const size_type hash = _hash(key);
+	const size_type mixed = mixHash(hash);
+	ctr = findFreeSlot(mixed);
+	if (_ctrl[ctr] == kCtrlDeleted)
+		_deleted--;
+	_ctrl[ctr] = hashTag(mixed);
+	new (&_slots[ctr]) Slot(hash, key);
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != NONE_FOUND;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._node._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._node._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._node._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND)
+		return _slots[ctr]._node._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != NONE_FOUND) {
+		out = _slots[ctr]._node._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._node._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(!(_ctrl[ctr] & 0x80));
+
+	_slots[ctr].~Slot();
+	_size--;
+
+	// No probe sequence went past a group which still has an empty slot,
+	// so the slot can be made empty again instead of leaving a tombstone.
+	const byte *group = _ctrl + (ctr & ~(size_type)(FLATHASHMAP_GROUP_SIZE - 1));
+	uint match, freeSlots;
+	matchGroup(group, kCtrlEmpty, match, freeSlots);
+	if (match) {
+		_ctrl[ctr] = kCtrlEmpty;
+	} else {
+		_ctrl[ctr] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr == NONE_FOUND)
+		return;
+
+	erase(iterator(ctr, this));
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -45,6 +45,7 @@ namespace Common {
 
 class FSNode;
 class FSDirectory;
+class MappedReadStream;
 class SeekableReadStream;
 class WriteStream;
 class SeekableWriteStream;
@@ -261,6 +262,17 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a MappedReadStream instance giving direct access to the whole
+	 * contents of the file referred by this node, mapped into memory. This
+	 * assumes that the node actually refers to a readable file. If this is
+	 * not the case, or if the backend cannot map the file, nullptr is
+	 * returned and createReadStream() has to be used instead.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	MappedReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
@@ -426,6 +438,8 @@ public:
 	 */
 	int listMembers(ArchiveMemberList &list) const override;
 
+	bool isMemberListIndexable() const override { return true; }
+
 	/**
 	 * Get an ArchiveMember representation of the specified file. A full match of relative
 	 * path and file name is needed for success.
@@ -38,7 +38,6 @@
  */
 #define USE_HASHMAP_MEMORY_POOL
 
-
 #include "common/func.h"
 
 #include "common/str.h"
@@ -47,8 +46,13 @@
 #include "common/debug.h"
 #endif
 
-#ifdef USE_HASHMAP_MEMORY_POOL
+// USE_HASHMAP_ARENA, defined in memorypool.h, lets HashMaps allocate their
+// nodes from the shared SizeClassArena instead of a memory pool of their
+// own. This saves the internal storage of the pool in every HashMap.
 #include "common/memorypool.h"
+
+#ifdef USE_HASHMAP_ARENA
+#undef USE_HASHMAP_MEMORY_POOL
 #endif
 
 namespace Common {
@@ -135,7 +139,9 @@ private:
 #endif
 
 	Node *allocNode(const Key &key) {
-#ifdef USE_HASHMAP_MEMORY_POOL
+#if defined(USE_HASHMAP_ARENA)
+		return new (SizeClassArena::instance().alloc(sizeof(Node))) Node(key);
+#elif defined(USE_HASHMAP_MEMORY_POOL)
 		return new (_nodePool) Node(key);
 #else
 		return new Node(key);
@@ -143,12 +149,16 @@ private:
 	}
 
 	void freeNode(Node *node) {
-		if (node && node != HASHMAP_DUMMY_NODE)
-#ifdef USE_HASHMAP_MEMORY_POOL
+		if (node && node != HASHMAP_DUMMY_NODE) {
+#if defined(USE_HASHMAP_ARENA)
+			node->~Node();
+			SizeClassArena::instance().free(node, sizeof(Node));
+#elif defined(USE_HASHMAP_MEMORY_POOL)
 			_nodePool.deleteChunk(node);
 #else
 			delete node;
 #endif
+		}
 	}
 
 	void assign(const HM_t &map);
@@ -24,6 +24,10 @@
 
 #include "common/scummsys.h"
 
+// USE_LIST_ARENA, defined in memorypool.h, lets Lists allocate their nodes
+// from the shared SizeClassArena instead of the global heap.
+#include "common/memorypool.h"
+
 namespace Common {
 
 template<typename T> class List;
@@ -43,6 +47,16 @@ namespace ListInternal {
 		T _data;
 
 		Node(const T &x) : _data(x) {}
+
+#ifdef USE_LIST_ARENA
+		static void *operator new(size_t size) {
+			return SizeClassArena::instance().alloc(size);
+		}
+
+		static void operator delete(void *ptr, size_t size) {
+			SizeClassArena::instance().free(ptr, size);
+		}
+#endif
 	};
 
 	template<typename T> struct ConstIterator;
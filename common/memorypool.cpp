@@ -20,6 +20,8 @@
  */
 
 #include "common/memorypool.h"
+#include "common/mutex.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Common {
@@ -111,6 +113,13 @@ void MemoryPool::freeChunk(void *ptr) {
 	_next = ptr;
 }
 
+size_t MemoryPool::getReservedSize() const {
+	size_t size = 0;
+	for (size_t i = 0; i < _pages.size(); ++i)
+		size += _pages[i].numChunks * _chunkSize;
+	return size;
+}
+
 // Technically not compliant C++ to compare unrelated pointers. In practice...
 bool MemoryPool::isPointerInPage(void *ptr, const Page &page) {
 	return (ptr >= page.start) && (ptr < (char *)page.start + page.numChunks * _chunkSize);
@@ -174,4 +183,211 @@ void MemoryPool::freeUnusedPages() {
 	}
 }
 
+static const size_t kArenaClassSizes[SizeClassArena::NUM_SIZE_CLASSES] = {
+	8, 16, 24, 32, 40, 48, 56, 64,
+	80, 96, 112, 128,
+	160, 192, 224, 256,
+	320, 384, 448, 512
+};
+
+#ifdef USE_ARENA_MAGAZINES
+/**
+ * The free chunks cached by one thread, for each size class.
+ */
+struct ArenaMagazines {
+	void *chunks[SizeClassArena::NUM_SIZE_CLASSES][SizeClassArena::MAGAZINE_SIZE];
+	uint counts[SizeClassArena::NUM_SIZE_CLASSES];
+	bool active;
+
+	ArenaMagazines() : active(true) {
+		memset(counts, 0, sizeof(counts));
+	}
+
+	~ArenaMagazines() {
+		// Blocks freed after this point (e.g. by static destructors of
+		// the main thread) go straight to the shared pools.
+		active = false;
+
+		// Once the backend is gone, the program is about to exit and the
+		// cached chunks can as well stay where they are.
+		if (!g_system)
+			return;
+
+		SizeClassArena &arena = SizeClassArena::instance();
+		for (uint i = 0; i < SizeClassArena::NUM_SIZE_CLASSES; ++i)
+			arena.flush(*this, i, counts[i]);
+	}
+};
+
+static thread_local ArenaMagazines g_arenaMagazines;
+#endif
+
+static SizeClassArena *g_arena = nullptr;
+static Mutex *g_arenaMutex = nullptr;
+
+SizeClassArena &SizeClassArena::instance() {
+	// Never deleted, as blocks may still be freed by static destructors.
+	// From OSystem::initBackend() on, this only returns the existing arena.
+	if (!g_arena)
+		g_arena = new SizeClassArena();
+	return *g_arena;
+}
+
+SizeClassArena::SizeClassArena() : _refills(0), _flushes(0) {
+	for (uint i = 0; i < NUM_SIZE_CLASSES; ++i) {
+		_pools[i] = new MemoryPool(kArenaClassSizes[i]);
+		_chunksOut[i] = 0;
+	}
+}
+
+uint SizeClassArena::getSizeClass(size_t size) {
+	assert(size <= MAX_CHUNK_SIZE);
+	if (size <= 64)
+		return size ? (size - 1) / 8 : 0;
+	if (size <= 128)
+		return 8 + (size - 65) / 16;
+	if (size <= 256)
+		return 12 + (size - 129) / 32;
+	return 16 + (size - 257) / 64;
+}
+
+size_t SizeClassArena::getChunkSize(size_t size) {
+	if (size > MAX_CHUNK_SIZE)
+		return size;
+	return kArenaClassSizes[getSizeClass(size)];
+}
+
+void SizeClassArena::createMutex() {
+	instance();
+	if (!g_arenaMutex)
+		g_arenaMutex = new Mutex();
+}
+
+bool SizeClassArena::lock() {
+	// Like the String reference count pool, the arena is used before
+	// the backend is able to create mutexes. In those early stages, and
+	// in the unit tests, there is no other thread either.
+	if (!g_arenaMutex)
+		return false;
+	g_arenaMutex->lock();
+	return true;
+}
+
+void SizeClassArena::unlock(bool locked) {
+	if (locked && g_arenaMutex)
+		g_arenaMutex->unlock();
+}
+
+void SizeClassArena::releaseMutex() {
+	delete g_arenaMutex;
+	g_arenaMutex = nullptr;
+}
+
+#ifdef USE_ARENA_MAGAZINES
+void SizeClassArena::refill(ArenaMagazines &magazines, uint sizeClass) {
+	const bool locked = lock();
+	while (magazines.counts[sizeClass] < MAGAZINE_SIZE / 2)
+		magazines.chunks[sizeClass][magazines.counts[sizeClass]++] = _pools[sizeClass]->allocChunk();
+	_chunksOut[sizeClass] += MAGAZINE_SIZE / 2;
+	_refills++;
+	unlock(locked);
+}
+
+void SizeClassArena::flush(ArenaMagazines &magazines, uint sizeClass, uint count) {
+	if (!count)
+		return;
+
+	const bool locked = lock();
+	assert(count <= magazines.counts[sizeClass]);
+	for (uint i = 0; i < count; ++i)
+		_pools[sizeClass]->freeChunk(magazines.chunks[sizeClass][--magazines.counts[sizeClass]]);
+	_chunksOut[sizeClass] -= count;
+	_flushes++;
+	unlock(locked);
+}
+#endif
+
+void *SizeClassArena::alloc(size_t size) {
+	if (size > MAX_CHUNK_SIZE)
+		return ::malloc(size);
+
+	const uint sizeClass = getSizeClass(size);
+#ifdef USE_ARENA_MAGAZINES
+	ArenaMagazines &magazines = g_arenaMagazines;
+	if (magazines.active) {
+		if (!magazines.counts[sizeClass])
+			refill(magazines, sizeClass);
+		return magazines.chunks[sizeClass][--magazines.counts[sizeClass]];
+	}
+#endif
+
+	const bool locked = lock();
+	void *result = _pools[sizeClass]->allocChunk();
+	_chunksOut[sizeClass]++;
+	unlock(locked);
+	return result;
+}
+
+void SizeClassArena::free(void *ptr, size_t size) {
+	if (!ptr)
+		return;
+
+	if (size > MAX_CHUNK_SIZE) {
+		::free(ptr);
+		return;
+	}
+
+	const uint sizeClass = getSizeClass(size);
+#ifdef USE_ARENA_MAGAZINES
+	ArenaMagazines &magazines = g_arenaMagazines;
+	if (magazines.active) {
+		// Keep half of a full magazine, so that alternating allocations and
+		// deallocations do not hit the shared pools every time
+		if (magazines.counts[sizeClass] == MAGAZINE_SIZE)
+			flush(magazines, sizeClass, MAGAZINE_SIZE / 2);
+		magazines.chunks[sizeClass][magazines.counts[sizeClass]++] = ptr;
+		return;
+	}
+#endif
+
+	const bool locked = lock();
+	_pools[sizeClass]->freeChunk(ptr);
+	_chunksOut[sizeClass]--;
+	unlock(locked);
+}
+
+void SizeClassArena::freeUnusedPages() {
+#ifdef USE_ARENA_MAGAZINES
+	ArenaMagazines &magazines = g_arenaMagazines;
+	if (magazines.active) {
+		for (uint i = 0; i < NUM_SIZE_CLASSES; ++i)
+			flush(magazines, i, magazines.counts[i]);
+	}
+#endif
+
+	const bool locked = lock();
+	for (uint i = 0; i < NUM_SIZE_CLASSES; ++i)
+		_pools[i]->freeUnusedPages();
+	unlock(locked);
+}
+
+SizeClassArena::Stats SizeClassArena::getStats() {
+	Stats stats;
+	stats.reservedBytes = 0;
+	stats.usedBytes = 0;
+	stats.numPages = 0;
+
+	const bool locked = lock();
+	for (uint i = 0; i < NUM_SIZE_CLASSES; ++i) {
+		stats.reservedBytes += _pools[i]->getReservedSize();
+		stats.usedBytes += _chunksOut[i] * _pools[i]->getChunkSize();
+		stats.numPages += _pools[i]->getNumPages();
+	}
+	stats.refills = _refills;
+	stats.flushes = _flushes;
+	unlock(locked);
+
+	return stats;
+}
+
 } // End of namespace Common
@@ -25,6 +25,24 @@
 #include "common/scummsys.h"
 #include "common/array.h"
 
+/**
+ * Enable the following defines to let Strings (reference counts and short
+ * heap buffers), HashMaps (nodes) and Lists (nodes) allocate from the
+ * shared SizeClassArena, instead of their own memory pools or the global
+ * heap.
+ */
+//#define USE_STRING_ARENA
+//#define USE_HASHMAP_ARENA
+//#define USE_LIST_ARENA
+
+/**
+ * Only once one of the above is enabled does the arena serve enough
+ * allocations to be worth a thread_local magazine of free chunks in every
+ * thread. Otherwise every arena call takes the mutex of the shared pools.
+ */
+#if defined(USE_STRING_ARENA) || defined(USE_HASHMAP_ARENA) || defined(USE_LIST_ARENA)
+#define USE_ARENA_MAGAZINES
+#endif
 
 namespace Common {
 
@@ -101,6 +119,17 @@ public:
 	 * Return the chunk size used by this memory pool.
 	 */
 	size_t	getChunkSize() const { return _chunkSize; }
+
+	/**
+	 * Return the number of pages currently allocated by this memory pool.
+	 */
+	size_t	getNumPages() const { return _pages.size(); }
+
+	/**
+	 * Return the number of bytes held in the pages of this memory pool,
+	 * whether the chunks are in use or not.
+	 */
+	size_t	getReservedSize() const;
 };
 
 /**
@@ -148,6 +177,106 @@ public:
 	}
 };
 
+class Mutex;
+struct ArenaMagazines;
+
+/**
+ * A general purpose allocator for small memory blocks, shared by the
+ * whole program.
+ *
+ * Requests are rounded up to one of a few size classes between 8 and
+ * MAX_CHUNK_SIZE bytes, and each size class is served by its own
+ * MemoryPool. With USE_ARENA_MAGAZINES, every thread keeps a small magazine
+ * of free chunks for each size class, so that most allocations and
+ * deallocations neither take a lock nor touch the shared pools. Larger
+ * requests are passed on to malloc.
+ *
+ * Unlike with MemoryPool, the size of a block must be passed back when
+ * freeing it.
+ */
+class SizeClassArena {
+public:
+	enum {
+		MAX_CHUNK_SIZE = 512,
+		NUM_SIZE_CLASSES = 20,
+		MAGAZINE_SIZE = 16
+	};
+
+	/** Statistics about the memory managed by the arena. */
+	struct Stats {
+		size_t reservedBytes; ///< Bytes held in the pages of all size classes
+		size_t usedBytes;     ///< Bytes handed out to threads, including their magazines
+		size_t numPages;      ///< Pages allocated by all size classes
+		uint32 refills;       ///< Number of magazine refills from the shared pools
+		uint32 flushes;       ///< Number of magazine flushes to the shared pools
+	};
+
+	/**
+	 * Return the arena shared by the whole program.
+	 */
+	static SizeClassArena &instance();
+
+	/**
+	 * Allocate a block of at least @p size bytes.
+	 */
+	void	*alloc(size_t size);
+	/**
+	 * Return a block to the arena. @p size must be the size which was
+	 * passed to alloc() when the block was obtained.
+	 */
+	void	free(void *ptr, size_t size);
+
+	/**
+	 * Return the free chunks of the calling thread to the shared pools,
+	 * then release the pages which are entirely unused.
+	 */
+	void	freeUnusedPages();
+
+	/**
+	 * Return statistics about the memory managed by the arena.
+	 */
+	Stats	getStats();
+
+	/**
+	 * Return the size of the chunks used for blocks of @p size bytes.
+	 */
+	static size_t getChunkSize(size_t size);
+
+	/**
+	 * Create the arena and the mutex of its shared pools. This is done by
+	 * OSystem::initBackend(), before any other thread can use the arena.
+	 * Before that, the arena is used without locking.
+	 */
+	static void createMutex();
+
+	/**
+	 * Release the mutex of the shared pools. It cannot be used once
+	 * the backend has been destroyed.
+	 */
+	static void releaseMutex();
+
+private:
+	friend struct ArenaMagazines;
+
+	SizeClassArena();
+	SizeClassArena(const SizeClassArena &);
+	SizeClassArena &operator=(const SizeClassArena &);
+
+	static uint getSizeClass(size_t size);
+
+	bool	lock();
+	void	unlock(bool locked);
+#ifdef USE_ARENA_MAGAZINES
+	void	refill(ArenaMagazines &magazines, uint sizeClass);
+	void	flush(ArenaMagazines &magazines, uint sizeClass, uint count);
+#endif
+
+	MemoryPool	*_pools[NUM_SIZE_CLASSES];
+	size_t		_chunksOut[NUM_SIZE_CLASSES];
+	uint32		_refills;
+	uint32		_flushes;
+};
+
 /** @} */
 
 } // End of namespace Common
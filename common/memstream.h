@@ -96,6 +96,28 @@ public:
 };
 
 
+/**
+ * A MemoryReadStream over the whole contents of a file, as returned by
+ * FSNode::createMappedReadStream(), backed by a read-only memory mapping of
+ * the file.
+ *
+ * The data returned by getMappedData() may be borrowed for as long as the
+ * stream exists, which avoids copying it into another buffer.
+ */
+class MappedReadStream : public MemoryReadStream {
+private:
+	const byte *_data;
+
+public:
+	MappedReadStream(const byte *data, uint32 dataSize) :
+		MemoryReadStream(data, dataSize), _data(data) {}
+
+	/**
+	 * Return the contents of the file. They must not be modified.
+	 */
+	const byte *getMappedData() const { return _data; }
+};
+
 /**
  * This is a MemoryReadStream subclass which adds non-endian
  * read methods whose endianness is set on the stream creation.
@@ -62,6 +62,31 @@ TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
 
 #endif
 
+// USE_STRING_ARENA, defined in memorypool.h, lets Strings allocate their
+// reference counts and short heap buffers from the shared SizeClassArena
+// instead of the reference count pool and the global heap.
+#ifdef USE_STRING_ARENA
+template<class T>
+static T *allocStorage(uint32 capacity) {
+	return (T *)SizeClassArena::instance().alloc(capacity * sizeof(T));
+}
+
+template<class T>
+static void freeStorage(T *storage, uint32 capacity) {
+	SizeClassArena::instance().free(storage, capacity * sizeof(T));
+}
+#else
+template<class T>
+static T *allocStorage(uint32 capacity) {
+	return new T[capacity];
+}
+
+template<class T>
+static void freeStorage(T *storage, uint32 capacity) {
+	delete[] storage;
+}
+#endif
+
 static uint32 computeCapacity(uint32 len) {
 	// By default, for the capacity we use the next multiple of 32
 	return ((len + 32 - 1) & ~0x1F);
@@ -157,7 +182,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size + 1));
 
 		// Allocate new storage
-		newStorage = new value_type[newCapacity];
+		newStorage = allocStorage<value_type>(newCapacity);
 		assert(newStorage);
 	}
 
@@ -189,6 +214,9 @@ TEMPLATE
 void BASESTRING::incRefCount() const {
 	assert(!isStorageIntern());
 	if (_extern._refCount == nullptr) {
+#ifdef USE_STRING_ARENA
+		_extern._refCount = (int *)SizeClassArena::instance().alloc(sizeof(int));
+#else
 #ifndef SCUMMVM_UTIL
 		lockMemoryPoolMutex();
 #endif
@@ -200,6 +228,7 @@ void BASESTRING::incRefCount() const {
 		_extern._refCount = (int *)g_refCountPool->allocChunk();
 #ifndef SCUMMVM_UTIL
 		unlockMemoryPoolMutex();
+#endif
 #endif
 		*_extern._refCount = 2;
 	} else {
@@ -219,6 +248,9 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 		// The ref count reached zero, so we free the string storage
 		// and the ref count storage.
 		if (oldRefCount) {
+#ifdef USE_STRING_ARENA
+			SizeClassArena::instance().free(oldRefCount, sizeof(int));
+#else
 #ifndef SCUMMVM_UTIL
 			lockMemoryPoolMutex();
 #endif
@@ -226,13 +258,14 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 			g_refCountPool->freeChunk(oldRefCount);
 #ifndef SCUMMVM_UTIL
 			unlockMemoryPoolMutex();
+#endif
 #endif
 		}
 		// Coverity thinks that we always free memory, as it assumes
 		// (correctly) that there are cases when oldRefCount == 0
 		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-		delete[] _str;
+		freeStorage(_str, _extern._capacity);
 #endif
 
 		// Even though _str points to a freed memory block now,
@@ -252,7 +285,7 @@ TEMPLATE void BASESTRING::initWithValueTypeStr(const value_type *str, uint32 len
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len + 1);
 		_extern._refCount = nullptr;
-		_str = new value_type[_extern._capacity];
+		_str = allocStorage<value_type>(_extern._capacity);
 		assert(_str != nullptr);
 	}
 
@@ -19,11 +19,14 @@
  *
  */
 
+#include "common/bufferedstream.h"
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/substream.h"
 #include "common/str.h"
+#include "common/system.h"
+#include "common/thread.h"
 
 namespace Common {
 
@@ -499,6 +502,217 @@ SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStr
 
 namespace {
 
+/**
+ * Wrapper class which reads the block following the current one on a
+ * worker thread. The parent stream is only accessed by the prefetching
+ * job, or by the consumer when no job is pending.
+ */
+class PrefetchingReadStreamImpl : public PrefetchingReadStream {
+public:
+	PrefetchingReadStreamImpl(SeekableReadStream *parentStream, uint32 blockSize, DisposeAfterUse::Flag disposeParentStream);
+	~PrefetchingReadStreamImpl() override;
+
+	bool eos() const override { return _eos; }
+	bool err() const override { return _err; }
+	void clearErr() override;
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	int64 pos() const override { return _bufStart + _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+	const Stats &getStats() const override { return _stats; }
+
+private:
+	static void prefetchProc(void *param);
+	void startPrefetch();
+	void waitPrefetch();
+	bool nextBlock();
+
+	DisposablePtr<SeekableReadStream> _parentStream;
+	const uint32 _blockSize;
+	int64 _size;
+
+	byte *_buf;
+	int64 _bufStart;
+	uint32 _bufSize;
+	uint32 _pos;
+
+	// Written by the prefetching job
+	byte *_nextBuf;
+	int64 _nextStart;
+	uint32 _nextSize;
+	bool _nextEos;
+	bool _nextErr;
+
+	bool _prefetching;
+	bool _parentDone; // the parent reached its end or failed
+	bool _eos;
+	bool _err;
+
+	WorkerPool::JobGroup _job;
+	Stats _stats;
+};
+
+PrefetchingReadStreamImpl::PrefetchingReadStreamImpl(SeekableReadStream *parentStream, uint32 blockSize, DisposeAfterUse::Flag disposeParentStream)
+	: _parentStream(parentStream, disposeParentStream),
+	_blockSize(blockSize),
+	_size(parentStream->size()),
+	_bufStart(parentStream->pos()),
+	_bufSize(0),
+	_pos(0),
+	_nextStart(0),
+	_nextSize(0),
+	_nextEos(false),
+	_nextErr(false),
+	_prefetching(false),
+	_parentDone(false),
+	_eos(false),
+	_err(false) {
+
+	assert(blockSize);
+	_buf = new byte[blockSize];
+	_nextBuf = new byte[blockSize];
+	memset(&_stats, 0, sizeof(_stats));
+
+	startPrefetch();
+}
+
+PrefetchingReadStreamImpl::~PrefetchingReadStreamImpl() {
+	waitPrefetch();
+	delete[] _buf;
+	delete[] _nextBuf;
+}
+
+void PrefetchingReadStreamImpl::prefetchProc(void *param) {
+	PrefetchingReadStreamImpl *stream = (PrefetchingReadStreamImpl *)param;
+	stream->_nextSize = stream->_parentStream->read(stream->_nextBuf, stream->_blockSize);
+	stream->_nextEos = stream->_parentStream->eos();
+	stream->_nextErr = stream->_parentStream->err();
+}
+
+void PrefetchingReadStreamImpl::startPrefetch() {
+	assert(!_prefetching);
+	if (_parentDone)
+		return;
+
+	_nextStart = _bufStart + _bufSize;
+	_prefetching = true;
+	WorkerPool::instance().submit(_job, prefetchProc, this);
+}
+
+void PrefetchingReadStreamImpl::waitPrefetch() {
+	if (_prefetching) {
+		WorkerPool::instance().wait(_job);
+		_prefetching = false;
+	}
+}
+
+bool PrefetchingReadStreamImpl::nextBlock() {
+	if (!_prefetching)
+		return false;
+
+	WorkerPool &pool = WorkerPool::instance();
+	if (pool.isDone(_job)) {
+		_stats.hits++;
+	} else {
+		_stats.misses++;
+		const uint32 start = g_system->getMillis();
+		pool.wait(_job);
+		_stats.stallTime += g_system->getMillis() - start;
+	}
+	_prefetching = false;
+
+	SWAP(_buf, _nextBuf);
+	_bufStart = _nextStart;
+	_bufSize = _nextSize;
+	_pos = 0;
+	if (_nextErr)
+		_err = true;
+	_parentDone = _nextEos || _nextErr;
+
+	startPrefetch();
+	return _bufSize != 0;
+}
+
+uint32 PrefetchingReadStreamImpl::read(void *dataPtr, uint32 dataSize) {
+	uint32 alreadyRead = 0;
+
+	while (dataSize) {
+		if (_pos == _bufSize && !nextBlock()) {
+			_eos = true;
+			break;
+		}
+
+		const uint32 n = MIN(dataSize, _bufSize - _pos);
+		memcpy(dataPtr, _buf + _pos, n);
+		_pos += n;
+		alreadyRead += n;
+		dataPtr = (byte *)dataPtr + n;
+		dataSize -= n;
+	}
+
+	return alreadyRead;
+}
+
+bool PrefetchingReadStreamImpl::seek(int64 offset, int whence) {
+	_eos = false; // seeking always cancels EOS
+
+	switch (whence) {
+	case SEEK_CUR:
+		offset += pos();
+		break;
+	case SEEK_END:
+		offset += _size;
+		break;
+	default:
+		break;
+	}
+
+	// Short forward seeks may land in the block being prefetched
+	if (_prefetching && offset > _bufStart + _bufSize && offset <= _nextStart + _blockSize)
+		nextBlock();
+
+	if (offset >= _bufStart && offset <= _bufStart + _bufSize) {
+		_pos = offset - _bufStart;
+		return true;
+	}
+
+	waitPrefetch();
+	_bufStart = offset;
+	_bufSize = _pos = 0;
+	_parentDone = false;
+	const bool result = _parentStream->seek(offset, SEEK_SET);
+	startPrefetch();
+	return result;
+}
+
+void PrefetchingReadStreamImpl::clearErr() {
+	_eos = false;
+	if (!_parentDone)
+		return;
+
+	// Nothing is being prefetched, retry reading after the current block
+	_err = false;
+	_parentStream->clearErr();
+	_parentStream->seek(_bufStart + _bufSize, SEEK_SET);
+	_parentDone = false;
+	startPrefetch();
+}
+
+} // End of anonymous namespace
+
+PrefetchingReadStream *wrapPrefetchingReadStream(SeekableReadStream *parentStream, uint32 blockSize, DisposeAfterUse::Flag disposeParentStream) {
+	if (parentStream)
+		return new PrefetchingReadStreamImpl(parentStream, blockSize, disposeParentStream);
+	return nullptr;
+}
+
+#pragma mark -
+
+namespace {
+
 /**
  * Wrapper class which adds buffering to any WriteStream.
  */
@@ -33,6 +33,7 @@
 #include "common/str-enc.h"
 #include "common/textconsole.h"
 #include "common/text-to-speech.h"
+#include "common/thread.h"
 
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/fs/fs-factory.h"
@@ -117,11 +118,18 @@ void OSystem::initBackend() {
 // 		error("Backend failed to instantiate fs factory");
 
 	_backendInitialized = true;
+
+	// Create the shared allocator mutex and worker pool while there is
+	// only the main thread
+	Common::SizeClassArena::createMutex();
+	Common::WorkerPool::createInstance();
 }
 
 void OSystem::destroy() {
+	Common::WorkerPool::destroyInstance();
 	_backendInitialized = false;
 	Common::String::releaseMemoryPoolMutex();
+	Common::SizeClassArena::releaseMutex();
 	Common::releaseCJKTables();
 	delete this;
 }
@@ -55,6 +55,8 @@ class Store;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -1598,6 +1600,40 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_thread Worker threads
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Engines must not rely on threads being available, so these are
+	 * optional and only used through Common::WorkerPool, which falls back
+	 * to running its jobs on the calling thread.
+	 */
+
+	/**
+	 * Create a new thread running @p proc with @p param.
+	 *
+	 * @return The newly created thread, or nullptr if the backend does not
+	 *         support threads or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(void (*proc)(void *param), void *param) { return nullptr; }
+
+	/**
+	 * Create a new counting semaphore.
+	 *
+	 * @return The newly created semaphore, or nullptr if the backend does not
+	 *         support threads or an error occurred.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialValue) { return nullptr; }
+
+	/**
+	 * Return the number of logical CPUs worth running worker threads on.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/thread.h"
+#include "common/system.h"
+
+namespace Common {
+
+WorkerPool *WorkerPool::_instance = nullptr;
+
+WorkerPool::JobGroup::JobGroup() : _pending(0), _waiting(false) {
+	assert(g_system);
+	_done = g_system->createSemaphore(0);
+}
+
+WorkerPool::JobGroup::~JobGroup() {
+	assert(_pending == 0);
+	delete _done;
+}
+
+WorkerPool::WorkerPool(uint numThreads) : _jobsAvailable(nullptr), _quit(false) {
+	assert(g_system);
+	if (numThreads)
+		_jobsAvailable = g_system->createSemaphore(0);
+	if (!_jobsAvailable)
+		return;
+
+	for (uint i = 0; i < numThreads; i++) {
+		ThreadInternal *thread = g_system->createThread(workerProc, this);
+		if (!thread)
+			break;
+		_threads.push_back(thread);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	_mutex.lock();
+	_quit = true;
+	_mutex.unlock();
+
+	for (uint i = 0; i < _threads.size(); i++)
+		_jobsAvailable->post();
+	for (uint i = 0; i < _threads.size(); i++)
+		delete _threads[i];
+
+	// Groups still waited for would never complete otherwise
+	while (!_queue.empty()) {
+		runJob(_queue.front());
+		_queue.pop_front();
+	}
+
+	delete _jobsAvailable;
+}
+
+void WorkerPool::createInstance() {
+	if (!_instance)
+		_instance = new WorkerPool(g_system->getCPUCount());
+}
+
+WorkerPool &WorkerPool::instance() {
+	// Without an initialized backend, like in the unit tests, there is no
+	// other thread yet which could race with this
+	if (!_instance) {
+		assert(!g_system->backendInitialized());
+		createInstance();
+	}
+	return *_instance;
+}
+
+void WorkerPool::destroyInstance() {
+	delete _instance;
+	_instance = nullptr;
+}
+
+void WorkerPool::submit(JobGroup &group, JobProc proc, void *param) {
+	Job job;
+	job._proc = proc;
+	job._param = param;
+	job._group = &group;
+
+	_mutex.lock();
+	group._pending++;
+	_queue.push_back(job);
+	_mutex.unlock();
+
+	if (!_threads.empty())
+		_jobsAvailable->post();
+}
+
+bool WorkerPool::isDone(JobGroup &group) {
+	StackLock lock(_mutex);
+	return group._pending == 0;
+}
+
+void WorkerPool::wait(JobGroup &group) {
+	for (;;) {
+		_mutex.lock();
+		if (group._pending == 0) {
+			_mutex.unlock();
+			return;
+		}
+
+		// Rather than waiting for a worker to pick it up, run the next
+		// queued job of the group on this thread
+		List<Job>::iterator it = _queue.begin();
+		while (it != _queue.end() && it->_group != &group)
+			++it;
+		if (it != _queue.end()) {
+			const Job job = *it;
+			_queue.erase(it);
+			_mutex.unlock();
+			runJob(job);
+			continue;
+		}
+
+		// All the remaining jobs of the group are running on workers
+		if (group._done) {
+			group._waiting = true;
+			_mutex.unlock();
+			group._done->wait();
+		} else {
+			_mutex.unlock();
+			g_system->delayMillis(1);
+		}
+	}
+}
+
+void WorkerPool::workerProc(void *param) {
+	((WorkerPool *)param)->runWorker();
+}
+
+void WorkerPool::runWorker() {
+	for (;;) {
+		_jobsAvailable->wait();
+
+		_mutex.lock();
+		if (_queue.empty()) {
+			// The job was run by a waiting thread, or the pool is destroyed
+			const bool quit = _quit;
+			_mutex.unlock();
+			if (quit)
+				return;
+			continue;
+		}
+		const Job job = _queue.front();
+		_queue.pop_front();
+		_mutex.unlock();
+
+		runJob(job);
+	}
+}
+
+void WorkerPool::runJob(const Job &job) {
+	job._proc(job._param);
+
+	StackLock lock(_mutex);
+	JobGroup &group = *job._group;
+	if (--group._pending == 0 && group._waiting) {
+		group._waiting = false;
+		group._done->post();
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,144 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief API for running jobs on backend worker threads.
+ *
+ * Threads are optional: backends which cannot provide them return nullptr
+ * from OSystem::createThread(), in which case WorkerPool runs all its jobs
+ * on the threads waiting for them.
+ * @{
+ */
+
+typedef void (*ThreadProc)(void *param);
+
+/**
+ * A backend thread. Destroying it waits for its procedure to return.
+ */
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+};
+
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	virtual void post() = 0;
+	virtual void wait() = 0;
+};
+
+/**
+ * Pool of worker threads running jobs in submission order.
+ *
+ * Jobs are submitted as part of a JobGroup, which can be waited for. A
+ * thread waiting for a group runs the jobs of that group which did not
+ * start yet itself, so waiting never deadlocks, even without any
+ * worker thread.
+ */
+class WorkerPool : NonCopyable {
+public:
+	typedef void (*JobProc)(void *param);
+
+	/** A set of jobs which can be waited for together. */
+	class JobGroup : NonCopyable {
+		friend class WorkerPool;
+
+		uint _pending;
+		bool _waiting;
+		SemaphoreInternal *_done;
+
+	public:
+		JobGroup();
+		~JobGroup();
+	};
+
+	/**
+	 * Create a pool with up to @p numThreads worker threads. Fewer threads,
+	 * possibly none, are created if the backend does not support them.
+	 */
+	explicit WorkerPool(uint numThreads);
+	~WorkerPool();
+
+	/**
+	 * Create the pool shared by the whole application, which has one
+	 * worker thread per CPU.
+	 *
+	 * This is done by OSystem::initBackend(), on the main thread, before
+	 * any other thread can ask for the pool.
+	 */
+	static void createInstance();
+	static void destroyInstance();
+
+	/** Return the pool shared by the whole application. */
+	static WorkerPool &instance();
+
+	/** Return the number of worker threads, which may be 0. */
+	uint getNumThreads() const { return _threads.size(); }
+
+	/** Queue a call to @p proc with @p param as part of @p group. */
+	void submit(JobGroup &group, JobProc proc, void *param);
+
+	/** Check whether all the jobs of @p group are done, without waiting. */
+	bool isDone(JobGroup &group);
+
+	/** Wait until all the jobs of @p group are done. */
+	void wait(JobGroup &group);
+
+private:
+	struct Job {
+		JobProc _proc;
+		void *_param;
+		JobGroup *_group;
+	};
+
+	static void workerProc(void *param);
+	void runWorker();
+	void runJob(const Job &job);
+
+	Mutex _mutex;
+	List<Job> _queue;
+	SemaphoreInternal *_jobsAvailable;
+	Array<ThreadInternal *> _threads;
+	bool _quit;
+
+	static WorkerPool *_instance;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
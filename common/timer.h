@@ -23,6 +23,7 @@
 #define COMMON_TIMER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/str.h"
 #include "common/noncopyable.h"
 
@@ -41,6 +42,19 @@ class TimerManager : NonCopyable {
 public:
 	typedef void (*TimerProc)(void *refCon); /*!< Type definition of a timer instance. */
 
+	/**
+	 * Scheduling statistics of an installed timer.
+	 */
+	struct TimerStatistics {
+		String id;           /*!< ID the timer was installed with. */
+		int32 interval;      /*!< Requested interval in microseconds. */
+		uint32 calls;        /*!< Number of invocations. */
+		uint32 overruns;     /*!< Invocations later than one full interval. */
+		uint32 maxLatency;   /*!< Highest delay of an invocation in milliseconds. */
+		uint32 totalLatency; /*!< Sum of all invocation delays in milliseconds. */
+		uint32 maxRunTime;   /*!< Longest time spent in the callback in milliseconds. */
+	};
+
 	virtual ~TimerManager() {}
 
 	/**
@@ -69,6 +83,18 @@ public:
 	 * of this callback will be running anymore.
 	 */
 	virtual void removeTimerProc(TimerProc proc) = 0;
+
+	/**
+	 * Retrieve the scheduling statistics of all installed timers.
+	 *
+	 * Timer managers which do not keep statistics return an empty list.
+	 */
+	virtual void getTimerStatistics(Array<TimerStatistics> &stats) { stats.clear(); }
+
+	/**
+	 * Reset the scheduling statistics of all installed timers.
+	 */
+	virtual void resetTimerStatistics() {}
 };
 
 /** @} */
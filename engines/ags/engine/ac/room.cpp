@@ -64,6 +64,7 @@
 #include "ags/engine/script/script.h"
 #include "ags/engine/script/script_runtime.h"
 #include "ags/shared/ac/sprite_cache.h"
+#include "ags/shared/ac/view.h"
 #include "ags/shared/util/stream.h"
 #include "ags/engine/gfx/graphics_driver.h"
 #include "ags/shared/core/asset_manager.h"
@@ -398,6 +399,40 @@ static void reset_temp_room() {
 	_GP(troom) = RoomStatus();
 }
 
+static void add_view_loop_sprites(std::vector<sprkey_t> &sprites, int view, int loop) {
+	const ViewStruct &vs = _GP(views)[view];
+	if (loop < 0 || loop >= vs.numLoops)
+		return;
+	for (int frame = 0; frame < vs.loops[loop].numFrames; ++frame)
+		sprites.push_back(vs.loops[loop].frames[frame].pic);
+}
+
+// Starts loading the sprites of the room's objects and characters in background,
+// so that they don't have to be loaded one by one when the room is first drawn
+static void preload_room_sprites(int newnum) {
+	std::vector<sprkey_t> sprites;
+	for (uint32_t i = 0; i < _G(croom)->numobj; ++i) {
+		const RoomObject &obj = _G(croom)->obj[i];
+		if (!obj.on)
+			continue;
+		sprites.push_back(obj.num);
+		if (obj.view != RoomObject::NoView && obj.view < _GP(game).numviews)
+			add_view_loop_sprites(sprites, obj.view, obj.loop);
+	}
+	for (int i = 0; i < _GP(game).numcharacters; ++i) {
+		const CharacterInfo &chi = _GP(game).chars[i];
+		if (chi.room != newnum || !chi.on || chi.view < 0 || chi.view >= _GP(game).numviews)
+			continue;
+		// the current loop goes first, as it's the one drawn right away
+		add_view_loop_sprites(sprites, chi.view, chi.loop);
+		for (int loop = 0; loop < _GP(views)[chi.view].numLoops; ++loop) {
+			if (loop != chi.loop)
+				add_view_loop_sprites(sprites, chi.view, loop);
+		}
+	}
+	_GP(spriteset).PreloadSprites(sprites);
+}
+
 // forchar = playerchar on NewRoom, or NULL if restore saved game
 void load_new_room(int newnum, CharacterInfo *forchar) {
 
@@ -661,6 +696,9 @@ void load_new_room(int newnum, CharacterInfo *forchar) {
 			StopMoving(cc);
 	}
 
+	// The sprites get unpacked while the rest of the room is being set up
+	preload_room_sprites(newnum);
+
 	_G(roominst) = nullptr;
 	if (_G(debug_flags) & DBG_NOSCRIPT) ;
 	else if (_GP(thisroom).CompiledScript != nullptr) {
@@ -259,6 +259,9 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	code_ops            = nullptr;
+	code_args           = nullptr;
+	code_op_index       = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -464,88 +467,101 @@ int ccInstance::Run(int32_t curpc) {
 		if (_G(abort_engine))
 			return -1;
 
-		/*
-		if (!codeInst->ReadOperation(codeOp, pc))
-		{
-		    return -1;
-		}
-		*/
-		/* ReadOperation */
-		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
-			cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-			return -1;
-		}
+		// Most of the operations were decoded in advance, with the arguments
+		// resolved; only the stack offsets depend on the current state
+		const RuntimeScriptValue *opArgs = codeOp.Args;
+		const ScriptCodeOperation *preOp = codeInst->GetCodeOperation(pc);
+		if (preOp) {
+			codeOp.Instruction = preOp->Instruction;
+			codeOp.ArgCount = preOp->ArgCount;
+			opArgs = &codeInst->code_args[preOp->ArgIndex];
+			if (preOp->StackArgs != 0 || write_debug_dump) {
+				for (int i = 0; i < codeOp.ArgCount; ++i) {
+					if (preOp->StackArgs & (1 << i))
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc + 1 + i]);
+					else
+						codeOp.Args[i] = opArgs[i];
+				}
+				opArgs = codeOp.Args;
+			}
+		} else {
+			/* ReadOperation */
+			//=====================================================================
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+			if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
+				cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+				return -1;
+			}
 
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
-		if (pc + codeOp.ArgCount >= codeInst->codesize) {
-			cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-			return -1;
-		}
+			codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+			if (pc + codeOp.ArgCount >= codeInst->codesize) {
+				cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+				return -1;
+			}
 
-		int pc_at = pc + 1;
-		for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
-			char fixup = codeInst->code_fixups[pc_at];
-			if (fixup > 0) {
-				// could be relative pointer or import address
-				/*
-				if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-				{
-				    return -1;
-				}
-				*/
-				/* FixupArgument */
-				//=====================================================================
-				switch (fixup) {
-				case FIXUP_GLOBALDATA: {
-					ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
-					codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
-				}
-				break;
-				case FIXUP_FUNCTION:
-					// originally commented -- CHECKME: could this be used in very old versions of AGS?
-					//      code[fixup] += (long)&code[0];
-					// This is a program counter value, presumably will be used as SCMD_CALL argument
-					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+			int pc_at = pc + 1;
+			for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+				char fixup = codeInst->code_fixups[pc_at];
+				if (fixup > 0) {
+					// could be relative pointer or import address
+					/*
+					if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+					{
+					    return -1;
+					}
+					*/
+					/* FixupArgument */
+					//=====================================================================
+					switch (fixup) {
+					case FIXUP_GLOBALDATA: {
+						ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
+						codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+					}
 					break;
-				case FIXUP_STRING:
-					codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+					case FIXUP_FUNCTION:
+						// originally commented -- CHECKME: could this be used in very old versions of AGS?
+						//      code[fixup] += (long)&code[0];
+						// This is a program counter value, presumably will be used as SCMD_CALL argument
+						codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+						break;
+					case FIXUP_STRING:
+						codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+						break;
+					case FIXUP_IMPORT: {
+						const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+							return -1;
+						}
+					}
 					break;
-				case FIXUP_IMPORT: {
-					const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
-					if (import) {
-						codeOp.Args[i] = import->Value;
-					} else {
-						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+					case FIXUP_STACK:
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+						break;
+					default:
+						cc_error("internal fixup type error: %d", fixup);
 						return -1;
 					}
+					/* End FixupArgument */
+					//=====================================================================
+				} else {
+					// should be a numeric literal (int32 or float)
+					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 				}
-				break;
-				case FIXUP_STACK:
-					codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-					break;
-				default:
-					cc_error("internal fixup type error: %d", fixup);
-					return -1;
-				}
-				/* End FixupArgument */
-				//=====================================================================
-			} else {
-				// should be a numeric literal (int32 or float)
-				codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 			}
+			/* End ReadOperation */
+			//=====================================================================
 		}
-		/* End ReadOperation */
-		//=====================================================================
 
 		// save the arguments for quick access
-		RuntimeScriptValue &arg1 = codeOp.Args[0];
-		RuntimeScriptValue &arg2 = codeOp.Args[1];
-		RuntimeScriptValue &arg3 = codeOp.Args[2];
+		const RuntimeScriptValue &arg1 = opArgs[0];
+		const RuntimeScriptValue &arg2 = opArgs[1];
+		const RuntimeScriptValue &arg3 = opArgs[2];
 		RuntimeScriptValue &reg1 =
 		    registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
 		RuntimeScriptValue &reg2 =
@@ -1431,6 +1447,9 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		code_ops = joined->code_ops;
+		code_args = joined->code_args;
+		code_op_index = joined->code_op_index;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1513,9 +1532,13 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete[] resolved_imports;
 		delete[] code_fixups;
+		FreeCodeOperations();
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	code_ops = nullptr;
+	code_args = nullptr;
+	code_op_index = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1726,9 +1749,105 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
 	}
+
+	// The code is final now, decode it once instead of on every step
+	CreateCodeOperations();
 	return true;
 }
 
+void ccInstance::CreateCodeOperations() {
+	if ((flags & INSTF_SHAREDATA) != 0)
+		return; // uses the operations of the instance it was forked from
+	FreeCodeOperations();
+	if (codesize <= 0)
+		return;
+
+	// The bytecode is a plain sequence of operations, so it may be walked
+	// through linearly; anything that fails to decode here is left for Run()
+	// to decode at runtime, which also reports the errors as it used to.
+	int32_t num_ops = 0;
+	int32_t num_args = 0;
+	for (int32_t at_pc = 0; at_pc < codesize;) {
+		const int32_t instr = (int32_t)(code[at_pc] & INSTANCE_ID_REMOVEMASK);
+		if (instr < 0 || instr >= CC_NUM_SCCMDS)
+			break;
+		const int32_t arg_count = (*g_commands)[instr].ArgCount;
+		if (at_pc + arg_count >= codesize)
+			break;
+		num_ops++;
+		num_args += arg_count;
+		at_pc += arg_count + 1;
+	}
+
+	code_ops = new ScriptCodeOperation[num_ops];
+	// Run() always takes references to MAX_SCMD_ARGS arguments, so pad the end
+	code_args = new RuntimeScriptValue[num_args + MAX_SCMD_ARGS];
+	code_op_index = new int32_t[codesize]();
+
+	int32_t op_index = 0;
+	int32_t arg_index = 0;
+	for (int32_t at_pc = 0; op_index < num_ops;) {
+		ScriptCodeOperation &op = code_ops[op_index];
+		op.Instruction.Code = code[at_pc];
+		op.Instruction.InstanceId = (op.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+		op.Instruction.Code &= INSTANCE_ID_REMOVEMASK;
+		op.ArgCount = (*g_commands)[op.Instruction.Code].ArgCount;
+		op.ArgIndex = arg_index;
+		op.StackArgs = 0;
+
+		bool resolved = true;
+		for (int i = 0; i < op.ArgCount; ++i) {
+			const int32_t arg_pc = at_pc + 1 + i;
+			RuntimeScriptValue &arg = code_args[arg_index + i];
+			switch (code_fixups[arg_pc]) {
+			case 0:
+				// should be a numeric literal (int32 or float)
+				arg.SetInt32((int32_t)code[arg_pc]);
+				break;
+			case FIXUP_GLOBALDATA:
+				arg.SetGlobalVar(&((ScriptVariable *)code[arg_pc])->RValue);
+				break;
+			case FIXUP_FUNCTION:
+				arg.SetInt32((int32_t)code[arg_pc]);
+				break;
+			case FIXUP_STRING:
+				arg.SetStringLiteral(&strings[0] + code[arg_pc]);
+				break;
+			case FIXUP_IMPORT: {
+				// imports were resolved just before, and stay for the instance's lifetime
+				const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(code[arg_pc]));
+				if (import)
+					arg = import->Value;
+				else
+					resolved = false;
+			}
+			break;
+			case FIXUP_STACK:
+				op.StackArgs |= 1 << i;
+				break;
+			default:
+				resolved = false;
+				break;
+			}
+		}
+
+		if (resolved)
+			code_op_index[at_pc] = op_index + 1;
+		op_index++;
+		arg_index += op.ArgCount;
+		at_pc += op.ArgCount + 1;
+	}
+}
+
+void ccInstance::FreeCodeOperations() {
+	delete[] code_ops;
+	delete[] code_args;
+	delete[] code_op_index;
+	code_ops = nullptr;
+	code_args = nullptr;
+	code_op_index = nullptr;
+}
+
 /*
 bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 {
@@ -69,6 +69,22 @@ struct ScriptOperation {
 	int                 ArgCount;
 };
 
+// Operation decoded in advance, after the script's code was fixed up;
+// its resolved arguments are stored in ccInstance::code_args at ArgIndex
+struct ScriptCodeOperation {
+	ScriptCodeOperation() {
+		ArgCount = 0;
+		ArgIndex = 0;
+		StackArgs = 0;
+	}
+
+	ScriptInstruction   Instruction;
+	int32_t             ArgCount;
+	int32_t             ArgIndex;
+	// bitmask of arguments pointing to the stack, these are resolved when run
+	int32_t             StackArgs;
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -140,6 +156,12 @@ public:
 
 	char *code_fixups;
 
+	// operations pre-decoded from the code, shared with the forked instances
+	ScriptCodeOperation *code_ops;
+	RuntimeScriptValue *code_args;
+	// index of the pre-decoded operation + 1 for each code position, 0 if none
+	int32_t *code_op_index;
+
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
 	// clears recorded stack of current instances
@@ -182,6 +204,7 @@ public:
 
 	// Using resolved_imports[], resolve the IMPORT fixups
 	// Also change CALLEXT op-codes to CALLAS when they pertain to a script instance
+	// and pre-decode the operations for Run()
 	bool    ResolveImportFixups(const ccScript *scri);
 
 private:
@@ -193,6 +216,14 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decode the fixed up code into operations with resolved arguments;
+	// must be done after all the fixups were applied
+	void    CreateCodeOperations();
+	void    FreeCodeOperations();
+	inline const ScriptCodeOperation *GetCodeOperation(int32_t at_pc) const {
+		const int32_t index = code_op_index ? code_op_index[at_pc] : 0;
+		return index > 0 ? &code_ops[index - 1] : nullptr;
+	}
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
 	// Begin executing script starting from the given bytecode index
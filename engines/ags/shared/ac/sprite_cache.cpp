@@ -26,6 +26,7 @@
 //=============================================================================
 
 #include "common/system.h"
+#include "common/thread.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/util/stream.h"
 #include "ags/lib/std/algorithm.h"
@@ -62,7 +63,8 @@ namespace Shared {
 
 SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos)
 	: _sprInfos(sprInfos), _maxCacheSize(DEFAULTCACHESIZE_KB * 1024u),
-	_cacheSize(0u), _lockedSize(0u) {
+	_cacheSize(0u), _lockedSize(0u), _mruFirst(-1), _mruLast(-1), _mruCount(0u),
+	_preloadSize(0u) {
 }
 
 SpriteCache::~SpriteCache() {
@@ -90,7 +92,12 @@ void SpriteCache::SetMaxCacheSize(size_t size) {
 	_maxCacheSize = size;
 }
 
+void SpriteCache::ResetStats() {
+	_stats = SpriteCacheStats();
+}
+
 void SpriteCache::Reset() {
+	CancelPreloads();
 	_file.Close();
 	// TODO: find out if it's safe to simply always delete _spriteData.Image with array element
 	for (size_t i = 0; i < _spriteData.size(); ++i) {
@@ -100,7 +107,8 @@ void SpriteCache::Reset() {
 		}
 	}
 	_spriteData.clear();
-	_mru.clear();
+	_mruFirst = _mruLast = -1;
+	_mruCount = 0;
 	_cacheSize = 0;
 	_lockedSize = 0;
 }
@@ -114,6 +122,7 @@ bool SpriteCache::SetSprite(sprkey_t index, Bitmap *sprite, int flags) {
 		Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SetSprite: attempt to assign nullptr to index %d", index);
 		return false;
 	}
+	CancelPreload(index);
 	_spriteData[index].Image = sprite;
 	_spriteData[index].Flags = SPRCACHEFLAG_LOCKED; // NOT from asset file
 	_spriteData[index].Size = 0;
@@ -129,6 +138,7 @@ void SpriteCache::SetEmptySprite(sprkey_t index, bool as_asset) {
 		Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SetEmptySprite: unable to use index %d", index);
 		return;
 	}
+	CancelPreload(index);
 	if (as_asset)
 		_spriteData[index].Flags = SPRCACHEFLAG_ISASSET;
 	RemapSpriteToSprite0(index);
@@ -147,6 +157,8 @@ void SpriteCache::RemoveSprite(sprkey_t index, bool freeMemory) {
 	if (index < 0 || (size_t)index >= _spriteData.size())
 		return;
 
+	CancelPreload(index);
+	RemoveFromMRU(index);
 	if (freeMemory)
 		delete _spriteData[index].Image;
 	InitNullSpriteParams(index);
@@ -169,6 +181,7 @@ sprkey_t SpriteCache::GetFreeIndex() {
 	for (size_t i = MIN_SPRITE_INDEX; i < _spriteData.size(); ++i) {
 		// slot empty
 		if (!DoesSpriteExist(i)) {
+			RemoveFromMRU(i);
 			_sprInfos[i] = SpriteInfo();
 			_spriteData[i] = SpriteData();
 			return i;
@@ -212,17 +225,61 @@ Bitmap *SpriteCache::operator [] (sprkey_t index) {
 
 	if (_spriteData[index].Image) {
 		// Move to the beginning of the MRU list
-		_mru.splice(_mru.begin(), _mru, _spriteData[index].MruIt);
+		_stats.Hits++;
+		RemoveFromMRU(index);
 	} else {
 		// Sprite exists in file but is not in mem, load it
 		LoadSprite(index);
-		_spriteData[index].MruIt = _mru.insert(_mru.begin(), index);
 	}
+	AddToMRU(index);
 	return _spriteData[index].Image;
 }
 
+bool SpriteCache::IsInMRU(sprkey_t index) const {
+	return _spriteData[index].MruPrev >= 0 || _mruFirst == index;
+}
+
+void SpriteCache::AddToMRU(sprkey_t index) {
+	assert(!IsInMRU(index));
+	SpriteData &spr = _spriteData[index];
+	spr.MruPrev = -1;
+	spr.MruNext = _mruFirst;
+	if (_mruFirst >= 0)
+		_spriteData[_mruFirst].MruPrev = index;
+	else
+		_mruLast = index;
+	_mruFirst = index;
+	_mruCount++;
+}
+
+void SpriteCache::RemoveFromMRU(sprkey_t index) {
+	if (!IsInMRU(index))
+		return;
+	SpriteData &spr = _spriteData[index];
+	if (spr.MruPrev >= 0)
+		_spriteData[spr.MruPrev].MruNext = spr.MruNext;
+	else
+		_mruFirst = spr.MruNext;
+	if (spr.MruNext >= 0)
+		_spriteData[spr.MruNext].MruPrev = spr.MruPrev;
+	else
+		_mruLast = spr.MruPrev;
+	spr.MruPrev = spr.MruNext = -1;
+	_mruCount--;
+}
+
+void SpriteCache::ClearMRU() {
+	for (sprkey_t index = _mruFirst; index >= 0;) {
+		SpriteData &spr = _spriteData[index];
+		index = spr.MruNext;
+		spr.MruPrev = spr.MruNext = -1;
+	}
+	_mruFirst = _mruLast = -1;
+	_mruCount = 0;
+}
+
 void SpriteCache::FreeMem(size_t space) {
-	for (int tries = 0; (_mru.size() > 0) && (_cacheSize >= (_maxCacheSize - space)); ++tries) {
+	for (int tries = 0; (_mruCount > 0) && (_cacheSize >= (_maxCacheSize - space)); ++tries) {
 		DisposeOldest();
 		if (tries > 1000) { // ???
 			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "RUNTIME CACHE ERROR: STUCK IN FREE_UP_MEM; RESETTING CACHE");
@@ -232,11 +289,10 @@ void SpriteCache::FreeMem(size_t space) {
 }
 
 void SpriteCache::DisposeOldest() {
-	assert(_mru.size() > 0);
-	if (_mru.size() == 0)
+	assert(_mruCount > 0);
+	if (_mruCount == 0)
 		return;
-	auto it = std::prev(_mru.end());
-	const auto sprnum = *it;
+	const sprkey_t sprnum = _mruLast;
 	// Safety check: must be a sprite from resources
 	// TODO: compare with latest upstream
 	// Commented out the assertion, since it triggers for sprites that are in the list but remapped to the placeholder (sprite 0)
@@ -247,28 +303,24 @@ void SpriteCache::DisposeOldest() {
 	if (!_spriteData[sprnum].IsAssetSprite()) {
 		if (!(_spriteData[sprnum].Flags & SPRCACHEFLAG_REMAPPED))
 			Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Error, "SpriteCache::DisposeOldest: in MRU list sprite %d is external or does not exist", sprnum);
-		_mru.erase(it);
-		// std::list::erase() invalidates iterators to the erased item.
-		// But our implementation does not.
-		_spriteData[sprnum].MruIt._node = nullptr;
+		RemoveFromMRU(sprnum);
 		return;
 	}
 	// Delete the image, unless is locked
 	// NOTE: locked sprites may still occur in MRU list
 	if (!_spriteData[sprnum].IsLocked()) {
 		_cacheSize -= _spriteData[sprnum].Size;
-		delete _spriteData[*it].Image;
+		delete _spriteData[sprnum].Image;
 		_spriteData[sprnum].Image = nullptr;
+		_stats.Disposals++;
 		SprCacheLog("DisposeOldest: disposed %d, size now %d KB", sprnum, _cacheSize / 1024);
 	}
 	// Remove from the mru list
-	_mru.erase(it);
-	// std::list::erase() invalidates iterators to the erased item.
-	// But our implementation does not.
-	_spriteData[sprnum].MruIt._node = nullptr;
+	RemoveFromMRU(sprnum);
 }
 
 void SpriteCache::DisposeAll() {
+	CancelPreloads();
 	for (size_t i = 0; i < _spriteData.size(); ++i) {
 		if (!_spriteData[i].IsLocked() && // not locked
 			_spriteData[i].IsAssetSprite()) // sprite from game resource
@@ -278,7 +330,7 @@ void SpriteCache::DisposeAll() {
 		}
 	}
 	_cacheSize = _lockedSize;
-	_mru.clear();
+	ClearMRU();
 }
 
 void SpriteCache::Precache(sprkey_t index) {
@@ -294,10 +346,7 @@ void SpriteCache::Precache(sprkey_t index) {
 	} else if (!_spriteData[index].IsLocked()) {
 		sprSize = _spriteData[index].Size;
 		// Remove locked sprite from the MRU list
-		_mru.erase(_spriteData[index].MruIt);
-		// std::list::erase() invalidates iterators to the erased item.
-		// But our implementation does not.
-		_spriteData[index].MruIt._node = nullptr;
+		RemoveFromMRU(index);
 	}
 
 	// make sure locked sprites can't fill the cache
@@ -316,9 +365,17 @@ size_t SpriteCache::LoadSprite(sprkey_t index) {
 	if (index < 0 || (size_t)index >= _spriteData.size())
 		return 0;
 
-	sprkey_t load_index = GetDataIndex(index);
-	Bitmap *image;
-	HError err = _file.LoadSprite(load_index, image);
+	Bitmap *image = nullptr;
+	HError err = HError::None();
+	if (_spriteData[index].Preload)
+		image = FinishPreload(index);
+	if (image) {
+		_stats.PreloadHits++;
+	} else {
+		_stats.Misses++;
+		sprkey_t load_index = GetDataIndex(index);
+		err = _file.LoadSprite(load_index, image);
+	}
 	if (!image) {
 		Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn,
 			"LoadSprite: failed to load sprite %d:\n%s\n - remapping to sprite 0.", index,
@@ -326,7 +383,10 @@ size_t SpriteCache::LoadSprite(sprkey_t index) {
 		RemapSpriteToSprite0(index);
 		return 0;
 	}
+	return InitLoadedSprite(index, image);
+}
 
+size_t SpriteCache::InitLoadedSprite(sprkey_t index, Bitmap *image) {
 	// update the stored width/height
 	_sprInfos[index].Width = image->GetWidth();
 	_sprInfos[index].Height = image->GetHeight();
@@ -351,10 +411,122 @@ size_t SpriteCache::LoadSprite(sprkey_t index) {
 	FreeMem(size);
 	_spriteData[index].Size = size;
 	_cacheSize += size;
+	_stats.LoadedBytes += size;
 	SprCacheLog("Loaded %d, size now %zu KB", index, _cacheSize / 1024);
 	return size;
 }
 
+struct SpriteCache::PreloadJob {
+	Common::WorkerPool::JobGroup Group;
+	const SpriteFile *File = nullptr;
+	sprkey_t Index = 0;
+	SpriteDatHeader Header;
+	std::vector<uint8_t> Data;
+	Bitmap *Image = nullptr;
+	size_t Size = 0;
+	bool Success = false;
+};
+
+void SpriteCache::RunPreload(void *param) {
+	PreloadJob *job = (PreloadJob *)param;
+	HError err = job->File->UnpackRawData(job->Index, job->Header, job->Data, job->Image);
+	job->Success = (bool)err;
+}
+
+void SpriteCache::PreloadSprites(const std::vector<sprkey_t> &indexes) {
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+	if (pool.getNumThreads() == 0)
+		return; // unpacking on demand is just as fast then
+
+	FinishPreloads(false);
+	for (const sprkey_t index : indexes) {
+		if (index <= 0 || (size_t)index >= _spriteData.size())
+			continue;
+		const SpriteData &spr = _spriteData[index];
+		if (!spr.IsAssetSprite() || spr.Image || spr.Preload ||
+				(spr.Flags & SPRCACHEFLAG_REMAPPED) != 0)
+			continue;
+
+		// The sprite file is not thread-safe, so the data is read here,
+		// and only unpacking is left to the worker threads.
+		// Any errors are left to report for the regular loading.
+		PreloadJob *job = new PreloadJob();
+		HError err = _file.LoadRawData(index, job->Header, job->Data);
+		const SpriteDatHeader &hdr = job->Header;
+		job->Size = hdr.Width * hdr.Height * hdr.BPP;
+		if (!err || hdr.BPP == 0 || job->Data.empty()) {
+			delete job;
+			continue;
+		}
+		if (_cacheSize + _preloadSize + job->Size >= _maxCacheSize) {
+			delete job;
+			break; // no more room for the sprites
+		}
+		job->Image = BitmapHelper::CreateBitmap(hdr.Width, hdr.Height, hdr.BPP * 8);
+		if (!job->Image) {
+			delete job;
+			continue;
+		}
+		job->File = &_file;
+		job->Index = index;
+
+		_spriteData[index].Preload = job;
+		_preloads.push_back(index);
+		_preloadSize += job->Size;
+		_stats.Preloads++;
+		pool.submit(job->Group, RunPreload, job);
+	}
+	SprCacheLog("PreloadSprites: %zu pending, %zu KB", _preloads.size(), _preloadSize / 1024);
+}
+
+void SpriteCache::FinishPreloads(bool wait) {
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+	for (size_t i = 0; i < _preloads.size();) {
+		const sprkey_t index = _preloads[i];
+		if (!wait && !pool.isDone(_spriteData[index].Preload->Group)) {
+			++i;
+			continue;
+		}
+		// This removes the sprite from the pending list
+		LoadSprite(index);
+		if (!_spriteData[index].IsLocked() && !IsInMRU(index))
+			AddToMRU(index);
+	}
+}
+
+Bitmap *SpriteCache::FinishPreload(sprkey_t index) {
+	PreloadJob *job = _spriteData[index].Preload;
+	Common::WorkerPool::instance().wait(job->Group);
+	_spriteData[index].Preload = nullptr;
+	for (size_t i = 0; i < _preloads.size(); ++i) {
+		if (_preloads[i] == index) {
+			_preloads[i] = _preloads.back();
+			_preloads.pop_back();
+			break;
+		}
+	}
+	_preloadSize -= job->Size;
+
+	Bitmap *image = job->Image;
+	if (!job->Success) {
+		delete image;
+		image = nullptr;
+	}
+	delete job;
+	return image;
+}
+
+void SpriteCache::CancelPreload(sprkey_t index) {
+	if (index >= 0 && (size_t)index < _spriteData.size() && _spriteData[index].Preload)
+		delete FinishPreload(index);
+}
+
+void SpriteCache::CancelPreloads() {
+	while (!_preloads.empty())
+		CancelPreload(_preloads.back());
+}
+
+
 void SpriteCache::RemapSpriteToSprite0(sprkey_t index) {
 	_sprInfos[index].Flags = _sprInfos[0].Flags;
 	_sprInfos[index].Width = _sprInfos[0].Width;
@@ -391,7 +563,6 @@ HError SpriteCache::InitFile(const String &filename, const String &sprindex_file
 	size_t newsize = metrics.size();
 	_sprInfos.resize(newsize);
 	_spriteData.resize(newsize);
-	_mru.clear();
 	for (size_t i = 0; i < metrics.size(); ++i) {
 		if (!metrics[i].IsNull()) {
 			// Existing sprite
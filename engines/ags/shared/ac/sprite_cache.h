@@ -24,7 +24,10 @@
 //
 // SpriteFile handles sprite serialization and streaming.
 // SpriteCache provides bitmaps by demand; it uses SpriteFile to load sprites
-// and does MRU (most-recent-use) caching.
+// and does MRU (most-recent-use) caching. Sprites which are going to be needed
+// soon may be preloaded: their data is read from the file right away, but it
+// is unpacked on the worker threads, and only handed over to the cache when
+// the sprite is requested.
 //
 // TODO: store sprite data in a specialized container type that is optimized
 // for having most keys allocated in large continious sequences by default.
@@ -43,7 +46,6 @@
 
 #include "ags/lib/std/memory.h"
 #include "ags/lib/std/vector.h"
-#include "ags/lib/std/list.h"
 #include "ags/shared/ac/sprite_file.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/util/error.h"
@@ -83,6 +85,16 @@ struct SpriteInfo;
 namespace AGS {
 namespace Shared {
 
+// Usage counters of the sprite cache
+struct SpriteCacheStats {
+	uint32_t Hits = 0;          // requests for the sprites found in the cache
+	uint32_t Misses = 0;        // requests which had to load a sprite
+	uint32_t Preloads = 0;      // sprites queued for loading in background
+	uint32_t PreloadHits = 0;   // requests served with a preloaded sprite
+	uint32_t Disposals = 0;     // sprites disposed to free cache space
+	uint64_t LoadedBytes = 0;   // size of all the sprites put into the cache
+};
+
 class SpriteCache {
 public:
 	static const sprkey_t MIN_SPRITE_INDEX = 1; // 0 is reserved for "empty sprite"
@@ -124,6 +136,17 @@ public:
 	size_t      GetSpriteSlotCount() const;
 	// Loads sprite and and locks in memory (so it cannot get removed implicitly)
 	void        Precache(sprkey_t index);
+	// Starts loading the given sprites in background, as long as they fit
+	// into the free cache space; does nothing if there are no worker threads
+	void        PreloadSprites(const std::vector<sprkey_t> &indexes);
+	// Hands the preloaded sprites over to the cache; optionally waits for the
+	// ones which are still being unpacked, otherwise leaves them pending
+	void        FinishPreloads(bool wait);
+	// Returns the usage counters
+	const SpriteCacheStats &GetStats() const {
+		return _stats;
+	}
+	void        ResetStats();
 	// Remap the given index to the sprite 0
 	void        RemapSpriteToSprite0(sprkey_t index);
 	// Unregisters sprite from the bank and optionally deletes bitmap
@@ -150,6 +173,15 @@ public:
 private:
 	// Load sprite from game resource
 	size_t      LoadSprite(sprkey_t index);
+	// Sets up the newly loaded image and accounts it in the cache size
+	size_t      InitLoadedSprite(sprkey_t index, Bitmap *image);
+	// Waits for the sprite's preload to finish, returns its image on success
+	Bitmap     *FinishPreload(sprkey_t index);
+	// Waits for the sprite's preload to finish, and discards it
+	void        CancelPreload(sprkey_t index);
+	void        CancelPreloads();
+	// Unpacks the preloaded sprite, run on a worker thread
+	static void RunPreload(void *param);
 	// Gets the index of a sprite which data is used for the given slot;
 	// in case of remapped sprite this will return the one given sprite is remapped to
 	sprkey_t    GetDataIndex(sprkey_t index);
@@ -157,6 +189,14 @@ private:
 	void        DisposeOldest();
 	// Keep disposing oldest elements until cache has at least the given free space
 	void        FreeMem(size_t space);
+	// MRU list operations
+	bool        IsInMRU(sprkey_t index) const;
+	void        AddToMRU(sprkey_t index);
+	void        RemoveFromMRU(sprkey_t index);
+	void        ClearMRU();
+
+	// Sprite loading in background
+	struct PreloadJob;
 
 	// Information required for the sprite streaming
 	struct SpriteData {
@@ -165,8 +205,11 @@ private:
 		// TODO: investigate if we may safely use unique_ptr here
 		// (some of these bitmaps may be assigned from outside of the cache)
 		Shared::Bitmap *Image = nullptr; // actual bitmap
-		// MRU list reference
-		std::list<sprkey_t>::iterator MruIt;
+		// MRU list links, -1 if none
+		sprkey_t MruPrev = -1;
+		sprkey_t MruNext = -1;
+		// Pending preload, if any
+		PreloadJob *Preload = nullptr;
 
 		// Tells if there actually is a registered sprite in this slot
 		bool DoesSpriteExist() const;
@@ -191,8 +234,17 @@ private:
 
 	// MRU list: the way to track which sprites were used recently.
 	// When clearing up space for new sprites, cache first deletes the sprites
-	// that were last time used long ago.
-	std::list<sprkey_t> _mru;
+	// that were last time used long ago. The list is linked through the sprite
+	// slots, so that touching and disposing a sprite is done in constant time.
+	sprkey_t _mruFirst; // most recently used
+	sprkey_t _mruLast;  // least recently used
+	size_t   _mruCount;
+
+	// Sprites being preloaded, and the size their images will take
+	std::vector<sprkey_t> _preloads;
+	size_t _preloadSize;
+
+	SpriteCacheStats _stats;
 
 	// Initialize the empty sprite slot
 	void        InitNullSpriteParams(sprkey_t index);
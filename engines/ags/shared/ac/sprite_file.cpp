@@ -376,6 +376,25 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 		return new Error(String::FromFormat("LoadSprite: failed to allocate bitmap %d (%dx%d%d).",
 			index, w, h, bpp * 8));
 	}
+	HError err = ReadSpriteData(index, hdr, _stream.get(), image);
+	if (!err) {
+		delete image;
+		return err;
+	}
+
+	sprite = image;
+	_curPos = index + 1; // mark correct pos
+	return HError::None();
+}
+
+HError SpriteFile::UnpackRawData(sprkey_t index, const SpriteDatHeader &hdr,
+		const std::vector<uint8_t> &data, Bitmap *image) const {
+	MemoryStream in(data.data(), data.size());
+	return ReadSpriteData(index, hdr, &in, image);
+}
+
+HError SpriteFile::ReadSpriteData(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, Bitmap *image) const {
+	int bpp = hdr.BPP, w = hdr.Width, h = hdr.Height;
 	ImBufferPtr im_data(image->GetDataForWriting(), w * h * bpp, bpp);
 	// (Optional) Handle storage options, reverse
 	std::vector<uint8_t> indexed_buf;
@@ -384,11 +403,11 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	if (pal_bpp > 0) { // read palette if format assumes one
 		switch (pal_bpp) {
 		case 2: for (uint32_t i = 0; i < hdr.PalCount; ++i) {
-			palette[i] = _stream->ReadInt16();
+			palette[i] = in->ReadInt16();
 		}
 			  break;
 		case 4: for (uint32_t i = 0; i < hdr.PalCount; ++i) {
-			palette[i] = _stream->ReadInt32();
+			palette[i] = in->ReadInt32();
 		}
 			  break;
 		default: assert(0); break;
@@ -399,16 +418,15 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	// (Optional) Decompress the image data into the temp buffer
 	size_t in_data_size =
 		((_version >= kSprfVersion_StorageFormats) || _compress != kSprCompress_None) ?
-		(uint32_t)_stream->ReadInt32() : (w * h * bpp);
+		(uint32_t)in->ReadInt32() : (w * h * bpp);
 	if (hdr.Compress != kSprCompress_None) {
 		if (in_data_size == 0) {
-			delete image;
 			return new Error(String::FromFormat("LoadSprite: bad compressed data for sprite %d.", index));
 		}
 		switch (hdr.Compress) {
-		case kSprCompress_RLE: rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get());
+		case kSprCompress_RLE: rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, in);
 			break;
-		case kSprCompress_LZW: lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+		case kSprCompress_LZW: lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
 			break;
 		default: assert(!"Unsupported compression type!"); break;
 		}
@@ -417,12 +435,12 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 	// Otherwise (no compression) read directly
 	else {
 		switch (im_data.BPP) {
-		case 1: _stream->Read(im_data.Buf, im_data.Size);
+		case 1: in->Read(im_data.Buf, im_data.Size);
 			break;
-		case 2: _stream->ReadArrayOfInt16(
+		case 2: in->ReadArrayOfInt16(
 			reinterpret_cast<int16_t *>(im_data.Buf), im_data.Size / sizeof(int16_t));
 			break;
-		case 4: _stream->ReadArrayOfInt32(
+		case 4: in->ReadArrayOfInt32(
 			reinterpret_cast<int32_t *>(im_data.Buf), im_data.Size / sizeof(int32_t));
 			break;
 		default: assert(0); break;
@@ -433,8 +451,6 @@ HError SpriteFile::LoadSprite(sprkey_t index, Shared::Bitmap *&sprite) {
 		UnpackIndexedBitmap(image, im_data.Buf, im_data.Size, palette, hdr.PalCount);
 	}
 
-	sprite = image;
-	_curPos = index + 1; // mark correct pos
 	return HError::None();
 }
 
@@ -153,10 +153,17 @@ public:
 	HError      LoadSprite(sprkey_t index, Bitmap *&sprite);
 	// Loads a raw sprite element data into the buffer, stores header info separately
 	HError      LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data);
+	// Unpacks the raw data read by LoadRawData into the bitmap created for
+	// the header's size and color depth; does not use the sprite stream,
+	// so may be called from a worker thread while the file stays open
+	HError      UnpackRawData(sprkey_t index, const SpriteDatHeader &hdr,
+		const std::vector<uint8_t> &data, Bitmap *image) const;
 
 private:
 	// Seek stream to sprite
 	void        SeekToSprite(sprkey_t index);
+	// Reads the sprite's data following its header into the bitmap
+	HError      ReadSpriteData(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, Bitmap *image) const;
 
 	// Internal sprite reference
 	struct SpriteRef {
@@ -206,8 +206,9 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz) {
 	if (dst_sz == 0)
 		return false; // nowhere to expand to
 
-	_G(lzbuffer) = (uint8_t *)malloc(N);
-	if (_G(lzbuffer) == nullptr) {
+	// NOTE: this uses a local buffer, as sprites may be expanded on worker threads
+	uint8_t *lzbuffer = (uint8_t *)malloc(N);
+	if (lzbuffer == nullptr) {
 		return false;  // not enough memory
 	}
 	i = N - F;
@@ -233,13 +234,13 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz) {
 					break; // not enough dest buffer
 
 				while (len--) {
-					*(dst_ptr++) = (_G(lzbuffer)[i] = _G(lzbuffer)[j]);
+					*(dst_ptr++) = (lzbuffer[i] = lzbuffer[j]);
 					j = (j + 1) & (N - 1);
 					i = (i + 1) & (N - 1);
 				}
 			} else {
 				ch = *(src_ptr++);
-				*(dst_ptr++) = (_G(lzbuffer)[i] = static_cast<uint8_t>(ch));
+				*(dst_ptr++) = (lzbuffer[i] = static_cast<uint8_t>(ch));
 				i = (i + 1) & (N - 1);
 			}
 
@@ -251,7 +252,7 @@ bool lzwexpand(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz) {
 
 	}
 
-	free(_G(lzbuffer));
+	free(lzbuffer);
 	return static_cast<size_t>(src_ptr - src) == src_sz;
 }
 
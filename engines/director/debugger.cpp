@@ -109,6 +109,7 @@ Debugger::Debugger(): GUI::Debugger() {
 
 	registerCmd("draw", WRAP_METHOD(Debugger, cmdDraw));
 	registerCmd("forceredraw", WRAP_METHOD(Debugger, cmdForceRedraw));
+	registerCmd("renderstats", WRAP_METHOD(Debugger, cmdRenderStats));
 
 	_nextFrame = false;
 	_nextFrameCounter = 0;
@@ -192,6 +193,7 @@ bool Debugger::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("GFX:\n");
 	debugPrintf(" draw [cast|frame|off] - Draws debug outlines for cast or frame number\n");
+	debugPrintf(" renderstats [reset] - Shows the number of recomposited pixels of the stage\n");
 	return true;
 }
 
@@ -1002,6 +1004,29 @@ bool Debugger::cmdForceRedraw(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdRenderStats(int argc, const char **argv) {
+	Window *stage = g_director->getStage();
+	RenderStats &stats = stage->_renderStats;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		stats = RenderStats();
+		debugPrintf("Render stats reset\n");
+		return true;
+	}
+
+	const Common::Rect &dims = stage->getInnerDimensions();
+	uint32 stagePixels = dims.width() * dims.height();
+
+	debugPrintf("Renders: %d, rects: %d, pixels: %llu\n", stats.frames, stats.rects, (unsigned long long)stats.pixels);
+	if (stats.frames && stagePixels) {
+		debugPrintf("Average per render: %llu pixels (%d%% of the stage)\n",
+			(unsigned long long)(stats.pixels / stats.frames), (int)(stats.pixels * 100 / ((uint64)stats.frames * stagePixels)));
+	}
+	debugPrintf("Last render: %d rects, %d pixels. Largest render: %d pixels\n", stats.lastRects, stats.lastPixels, stats.maxPixels);
+
+	return true;
+}
+
 void Debugger::bpUpdateState() {
 	_bpCheckFunc = false;
 	_bpCheckMoviePath = false;
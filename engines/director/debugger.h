@@ -121,6 +121,7 @@ private:
 
 	bool cmdDraw(int argc, const char **argv);
 	bool cmdForceRedraw(int argc, const char **argv);
+	bool cmdRenderStats(int argc, const char **argv);
 
 	void bpUpdateState();
 	void bpTest(bool forceCheck = false);
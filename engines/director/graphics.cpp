@@ -669,6 +669,99 @@ void DirectorPlotData::inkBlitShape(Common::Rect &srcRect) {
 	}
 }
 
+// Row kernels for the inks which work on pixel values only, without
+// colour lookups. With the ink switch hoisted out of the pixel loop,
+// these loops are simple enough for the compiler to vectorize.
+template <typename T>
+struct InkCopyOp { T operator()(T dst, T src) const { return src; } };
+template <typename T>
+struct InkBackgndTransOp {
+	T back;
+	InkBackgndTransOp(T b) : back(b) {}
+	T operator()(T dst, T src) const { return src == back ? dst : src; }
+};
+template <typename T>
+struct InkTransparentOp { T operator()(T dst, T src) const { return dst | src; } };
+template <typename T>
+struct InkNotTransOp { T operator()(T dst, T src) const { return dst | (T)~src; } };
+template <typename T>
+struct InkReverseOp { T operator()(T dst, T src) const { return dst ^ src; } };
+template <typename T>
+struct InkNotReverseOp { T operator()(T dst, T src) const { return dst ^ (T)~src; } };
+template <typename T>
+struct InkGhostOp { T operator()(T dst, T src) const { return dst & (T)~src; } };
+template <typename T>
+struct InkNotGhostOp { T operator()(T dst, T src) const { return dst & src; } };
+
+template <typename T, typename Op>
+static void inkBlitRows(DirectorPlotData *p, const Common::Rect &srcArea, const Graphics::Surface *mask, Op op) {
+	const int w = srcArea.width();
+
+	for (int i = 0; i < srcArea.height(); i++) {
+		const T *src = (const T *)p->srf->getBasePtr(srcArea.left, srcArea.top + i);
+		T *dst = (T *)p->dst->getBasePtr(p->destRect.left, p->destRect.top + i);
+
+		if (mask) {
+			const byte *msk = (const byte *)mask->getBasePtr(srcArea.left, srcArea.top + i);
+			for (int j = 0; j < w; j++)
+				dst[j] = msk[j] ? op(dst[j], src[j]) : dst[j];
+		} else {
+			for (int j = 0; j < w; j++)
+				dst[j] = op(dst[j], src[j]);
+		}
+	}
+}
+
+template <typename T>
+static bool inkBlitBatched(DirectorPlotData *p, const Common::Rect &srcArea, const Graphics::Surface *mask) {
+	// Same results as inkDrawPixel() for these cases, one row at a time
+	bool rawColors = !p->oneBitImage && !p->applyColor;
+
+	switch (p->ink) {
+	case kInkTypeCopy:
+	case kInkTypeMatte:
+	case kInkTypeMask:
+	case kInkTypeBlend:
+		if (p->applyColor)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkCopyOp<T>());
+		return true;
+	case kInkTypeBackgndTrans:
+		if (!rawColors || p->backColor != (T)p->backColor)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkBackgndTransOp<T>(p->backColor));
+		return true;
+	case kInkTypeTransparent:
+		if (!rawColors)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkTransparentOp<T>());
+		return true;
+	case kInkTypeNotTrans:
+		if (!rawColors)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkNotTransOp<T>());
+		return true;
+	case kInkTypeReverse:
+		inkBlitRows<T>(p, srcArea, mask, InkReverseOp<T>());
+		return true;
+	case kInkTypeNotReverse:
+		inkBlitRows<T>(p, srcArea, mask, InkNotReverseOp<T>());
+		return true;
+	case kInkTypeGhost:
+		if (!rawColors)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkGhostOp<T>());
+		return true;
+	case kInkTypeNotGhost:
+		if (!rawColors)
+			return false;
+		inkBlitRows<T>(p, srcArea, mask, InkNotGhostOp<T>());
+		return true;
+	default:
+		return false;
+	}
+}
+
 void DirectorPlotData::inkBlitSurface(Common::Rect &srcRect, const Graphics::Surface *mask) {
 	if (!srf)
 		return;
@@ -699,6 +792,28 @@ void DirectorPlotData::inkBlitSurface(Common::Rect &srcRect, const Graphics::Sur
 		}
 	}
 
+	// Inks which only combine pixel values are done a row at a time.
+	// Text sprites are excluded, as preprocessColor() remaps their colors.
+	uint bpp = d->_wm->_pixelformat.bytesPerPixel;
+	if (!alpha && !ms && sprite != kTextSprite && srf->format.bytesPerPixel == bpp && dst->format.bytesPerPixel == bpp) {
+		Common::Rect srcArea(
+			Common::Point(abs(srcRect.left - destRect.left), abs(srcRect.top - destRect.top)),
+			destRect.width(),
+			destRect.height()
+		);
+
+		if (srfClip.contains(srcArea) && (!mask || Common::Rect(mask->w, mask->h).contains(srcArea))) {
+			bool done;
+			if (bpp == 1)
+				done = inkBlitBatched<byte>(this, srcArea, mask);
+			else
+				done = inkBlitBatched<uint32>(this, srcArea, mask);
+
+			if (done)
+				return;
+		}
+	}
+
 	// For blit efficiency, surfaces passed here need to be the same
 	// format as the window manager. Most of the time this is
 	// the job of BitmapCastMember::createWidget.
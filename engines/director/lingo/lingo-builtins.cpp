@@ -278,12 +278,16 @@ void Lingo::initBuiltIns(BuiltinProto protos[]) {
 			break;
 		}
 	}
+
+	invalidateHandlerCache();
 }
 
 void Lingo::cleanupBuiltIns() {
 	_builtinCmds.clear();
 	_builtinFuncs.clear();
 	_builtinConsts.clear();
+
+	invalidateHandlerCache();
 }
 
 void Lingo::cleanupBuiltIns(BuiltinProto protos[]) {
@@ -305,6 +309,8 @@ void Lingo::cleanupBuiltIns(BuiltinProto protos[]) {
 			break;
 		}
 	}
+
+	invalidateHandlerCache();
 }
 
 void Lingo::printArgs(const char *funcname, int nargs, const char *prefix) {
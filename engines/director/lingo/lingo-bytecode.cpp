@@ -536,11 +536,12 @@ void LC::cb_proplist() {
 
 
 void LC::cb_call() {
+	const inst *callSite = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name = g_lingo->readString();
 
 	Datum nargs = g_lingo->pop();
 	if ((nargs.type == ARGC) || (nargs.type == ARGCNORET)) {
-		LC::call(name, nargs.u.i, nargs.type == ARGC);
+		LC::call(name, nargs.u.i, nargs.type == ARGC, callSite);
 
 	} else {
 		warning("cb_call: first arg should be of type ARGC or ARGCNORET, not %s", nargs.type2str());
@@ -1657,6 +1658,7 @@ ScriptContext *LingoCompiler::compileLingoV4(Common::SeekableReadStreamEndian &s
 				_assemblyArchive->functionHandlers[it._key] = it._value;
 			}
 		}
+		Lingo::invalidateHandlerCache();
 	}
 
 	if (!skipdump && ConfMan.getBool("dump_scripts")) {
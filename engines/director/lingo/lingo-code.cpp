@@ -511,27 +511,23 @@ void LC::c_proprefpush() {
 }
 
 void LC::c_varpush() {
-	LC::c_varrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetchName(VARREF, name));
 }
 
 void LC::c_globalpush() {
-	LC::c_globalrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetchName(GLOBALREF, name));
 }
 
 void LC::c_localpush() {
-	LC::c_localrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetchName(LOCALREF, name));
 }
 
 void LC::c_proppush() {
-	LC::c_proprefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetchName(PROPREF, name));
 }
 
 void LC::c_stackpeek() {
@@ -659,6 +655,59 @@ void LC::c_swap() {
 	g_lingo->push(d1);
 }
 
+// Typed fast paths for the arithmetic and comparison opcodes.
+// When both operands are plain numbers, the result is stored straight into
+// the stack slot of the first operand, skipping the Datum copies and the
+// type alignment of the generic *Data() functions.
+static inline bool numericOperands() {
+	StackData &stack = g_lingo->_stack;
+	uint size = stack.size();
+	if (size < 2)
+		return false;
+
+	DatumType t1 = stack[size - 2].type;
+	DatumType t2 = stack[size - 1].type;
+	return (t1 == INT || t1 == FLOAT) && (t2 == INT || t2 == FLOAT);
+}
+
+static inline Datum &detachNumber(Datum &d) {
+	// The slot may share its reference count with the variable it was
+	// pushed from, and Datum::operator= skips assignments between such
+	// Datums. Numbers own no data, so giving the slot its own count is enough.
+	if (*d.refCount > 1) {
+		*d.refCount -= 1;
+		d.refCount = new int;
+		*d.refCount = 1;
+	}
+	return d;
+}
+
+static inline void replaceOperands(int val) {
+	g_lingo->_stack.pop_back();
+	Datum &d = detachNumber(g_lingo->_stack.back());
+	d.u.i = val;
+	d.type = INT;
+}
+
+static inline void replaceOperands(double val) {
+	g_lingo->_stack.pop_back();
+	Datum &d = detachNumber(g_lingo->_stack.back());
+	d.u.f = val;
+	d.type = FLOAT;
+}
+
+static inline const Datum &operand1() {
+	return g_lingo->_stack[g_lingo->_stack.size() - 2];
+}
+
+static inline const Datum &operand2() {
+	return g_lingo->_stack.back();
+}
+
+static inline bool intOperands() {
+	return operand1().type == INT && operand2().type == INT;
+}
+
 static DatumType getArrayAlignedType(Datum &d1, Datum &d2) {
 	if (d1.type == POINT && (d2.type == RECT || (d2.type == ARRAY && d2.u.farr->arr.size() != 2)))
 		return ARRAY;
@@ -729,6 +778,14 @@ Datum LC::addData(Datum &d1, Datum &d2) {
 }
 
 void LC::c_add() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i + operand2().u.i);
+		else
+			replaceOperands(operand1().asFloat() + operand2().asFloat());
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::addData(d1, d2));
@@ -758,6 +815,14 @@ Datum LC::subData(Datum &d1, Datum &d2) {
 }
 
 void LC::c_sub() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i - operand2().u.i);
+		else
+			replaceOperands(operand1().asFloat() - operand2().asFloat());
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::subData(d1, d2));
@@ -787,6 +852,14 @@ Datum LC::mulData(Datum &d1, Datum &d2) {
 }
 
 void LC::c_mul() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i * operand2().u.i);
+		else
+			replaceOperands(operand1().asFloat() * operand2().asFloat());
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::mulData(d1, d2));
@@ -826,6 +899,11 @@ Datum LC::divData(Datum &d1, Datum &d2) {
 }
 
 void LC::c_div() {
+	if (numericOperands() && intOperands() && operand2().u.i != 0) {
+		replaceOperands(operand1().u.i / operand2().u.i);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(divData(d1, d2));
@@ -1366,6 +1444,14 @@ Datum LC::eqDataStrict(Datum d1, Datum d2) {
 }
 
 void LC::c_eq() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i == operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() == operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::eqData(d1, d2));
@@ -1377,6 +1463,14 @@ Datum LC::neqData(Datum d1, Datum d2) {
 }
 
 void LC::c_neq() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i != operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() != operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::neqData(d1, d2));
@@ -1392,6 +1486,14 @@ Datum LC::gtData(Datum d1, Datum d2) {
 }
 
 void LC::c_gt() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i > operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() > operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::gtData(d1, d2));
@@ -1407,6 +1509,14 @@ Datum LC::ltData(Datum d1, Datum d2) {
 }
 
 void LC::c_lt() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i < operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() < operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::ltData(d1, d2));
@@ -1422,6 +1532,14 @@ Datum LC::geData(Datum d1, Datum d2) {
 }
 
 void LC::c_ge() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i >= operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() >= operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::geData(d1, d2));
@@ -1437,6 +1555,14 @@ Datum LC::leData(Datum d1, Datum d2) {
 }
 
 void LC::c_le() {
+	if (numericOperands()) {
+		if (intOperands())
+			replaceOperands(operand1().u.i <= operand2().u.i ? 1 : 0);
+		else
+			replaceOperands(operand1().asFloat() <= operand2().asFloat() ? 1 : 0);
+		return;
+	}
+
 	Datum d2 = g_lingo->pop();
 	Datum d1 = g_lingo->pop();
 	g_lingo->push(LC::leData(d1, d2));
@@ -1449,7 +1575,13 @@ void LC::c_jump() {
 
 void LC::c_jumpifz() {
 	int jump = g_lingo->readInt();
-	int test = g_lingo->pop().asInt();
+	int test;
+	if (!g_lingo->_stack.empty() && g_lingo->_stack.back().type == INT) {
+		test = g_lingo->_stack.back().u.i;
+		g_lingo->_stack.pop_back();
+	} else {
+		test = g_lingo->pop().asInt();
+	}
 	if (test == 0) {
 		g_lingo->_state->pc = g_lingo->_state->pc + jump - 2;
 	}
@@ -1509,22 +1641,24 @@ void LC::c_telldone() {
 //************************
 
 void LC::c_callcmd() {
+	const inst *callSite = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name(g_lingo->readString());
 
 	int nargs = g_lingo->readInt();
 
-	LC::call(name, nargs, false);
+	LC::call(name, nargs, false, callSite);
 }
 
 void LC::c_callfunc() {
+	const inst *callSite = &(*g_lingo->_state->script)[g_lingo->_state->pc];
 	Common::String name(g_lingo->readString());
 
 	int nargs = g_lingo->readInt();
 
-	LC::call(name, nargs, true);
+	LC::call(name, nargs, true, callSite);
 }
 
-void LC::call(const Common::String &name, int nargs, bool allowRetVal) {
+void LC::call(const Common::String &name, int nargs, bool allowRetVal, const inst *callSite) {
 	if (debugChannelSet(3, kDebugLingoExec))
 		g_lingo->printArgs(name.c_str(), nargs, "call:");
 
@@ -1594,37 +1728,32 @@ void LC::call(const Common::String &name, int nargs, bool allowRetVal) {
 		}
 	}
 
-	// Handler
-	funcSym = g_lingo->getHandler(name);
+	// Handler or builtin. Call instructions keep the lookup result around,
+	// so that only the argument dependent checks below are done every time.
+	CallSiteCache uncached;
+	CallSiteCache *resolved = &uncached;
+	if (callSite)
+		resolved = &g_lingo->getCallSiteCache(callSite, name, allowRetVal);
+	else
+		g_lingo->resolveHandler(uncached, name, allowRetVal);
+
+	funcSym = resolved->handler;
 
-	if (g_lingo->_builtinListHandlers.contains(name) && nargs >= 1) {
+	if (resolved->listHandler.type != VOIDSYM && nargs >= 1) {
 		// Lingo builtin functions in the "List" category have very strange override mechanics.
 		// If the first argument is an ARRAY or PARRAY, it will use the builtin.
 		// Otherwise, it will fall back to whatever handler is defined globally.
-		Datum firstArg = g_lingo->peek(nargs - 1);
-		if (firstArg.type == ARRAY || firstArg.type == PARRAY ||
-				firstArg.type == POINT || firstArg.type == RECT) {
-			funcSym = g_lingo->_builtinListHandlers[name];
-		}
-	}
-
-	if (funcSym.type == VOIDSYM) { // The built-ins could be overridden
-		// Builtin
-		if (allowRetVal) {
-			if (g_lingo->_builtinFuncs.contains(name)) {
-				funcSym = g_lingo->_builtinFuncs[name];
-			}
-		} else {
-			if (g_lingo->_builtinCmds.contains(name)) {
-				funcSym = g_lingo->_builtinCmds[name];
-			}
+		DatumType firstArgType = g_lingo->_stack[g_lingo->_stack.size() - nargs].type;
+		if (firstArgType == ARRAY || firstArgType == PARRAY ||
+				firstArgType == POINT || firstArgType == RECT) {
+			funcSym = resolved->listHandler;
 		}
 	}
 
 	// use lingo-the as fallback. we can only use functions as fallback, not properties
-	if (funcSym.type == VOIDSYM && g_lingo->_theEntities.contains(name) && g_lingo->_theEntities[name]->isFunction) {
+	if (funcSym.type == VOIDSYM && resolved->theEntity >= 0) {
 		Datum id;
-		Datum res = g_lingo->getTheEntity(g_lingo->_theEntities[name]->entity, id, kTheNOField);
+		Datum res = g_lingo->getTheEntity(resolved->theEntity, id, kTheNOField);
 		g_lingo->push(res);
 		return;
 	}
@@ -124,7 +124,7 @@ void c_callcmd();
 void c_callfunc();
 
 void call(const Symbol &targetSym, int nargs, bool allowRetVal);
-void call(const Common::String &name, int nargs, bool allowRetVal);
+void call(const Common::String &name, int nargs, bool allowRetVal, const inst *callSite = nullptr);
 
 void c_procret();
 
@@ -253,6 +253,7 @@ ScriptContext *LingoCompiler::compileLingo(const Common::U32String &code, LingoA
 				_assemblyArchive->functionHandlers[it._key] = it._value;
 			}
 		}
+		Lingo::invalidateHandlerCache();
 	}
 
 	delete _methodVars;
@@ -425,6 +425,7 @@ ScriptContext::ScriptContext(const ScriptContext &sc) : Object<ScriptContext>(sc
 }
 
 ScriptContext::~ScriptContext() {
+	Lingo::invalidateHandlerCache();
 }
 
 Common::String ScriptContext::asString() {
@@ -448,6 +449,7 @@ Symbol ScriptContext::define(const Common::String &name, ScriptData *code, Commo
 	}
 
 	_functionHandlers[name] = sym;
+	Lingo::invalidateHandlerCache();
 	if (g_lingo->_eventHandlerTypeIds.contains(name)) {
 		_eventHandlers[g_lingo->_eventHandlerTypeIds[name]] = sym;
 	}
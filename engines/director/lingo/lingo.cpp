@@ -44,6 +44,8 @@ namespace Director {
 
 Lingo *g_lingo;
 
+uint32 Lingo::_handlerEpoch = 1;
+
 int calcStringAlignment(const char *s) {
 	return calcCodeAlignment(strlen(s) + 1);
 }
@@ -121,8 +123,10 @@ void Symbol::reset() {
 		if (name)
 			delete name;
 
-		if (type == HANDLER)
+		if (type == HANDLER) {
 			delete u.defn;
+			Lingo::invalidateHandlerCache();
+		}
 
 		if (argNames)
 			delete argNames;
@@ -175,6 +179,7 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 	_state = nullptr;
 	_currentChannelId = -1;
 	_globalCounter = 0;
+	_callSiteCacheEpoch = 0;
 	_freezeState = false;
 	_abort = false;
 	_expectError = false;
@@ -245,6 +250,8 @@ void Lingo::reloadBuiltIns() {
 }
 
 LingoArchive::~LingoArchive() {
+	Lingo::invalidateHandlerCache();
+
 	// First cleanup the ScriptContexts that are only in LctxContexts.
 	// LctxContexts has a huge overlap with scriptContexts.
 	for (auto &it : lctxContexts){
@@ -345,6 +352,53 @@ Symbol Lingo::getHandler(const Common::String &name) {
 	return sym;
 }
 
+CallSiteCache &Lingo::getCallSiteCache(const inst *site, const Common::String &name, bool allowRetVal) {
+	if (_callSiteCacheEpoch != _handlerEpoch) {
+		// Dropping the cached symbols may free handlers and bump the epoch again
+		_callSiteCache.clear();
+		_callSiteCacheEpoch = _handlerEpoch;
+	}
+
+	CallSiteCache &cache = _callSiteCache.getOrCreateVal(site);
+	Movie *movie = g_director->getCurrentMovie();
+
+	if (cache.epoch == _handlerEpoch && cache.context == _state->context &&
+			cache.movie == movie && cache.allowRetVal == allowRetVal)
+		return cache;
+
+	resolveHandler(cache, name, allowRetVal);
+	cache.epoch = _handlerEpoch;
+	cache.context = _state->context;
+	cache.movie = movie;
+	cache.allowRetVal = allowRetVal;
+
+	return cache;
+}
+
+void Lingo::resolveHandler(CallSiteCache &cache, const Common::String &name, bool allowRetVal) {
+	cache.handler = getHandler(name);
+
+	// The built-ins could be overridden
+	if (cache.handler.type == VOIDSYM) {
+		SymbolHash &builtins = allowRetVal ? _builtinFuncs : _builtinCmds;
+		SymbolHash::iterator it = builtins.find(name);
+		if (it != builtins.end())
+			cache.handler = it->_value;
+	}
+
+	SymbolHash::iterator it = _builtinListHandlers.find(name);
+	if (it != _builtinListHandlers.end())
+		cache.listHandler = it->_value;
+	else
+		cache.listHandler = Symbol();
+
+	TheEntityHash::iterator entity = _theEntities.find(name);
+	if (entity != _theEntities.end() && entity->_value->isFunction)
+		cache.theEntity = entity->_value->entity;
+	else
+		cache.theEntity = -1;
+}
+
 
 void LingoArchive::patchCode(const Common::U32String &code, ScriptType type, uint16 id, const char *scriptName, uint32 preprocFlags) {
 	debugC(1, kDebugCompile, "Patching code for type %s(%d) with id %d in '%s%s'\n"
@@ -368,6 +422,7 @@ void LingoArchive::patchCode(const Common::U32String &code, ScriptType type, uin
 		}
 		sc->_functionHandlers.clear();
 		delete sc;
+		Lingo::invalidateHandlerCache();
 	}
 }
 
@@ -404,6 +459,7 @@ void LingoArchive::removeCode(ScriptType type, uint16 id) {
 
 	ctx->decRefCount();
 	scriptContexts[type].erase(id);
+	Lingo::invalidateHandlerCache();
 }
 
 void LingoArchive::replaceCode(const Common::U32String &code, ScriptType type, uint16 id, const char *scriptName) {
@@ -1734,59 +1790,10 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 
 	switch (var.type) {
 	case VARREF:
-		{
-			Datum d;
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
-			}
-			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
-				return _state->me.u.obj->getProp(name);
-			}
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
-
-			if (!silent)
-				debugC(1, kDebugLingoExec, "varFetch: variable %s not found", name.c_str());
-			return result;
-		}
-		break;
 	case GLOBALREF:
-		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
-			debugC(1, kDebugLingoExec, "varFetch: global variable %s not defined", name.c_str());
-			return result;
-		}
-		break;
 	case LOCALREF:
-		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
-			}
-			debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
-			return result;
-		}
-		break;
 	case PROPREF:
-		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
-				return _state->me.u.obj->getProp(name);
-			}
-			warning("varFetch: property %s not defined", name.c_str());
-			return result;
-		}
-		break;
+		return varFetchName(var.type, *var.u.s, silent);
 	case FIELDREF:
 	case CASTREF:
 	case CHUNKREF:
@@ -1803,6 +1810,43 @@ Datum Lingo::varFetch(const Datum &var, bool silent) {
 	return result;
 }
 
+Datum Lingo::varFetchName(DatumType type, const Common::String &name, bool silent) {
+	// Variable lookup without building a reference Datum first,
+	// used directly by the variable push opcodes.
+	g_debugger->varReadHook(name);
+
+	if (type == VARREF || type == LOCALREF) {
+		if (_state->localVars) {
+			DatumHash::iterator it = _state->localVars->find(name);
+			if (it != _state->localVars->end())
+				return it->_value;
+		}
+		if (type == LOCALREF) {
+			debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
+			return Datum();
+		}
+	}
+	if (type == VARREF || type == PROPREF) {
+		if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
+			return _state->me.u.obj->getProp(name);
+		}
+		if (type == PROPREF) {
+			warning("varFetch: property %s not defined", name.c_str());
+			return Datum();
+		}
+	}
+
+	DatumHash::iterator it = _globalvars.find(name);
+	if (it != _globalvars.end())
+		return it->_value;
+
+	if (type == GLOBALREF)
+		debugC(1, kDebugLingoExec, "varFetch: global variable %s not defined", name.c_str());
+	else if (!silent)
+		debugC(1, kDebugLingoExec, "varFetch: variable %s not found", name.c_str());
+	return Datum();
+}
+
 Common::U32String Lingo::evalChunkRef(const Datum &var) {
 	Common::U32String result;
 
@@ -337,6 +337,20 @@ struct LingoState {
 	~LingoState();
 };
 
+struct CallSiteCache {
+	// Handler resolution for a single call instruction.
+	// Valid as long as the handler epoch, context and movie did not change.
+	uint32 epoch = 0;
+	ScriptContext *context = nullptr;
+	Movie *movie = nullptr;
+	bool allowRetVal = false;
+	Symbol handler;			// script handler or builtin, VOIDSYM if none
+	Symbol listHandler;		// list builtin which overrides handler for list arguments
+	int theEntity = -1;		// function-like 'the' entity used as fallback
+};
+
+typedef Common::HashMap<const inst *, CallSiteCache> CallSiteCacheHash;
+
 enum LingoExecState {
 	kRunning,
 	kPause,
@@ -412,6 +426,7 @@ public:
 	void cleanLocalVars();
 	void varAssign(const Datum &var, const Datum &value);
 	Datum varFetch(const Datum &var, bool silent = false);
+	Datum varFetchName(DatumType type, const Common::String &name, bool silent = false);
 	Common::U32String evalChunkRef(const Datum &var);
 	Datum findVarV4(int varType, const Datum &id);
 	CastMemberID resolveCastMember(const Datum &memberID, const Datum &castLib, CastType type);
@@ -527,6 +542,19 @@ public:
 	Datum pop();
 	Datum peek(uint offset);
 
+public:
+	// Call site caches are dropped whenever a handler may have been added,
+	// replaced or freed. Scripts are also freed after the Lingo object is
+	// gone, hence the static epoch.
+	static void invalidateHandlerCache() { _handlerEpoch++; }
+	CallSiteCache &getCallSiteCache(const inst *site, const Common::String &name, bool allowRetVal);
+	void resolveHandler(CallSiteCache &cache, const Common::String &name, bool allowRetVal);
+
+private:
+	static uint32 _handlerEpoch;
+	uint32 _callSiteCacheEpoch;
+	CallSiteCacheHash _callSiteCache;
+
 public:
 	Common::HashMap<uint32, const char *> _eventHandlerTypes;
 	Common::HashMap<Common::String, uint32, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _eventHandlerTypeIds;
@@ -98,6 +98,8 @@ Movie::Movie(Window *window) {
 }
 
 Movie::~Movie() {
+	Lingo::invalidateHandlerCache();
+
 	if (_sharedCast && _sharedCast->getArchive()) {
 		debug(0, "@@   Clearing shared cast '%s'", _sharedCast->getArchive()->getPathName().toString().c_str());
 
@@ -153,13 +153,25 @@ bool Window::render(bool forceRedraw, Graphics::ManagedSurface *blitTo) {
 			return false;
 		}
 
-		mergeDirtyRects();
+		coalesceDirtyRects();
 	}
 
 	Channel *hiliteChannel = _currentMovie->getScore()->getChannelById(_currentMovie->_currentHiliteChannelId);
 
 	uint32 renderStartTime = g_system->getMillis();
-	debugC(7, kDebugImages, "Window::render(): Updating %d rects", _dirtyRects.size());
+
+	uint32 pixels = 0;
+	for (auto &i : _dirtyRects)
+		pixels += i.width() * i.height();
+
+	_renderStats.frames++;
+	_renderStats.rects += _dirtyRects.size();
+	_renderStats.pixels += pixels;
+	_renderStats.lastRects = _dirtyRects.size();
+	_renderStats.lastPixels = pixels;
+	_renderStats.maxPixels = MAX(_renderStats.maxPixels, pixels);
+
+	debugC(7, kDebugImages, "Window::render(): Updating %d rects, %d pixels", _dirtyRects.size(), pixels);
 
 	for (auto &i : _dirtyRects) {
 		const Common::Rect &r = i;
@@ -227,6 +239,69 @@ bool Window::render(bool forceRedraw, Graphics::ManagedSurface *blitTo) {
 	return true;
 }
 
+static inline int rectArea(const Common::Rect &r) {
+	return r.width() * r.height();
+}
+
+void Window::coalesceDirtyRects() {
+	// Merging every pair of overlapping rects, as MacWindow::mergeDirtyRects()
+	// does, quickly degrades into redrawing the whole stage when a few sprites
+	// move far apart from each other. Overlapping rects are only merged when
+	// their bounding box is not larger than the two of them together.
+	// Otherwise the new rect is cut around the existing one, so that no
+	// pixel gets composited twice.
+	Common::Array<Common::Rect> pending;
+	Common::Array<Common::Rect> result;
+
+	for (auto &i : _dirtyRects)
+		pending.push_back(i);
+
+	while (!pending.empty()) {
+		Common::Rect r = pending.back();
+		pending.pop_back();
+
+		bool handled = false;
+		for (uint i = 0; i < result.size(); i++) {
+			const Common::Rect e = result[i];
+			if (!e.intersects(r))
+				continue;
+
+			handled = true;
+			if (e.contains(r))
+				break;
+
+			Common::Rect bounds = e;
+			bounds.extend(r);
+			if (rectArea(bounds) <= rectArea(e) + rectArea(r)) {
+				result.remove_at(i);
+				pending.push_back(bounds);
+				break;
+			}
+
+			// Queue the parts of r which are outside of e
+			if (r.top < e.top)
+				pending.push_back(Common::Rect(r.left, r.top, r.right, e.top));
+			if (r.bottom > e.bottom)
+				pending.push_back(Common::Rect(r.left, e.bottom, r.right, r.bottom));
+
+			int16 top = MAX(r.top, e.top);
+			int16 bottom = MIN(r.bottom, e.bottom);
+			if (r.left < e.left)
+				pending.push_back(Common::Rect(r.left, top, e.left, bottom));
+			if (r.right > e.right)
+				pending.push_back(Common::Rect(e.right, top, r.right, bottom));
+			break;
+		}
+
+		if (!handled)
+			result.push_back(r);
+	}
+
+	_dirtyRects.clear();
+	for (auto &i : result)
+		_dirtyRects.push_back(i);
+}
+
 void Window::setStageColor(uint32 stageColor, bool forceReset) {
 	if (stageColor != _stageColor || forceReset) {
 		_stageColor = stageColor;
@@ -100,6 +100,15 @@ struct TransParams {
 	}
 };
 
+struct RenderStats {
+	uint32 frames = 0;		// renders which recomposited anything
+	uint32 rects = 0;		// recomposited rectangles
+	uint64 pixels = 0;		// recomposited pixels
+	uint32 lastRects = 0;
+	uint32 lastPixels = 0;
+	uint32 maxPixels = 0;	// largest single render
+};
+
 class Window : public Graphics::MacWindow, public Object<Window> {
 public:
 	Window(int id, bool scrollable, bool resizable, bool editable, Graphics::MacWindowManager *wm, DirectorEngine *vm, bool isStage);
@@ -195,6 +204,7 @@ public:
 public:
 	Common::List<Channel *> _dirtyChannels;
 	TransParams *_puppetTransition;
+	RenderStats _renderStats;
 
 	MovieReference _nextMovie;
 	Common::List<MovieReference> _movieStack;
@@ -220,6 +230,7 @@ private:
 private:
 	void inkBlitFrom(Channel *channel, Common::Rect destRect, Graphics::ManagedSurface *blitTo = nullptr);
 	void drawFrameCounter(Graphics::ManagedSurface *blitTo);
+	void coalesceDirtyRects();
 
 
 };
@@ -849,6 +849,8 @@ void Engine::defaultSyncSoundSettings() {
 	_mixer->setVolumeForSoundType(Audio::Mixer::kMusicSoundType, soundVolumeMusic);
 	_mixer->setVolumeForSoundType(Audio::Mixer::kSFXSoundType, soundVolumeSFX);
 	_mixer->setVolumeForSoundType(Audio::Mixer::kSpeechSoundType, soundVolumeSpeech);
+
+	_mixer->setResamplerQuality(Audio::getResamplerQualityFromConfig());
 }
 
 void Engine::flipMute() {
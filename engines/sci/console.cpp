@@ -71,6 +71,7 @@ namespace Sci {
 int g_debug_sleeptime_factor = 1;
 int g_debug_simulated_key = 0;
 bool g_debug_track_mouse_clicks = false;
+bool g_debug_verify_predecode = false;
 
 // Refer to the "addresses" command on how to pass address parameters
 static int parse_reg_t(EngineState *s, const char *str, reg_t *dest);
@@ -85,8 +86,10 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",	&engine->_gamestate->gcIncremental);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
+	registerVar("verify_predecode",	&g_debug_verify_predecode);
 	registerCmd("speed_throttle",   WRAP_METHOD(Console, cmdSpeedThrottle));
 
 	// General
@@ -115,6 +118,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -163,6 +167,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -319,8 +324,10 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("---------\n");
 	debugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	debugPrintf("gc_incremental: Spread garbage collections across several frames (experimental, off by default)\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
+	debugPrintf("verify_predecode: Checks each predecoded VM instruction against the script\n");
 	debugPrintf("speed_throttle: Displays or changes kGameIsRestarting maximum delay\n");
 	debugPrintf("\n");
 	debugPrintf("Debug flags\n");
@@ -355,6 +362,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows or changes the memory budgets of the resource cache\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -398,6 +406,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -1201,6 +1210,28 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	if (argc != 1 && argc != 3) {
+		debugPrintf("Shows the memory usage of the resource cache, or changes its budgets\n");
+		debugPrintf("Usage: %s [<unpacked KiB> <compressed KiB>]\n", argv[0]);
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+	if (argc == 3)
+		resMan->setCacheBudgets(MAX(atoi(argv[1]), 0) * 1024, MAX(atoi(argv[2]), 0) * 1024);
+
+	const ResourceCacheStatistics stats = resMan->getCacheStatistics();
+	debugPrintf("Locked resources: %d KiB\n", stats.memoryLocked / 1024);
+	debugPrintf("Unpacked resources: %d of %d KiB\n", stats.memoryLRU / 1024, stats.maxMemoryLRU / 1024);
+	debugPrintf("Compressed data: %d of %d KiB\n", stats.memoryPacked / 1024, stats.maxMemoryPacked / 1024);
+	debugPrintf("Requests: %u already unpacked, %u unpacked from memory, %u read from disk\n",
+		stats.hits, stats.unpacks, stats.diskLoads);
+	debugPrintf("Resources unpacked in the background: %u\n", stats.prefetches);
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2938,6 +2969,50 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+static void printGCPauses(Console *con, const char *name, const GCPauseHistogram &pauses) {
+	con->debugPrintf("%-8s", name);
+	for (int i = 0; i < GCPauseHistogram::kBuckets; i++)
+		con->debugPrintf(" %6u", pauses.count[i]);
+	con->debugPrintf(" %6ums %6ums\n", pauses.total, pauses.max);
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	EngineState *s = _engine->_gamestate;
+
+	if (!s->_gcState) {
+		debugPrintf("The garbage collector did not run yet\n");
+		return true;
+	}
+
+	GCState &gc = *s->_gcState;
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			gc.fullPauses.reset();
+			gc.startPauses.reset();
+			gc.stepPauses.reset();
+			gc.finishPauses.reset();
+			debugPrintf("Reset the garbage collector statistics\n");
+		} else {
+			debugPrintf("Shows the pause times of the garbage collector.\n");
+			debugPrintf("Usage: %s [reset]\n", argv[0]);
+		}
+		return true;
+	}
+
+	debugPrintf("%u collections, %u objects freed by the last one\n", gc.collections, gc.freed);
+	if (s->_segMan->isGCBarrierActive())
+		debugPrintf("Incremental collection running, %u references left to mark\n", gc.wm._worklist.size());
+	debugPrintf("\n%-8s %6s %6s %6s %6s %6s %6s %6s %6s %8s %8s\n", "Pauses", "<1ms", "1ms", "2-3ms", "4-7ms",
+	            "8-15", "16-31", "32-63", "64+", "total", "max");
+	printGCPauses(this, "full", gc.fullPauses);
+	printGCPauses(this, "start", gc.startPauses);
+	printGCPauses(this, "step", gc.stepPauses);
+	printGCPauses(this, "finish", gc.finishPauses);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -91,6 +91,7 @@ struct DebugState {
 extern int g_debug_sleeptime_factor;
 extern int g_debug_simulated_key;
 extern bool g_debug_track_mouse_clicks;
+extern bool g_debug_verify_predecode;
 
 } // End of namespace Sci
 
@@ -21,6 +21,8 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/math.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -31,6 +33,11 @@ namespace Sci {
 
 //#define GC_DEBUG_CODE
 
+enum {
+	/** Number of references an incremental marking step scans at most */
+	kGCStepReferences = 2000
+};
+
 #ifdef GC_DEBUG_CODE
 const char *segmentTypeNames[] = {
 	"invalid",   // 0
@@ -67,6 +74,32 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 		push(*it);
 }
 
+void WorklistManager::rescan(reg_t reg) {
+	if (!reg.getSegment())
+		return;
+
+	_map.setVal(reg, true);
+	_worklist.push_back(reg);
+}
+
+void WorklistManager::clear() {
+	_worklist.clear();
+	_map.clear();
+}
+
+void GCPauseHistogram::reset() {
+	memset(count, 0, sizeof(count));
+	total = 0;
+	max = 0;
+}
+
+void GCPauseHistogram::add(uint32 millis) {
+	const uint bucket = millis ? MIN<uint>(Common::intLog2(millis) + 1, kBuckets - 1) : 0;
+	count[bucket]++;
+	total += millis;
+	max = MAX(max, millis);
+}
+
 static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
 	AddrSet *normal_map = new AddrSet();
 
@@ -83,26 +116,39 @@ static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_
 	return normal_map;
 }
 
-static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
+/**
+ * Scans the references on the worklist for further references, until the
+ * worklist is empty or maxReferences have been scanned.
+ * @return true if the worklist is empty
+ */
+static bool processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap, uint maxReferences = 0, bool skipInvalid = false) {
 	SegmentId stackSegment = segMan->findSegmentByType(SEG_TYPE_STACK);
+	uint scanned = 0;
 	while (!wm._worklist.empty()) {
+		if (maxReferences && scanned++ == maxReferences)
+			return false;
+
 		reg_t reg = wm._worklist.back();
 		wm._worklist.pop_back();
 		if (reg.getSegment() != stackSegment) { // No need to repeat this one
 			debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
 			if (reg.getSegment() < heap.size() && heap[reg.getSegment()]) {
+				// An incremental collection may still hold references which
+				// the game freed meanwhile
+				if (skipInvalid && !heap[reg.getSegment()]->isValidOffset(reg.getOffset()))
+					continue;
+
 				// Valid heap object? Find its outgoing references!
 				wm.pushArray(heap[reg.getSegment()]->listAllOutgoingReferences(reg));
 			}
 		}
 	}
+	return true;
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRootSet(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -169,8 +215,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRootSet(s, wm);
 
-	processWorkList(s->_segMan, wm, heap);
+	processWorkList(s->_segMan, wm, s->_segMan->getSegments());
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
@@ -178,20 +230,19 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
-
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
+/**
+ * Frees everything deallocatable which is not in activeRefs. Segments
+ * allocated during an incremental collection are left alone.
+ * @return the number of freed objects
+ */
+static uint freeUnreachable(SegManager *segMan, const AddrSet &activeRefs) {
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
 	memset(segnames, 0, sizeof(segnames));
 	memset(segcount, 0, sizeof(segcount));
 #endif
-
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	uint freed = 0;
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
@@ -199,7 +250,7 @@ void run_gc(EngineState *s) {
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
-		if (mobj != nullptr) {
+		if (mobj != nullptr && !segMan->isGCNewSegment(seg)) {
 #ifdef GC_DEBUG_CODE
 			const SegmentType type = mobj->getType();
 			segnames[type] = segmentTypeNames[type];
@@ -210,10 +261,11 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					freed++;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
@@ -223,8 +275,6 @@ void run_gc(EngineState *s) {
 		}
 	}
 
-	delete activeRefs;
-
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -232,6 +282,137 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
+}
+
+static GCState &getGCState(EngineState *s) {
+	if (!s->_gcState)
+		s->_gcState = new GCState();
+	return *s->_gcState;
+}
+
+void run_gc(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCState &gc = getGCState(s);
+	const uint32 startTime = g_system->getMillis(true);
+
+	// Some debug stuff
+	debugC(kDebugLevelGC, "[GC] Running...");
+
+	// A full collection makes a running incremental one pointless
+	segMan->stopGCBarrier();
+	gc.wm.clear();
+	gc.marked = false;
+
+	// Compute the set of all segments references currently in use.
+	AddrSet *activeRefs = findAllActiveReferences(s);
+
+	gc.freed = freeUnreachable(segMan, *activeRefs);
+	gc.collections++;
+
+	delete activeRefs;
+
+	gc.fullPauses.add(g_system->getMillis(true) - startTime);
+}
+
+void startIncrementalGC(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCState &gc = getGCState(s);
+
+	if (segMan->isGCBarrierActive()) {
+		// Still not done with the previous collection
+		finishIncrementalGC(s);
+		return;
+	}
+
+	const uint32 startTime = g_system->getMillis(true);
+	debugC(kDebugLevelGC, "[GC] Starting incremental collection");
+
+	gc.wm.clear();
+	gc.marked = false;
+	segMan->startGCBarrier();
+
+	// The VM keeps pointers to the variables of the running methods, and
+	// writes through these are not seen by the barrier. Record the
+	// objects and locals as modified right away instead; methods invoked
+	// later look them up through the segment manager.
+	for (Common::List<ExecStack>::const_iterator iter = s->_executionStack.begin(); iter != s->_executionStack.end(); ++iter) {
+		if (iter->type != EXEC_STACK_TYPE_KERNEL) {
+			segMan->gcObjectBarrier(iter->objp);
+			segMan->gcSegmentBarrier(iter->local_segment);
+		}
+	}
+	segMan->gcSegmentBarrier(s->variablesSegment[VAR_GLOBAL]);
+
+	pushRootSet(s, gc.wm);
+
+	gc.startPauses.add(g_system->getMillis(true) - startTime);
+}
+
+void stepIncrementalGC(EngineState *s) {
+	GCState *gc = s->_gcState;
+	if (!gc || gc->marked || !s->_segMan->isGCBarrierActive())
+		return;
+
+	const uint32 startTime = g_system->getMillis(true);
+
+	gc->marked = processWorkList(s->_segMan, gc->wm, s->_segMan->getSegments(), kGCStepReferences, true);
+
+	gc->stepPauses.add(g_system->getMillis(true) - startTime);
+}
+
+bool isIncrementalGCMarked(EngineState *s) {
+	return s->_gcState && s->_gcState->marked && s->_segMan->isGCBarrierActive();
+}
+
+void finishIncrementalGC(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	GCState &gc = getGCState(s);
+
+	if (!segMan->isGCBarrierActive()) {
+		// The heap has been reset meanwhile
+		gc.wm.clear();
+		gc.marked = false;
+		return;
+	}
+
+	const uint32 startTime = g_system->getMillis(true);
+	debugC(kDebugLevelGC, "[GC] Finishing incremental collection");
+
+	WorklistManager &wm = gc.wm;
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+
+	// Everything the game modified may have gained references to objects
+	// which have not been marked. Segments handed out as a whole have all
+	// their marked objects scanned again. Scripts and locals nobody
+	// touched are skipped.
+	Common::Array<reg_t> rescans;
+	for (AddrSet::const_iterator i = wm._map.begin(); i != wm._map.end(); ++i) {
+		if (segMan->isGCModifiedSegment(i->_key.getSegment()))
+			rescans.push_back(i->_key);
+	}
+	for (AddrSet::const_iterator i = segMan->getGCModifiedObjects().begin(); i != segMan->getGCModifiedObjects().end(); ++i)
+		rescans.push_back(i->_key);
+	for (uint i = 0; i < rescans.size(); i++)
+		wm.rescan(rescans[i]);
+
+	pushRootSet(s, wm);
+	processWorkList(segMan, wm, heap, 0, true);
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(wm);
+
+	AddrSet *activeRefs = normalizeAddresses(segMan, wm._map);
+	gc.freed = freeUnreachable(segMan, *activeRefs);
+	gc.collections++;
+	delete activeRefs;
+
+	segMan->stopGCBarrier();
+	wm.clear();
+	gc.marked = false;
+
+	gc.finishPauses.add(g_system->getMillis(true) - startTime);
 }
 
 } // End of namespace Sci
@@ -29,18 +29,6 @@
 
 namespace Sci {
 
-struct reg_t_Hash {
-	uint operator()(const reg_t& x) const {
-		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
-	}
-};
-
-/*
- * The AddrSet is a "set" of reg_t values.
- * We don't have a HashSet type, so we abuse a HashMap for this.
- */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
-
 /**
  * Finds all used references and normalises them to their memory addresses
  * @param s The state to gather all information from
@@ -54,12 +42,86 @@ AddrSet *findAllActiveReferences(EngineState *s);
  */
 void run_gc(EngineState *s);
 
+/**
+ * Starts an incremental garbage collection. Its marking continues in
+ * stepIncrementalGC(), and finishIncrementalGC() frees the garbage.
+ * If a collection is still running, it is finished instead.
+ * @param s The state in which we should gc
+ */
+void startIncrementalGC(EngineState *s);
+
+/**
+ * Marks a limited number of references of the running incremental
+ * garbage collection, if any.
+ * @param s The state in which we should gc
+ */
+void stepIncrementalGC(EngineState *s);
+
+/**
+ * Checks whether the running incremental garbage collection has marked
+ * everything and is ready to be finished.
+ * @param s The state in which we should gc
+ */
+bool isIncrementalGCMarked(EngineState *s);
+
+/**
+ * Finishes the running incremental garbage collection, if any: marks
+ * everything changed since it started and frees the garbage.
+ * @param s The state in which we should gc
+ */
+void finishIncrementalGC(EngineState *s);
+
 struct WorklistManager {
 	Common::Array<reg_t> _worklist;
 	AddrSet _map;	// used for 2 contains() calls, inside push() and run_gc()
 
 	void push(reg_t reg);
 	void pushArray(const Common::Array<reg_t> &tmp);
+
+	/** Scans a reference again, even if it has already been seen */
+	void rescan(reg_t reg);
+	void clear();
+};
+
+/**
+ * Histogram of garbage collection pauses, in power of two millisecond
+ * buckets: < 1ms, 1ms, 2-3ms, 4-7ms, ..., >= 64ms.
+ */
+struct GCPauseHistogram {
+	enum {
+		kBuckets = 8
+	};
+
+	uint32 count[kBuckets];
+	uint32 total; ///< Sum of all pauses in milliseconds
+	uint32 max;   ///< Longest pause in milliseconds
+
+	GCPauseHistogram() { reset(); }
+
+	void reset();
+	void add(uint32 millis);
+};
+
+/**
+ * State of the incremental garbage collector. It marks the reachable
+ * objects in small steps from kGetEvent and kFrameOut, while the write
+ * barrier of the segment manager records everything the game modifies
+ * meanwhile. Only these are scanned again in the final pause, before
+ * anything is freed.
+ */
+struct GCState {
+	WorklistManager wm;
+	bool marked; ///< Everything reachable has been marked
+
+	uint32 collections; ///< Number of finished collections
+	uint32 freed;       ///< Objects freed by the last collection
+
+	GCPauseHistogram fullPauses;   ///< Stop-the-world collections
+	GCPauseHistogram startPauses;  ///< Root set scans of incremental collections
+	GCPauseHistogram stepPauses;   ///< Incremental marking steps
+	GCPauseHistogram finishPauses; ///< Final marking and freeing
+
+	GCState() : marked(false), collections(0), freed(0) {}
 };
 
 
@@ -271,6 +271,15 @@ reg_t kScriptID(EngineState *s, int argc, reg_t *argv) {
 	if (argv[0].getSegment())
 		return argv[0];
 
+	// Loading the script of a new room: let the resources that the room is
+	// most likely to show get unpacked in the background while its script
+	// gets initialized
+	if (script == s->currentRoomNumber() && !s->_segMan->getScriptSegment(script)) {
+		ResourceManager *resMan = g_sci->getResMan();
+		resMan->prefetchResource(ResourceId(kResourceTypePic, script));
+		resMan->prefetchResource(ResourceId(kResourceTypePalette, script));
+	}
+
 	SegmentId scriptSeg = s->_segMan->getScriptSegment(script, SCRIPT_GET_LOAD);
 
 	if (!scriptSeg)
@@ -516,6 +516,9 @@ void HunkTable::saveLoadWithSerializer(Common::Serializer &s) {
 }
 
 void Script::syncStringHeap(Common::Serializer &s) {
+	if (s.isLoading())
+		invalidatePredecodedInstructions();
+
 	if (getSciVersion() < SCI_VERSION_1_1) {
 		// Sync all of the SCI_OBJ_STRINGS blocks
 		SciSpan<byte> buf = *_buf;
@@ -27,6 +27,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/script.h"
+#include "sci/engine/vm.h"
 
 #include "common/util.h"
 
@@ -74,6 +75,30 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	invalidatePredecodedInstructions();
+}
+
+const PredecodedInstruction &Script::predecodeInstruction(uint32 offset) {
+	// The indices are 16-bit. Large SCI3 scripts could run out of them, in
+	// which case decoding starts over.
+	if (_predecoded.size() >= kNotPredecoded)
+		invalidatePredecodedInstructions();
+
+	if (_predecodedIndex.empty())
+		_predecodedIndex.resize(_buf->size(), kNotPredecoded);
+
+	PredecodedInstruction instruction;
+	instruction.size = readPMachineInstruction(_buf->getUnsafeDataAt(offset), instruction.extOpcode, instruction.opparams);
+
+	_predecodedIndex[offset] = _predecoded.size();
+	_predecoded.push_back(instruction);
+	return _predecoded.back();
+}
+
+void Script::invalidatePredecodedInstructions() {
+	_predecodedIndex.clear();
+	_predecoded.clear();
 }
 
 enum {
@@ -149,8 +174,10 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	}
 
 	// Check scripts (+ possibly SCI 1.1 heap) for matching signatures and patch those, if found
-	if (applyScriptPatches)
+	if (applyScriptPatches) {
 		scriptPatcher->processScript(_nr, outBuffer);
+		invalidatePredecodedInstructions();
+	}
 
 	if (getSciVersion() <= SCI_VERSION_1_LATE) {
 		// Some buggy game scripts contain two export tables (e.g. script 912
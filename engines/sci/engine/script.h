@@ -68,6 +68,16 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/**
+ * A bytecode instruction with its operands already decoded, as cached by
+ * Script::getPredecodedInstruction().
+ */
+struct PredecodedInstruction {
+	int16 opparams[4]; ///< operands, as returned by readPMachineInstruction()
+	uint16 size;       ///< size of the encoded instruction in bytes
+	byte extOpcode;    ///< opcode, including the operand size bit
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -101,6 +111,19 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	enum {
+		kNotPredecoded = 0xFFFF ///< _predecodedIndex entry of offsets which were not decoded yet
+	};
+
+	/**
+	 * Maps the offset of each instruction executed so far to its index in
+	 * _predecoded, or kNotPredecoded if the instruction was not decoded yet.
+	 */
+	Common::Array<uint16> _predecodedIndex;
+	Common::Array<PredecodedInstruction> _predecoded;
+
+	const PredecodedInstruction &predecodeInstruction(uint32 offset);
+
 public:
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
@@ -131,6 +154,28 @@ public:
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
 	}
 
+	/**
+	 * Returns the instruction at the given offset with its operands decoded.
+	 * Instructions are decoded once on first execution and kept until the
+	 * script is unloaded or invalidatePredecodedInstructions() is called.
+	 * The returned reference is only valid until the next call.
+	 */
+	const PredecodedInstruction &getPredecodedInstruction(uint32 offset) {
+		// speed optimization: inline due to being called for every opcode
+		if (offset < _predecodedIndex.size()) {
+			const uint16 index = _predecodedIndex[offset];
+			if (index != kNotPredecoded)
+				return _predecoded[index];
+		}
+		return predecodeInstruction(offset);
+	}
+
+	/**
+	 * Drops all predecoded instructions. Must be called whenever the bytecode
+	 * of the script is modified after it has been executed.
+	 */
+	void invalidatePredecodedInstructions();
+
 public:
 	Script();
 	~Script() override;
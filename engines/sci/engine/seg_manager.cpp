@@ -31,7 +31,7 @@ namespace Sci {
 
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
-	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	: _resMan(resMan), _scriptPatcher(scriptPatcher), _gcBarrierActive(false) {
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -55,6 +55,9 @@ SegManager::~SegManager() {
 }
 
 void SegManager::resetSegMan() {
+	// A running incremental collection refers to the old heap
+	stopGCBarrier();
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -122,10 +125,32 @@ SegmentId SegManager::allocSegment(SegmentObj *mobj) {
 		_heap.push_back(0);
 	}
 	_heap[id] = mobj;
+	if (_gcBarrierActive)
+		markGCSegment(id, kGCSegmentNew);
 
 	return id;
 }
 
+void SegManager::startGCBarrier() {
+	_gcModifiedObjects.clear();
+	_gcSegmentFlags.clear();
+	_gcSegmentFlags.resize(_heap.size());
+	_gcBarrierActive = true;
+}
+
+void SegManager::stopGCBarrier() {
+	_gcBarrierActive = false;
+	_gcModifiedObjects.clear(true);
+	_gcSegmentFlags.clear();
+}
+
+void SegManager::markGCSegment(SegmentId seg, byte flags) const {
+	seg = getActualSegment(seg);
+	if (seg >= _gcSegmentFlags.size())
+		_gcSegmentFlags.resize(seg + 1);
+	_gcSegmentFlags[seg] |= flags;
+}
+
 Script *SegManager::allocateScript(int script_nr, SegmentId &segid) {
 	// Check if the script already has an allocated segment. If it
 	// does, return that segment.
@@ -206,6 +231,8 @@ Script *SegManager::getScript(const SegmentId seg) {
 	if (mobj->getType() != SEG_TYPE_SCRIPT) {
 		error("SegManager::getScript(): seg id %x refers to type %d != SEG_TYPE_SCRIPT", actualSegment, mobj->getType());
 	}
+	gcSegmentBarrier(actualSegment);
+	gcSegmentBarrier(((Script *)mobj)->getLocalsSegment());
 	return (Script *)mobj;
 }
 
@@ -218,6 +245,8 @@ Script *SegManager::getScriptIfLoaded(const SegmentId seg) const {
 	if (mobj == nullptr || mobj->getType() != SEG_TYPE_SCRIPT) {
 		return nullptr;
 	}
+	gcSegmentBarrier(actualSegment);
+	gcSegmentBarrier(((Script *)mobj)->getLocalsSegment());
 	return (Script *)mobj;
 }
 
@@ -232,6 +261,7 @@ SegmentObj *SegManager::getSegmentObj(SegmentId seg) const {
 	SegmentId actualSegment = getActualSegment(seg);
 	if (actualSegment < 1 || actualSegment >= _heap.size() || !_heap[actualSegment])
 		return nullptr;
+	gcSegmentBarrier(actualSegment);
 	return _heap[actualSegment];
 }
 
@@ -245,11 +275,17 @@ SegmentType SegManager::getSegmentType(SegmentId seg) const {
 SegmentObj *SegManager::getSegment(SegmentId seg, SegmentType type) const {
 	SegmentId actualSegment = getActualSegment(seg);
 	SegmentType actualSegmentType = getSegmentType(actualSegment);
-	return (actualSegmentType == type) ? _heap[actualSegment] : nullptr;
+	if (actualSegmentType != type)
+		return nullptr;
+	gcSegmentBarrier(actualSegment);
+	return _heap[actualSegment];
 }
 
 Object *SegManager::getObject(reg_t pos) const {
-	SegmentObj *mobj = getSegmentObj(pos.getSegment());
+	// Not using getSegmentObj(), the barrier only needs to know about the
+	// object itself
+	const SegmentId actualSegment = getActualSegment(pos.getSegment());
+	SegmentObj *mobj = (actualSegment >= 1 && actualSegment < _heap.size()) ? _heap[actualSegment] : nullptr;
 	Object *obj = nullptr;
 
 	if (mobj != nullptr) {
@@ -268,6 +304,8 @@ Object *SegManager::getObject(reg_t pos) const {
 		}
 	}
 
+	if (obj)
+		gcObjectBarrier(pos);
 	return obj;
 }
 
@@ -461,6 +499,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	int offset = table->allocEntry();
 
 	reg_t addr = make_reg(_hunksSegId, offset);
+	gcObjectBarrier(addr);
 	Hunk &h = table->at(offset);
 
 	h.mem = malloc(size);
@@ -494,6 +533,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	gcObjectBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -510,6 +550,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	gcObjectBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -526,6 +567,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	gcObjectBarrier(*addr);
 	return &table->at(offset);
 }
 
@@ -552,6 +594,7 @@ List *SegManager::lookupList(reg_t addr) {
 		return nullptr;
 	}
 
+	gcObjectBarrier(addr);
 	return &(lt[addr.getOffset()]);
 }
 
@@ -576,6 +619,7 @@ Node *SegManager::lookupNode(reg_t addr, bool stopOnDiscarded) {
 		return nullptr;
 	}
 
+	gcObjectBarrier(addr);
 	return &(nt[addr.getOffset()]);
 }
 
@@ -588,6 +632,7 @@ SegmentRef SegManager::dereference(reg_t pointer) {
 		return ret; /* Invalid */
 	}
 
+	gcSegmentBarrier(pointer.getSegment());
 	SegmentObj *mobj = _heap[pointer.getSegment()];
 	return mobj->dereference(pointer);
 }
@@ -952,6 +997,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	gcObjectBarrier(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -968,6 +1014,7 @@ SciArray *SegManager::lookupArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	gcObjectBarrier(addr);
 	return &(arrayTable[addr.getOffset()]);
 }
 
@@ -1008,6 +1055,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	int offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	gcObjectBarrier(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
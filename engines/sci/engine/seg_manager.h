@@ -23,6 +23,7 @@
 #define SCI_ENGINE_SEG_MANAGER_H
 
 #include "common/scummsys.h"
+#include "common/hashmap.h"
 #include "common/serializer.h"
 #include "sci/engine/script.h"
 #include "sci/engine/vm.h"
@@ -45,6 +46,18 @@ enum ScriptLoadType {
 
 class Script;
 
+struct reg_t_Hash {
+	uint operator()(const reg_t& x) const {
+		return (x.getSegment() << 3) ^ x.getOffset() ^ (x.getOffset() << 16);
+	}
+};
+
+/*
+ * The AddrSet is a "set" of reg_t values.
+ * We don't have a HashSet type, so we abuse a HashMap for this.
+ */
+typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+
 class SegManager : public Common::Serializable {
 	friend class Console;
 public:
@@ -460,7 +473,67 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	// Incremental garbage collection
+
+	/**
+	 * Starts the write barrier of the incremental garbage collector.
+	 *
+	 * While it is active, every object and segment handed out for
+	 * modification is recorded, as well as everything newly allocated.
+	 * The collector scans all of these again before freeing anything.
+	 */
+	void startGCBarrier();
+
+	/**
+	 * Stops the write barrier and forgets everything it recorded.
+	 */
+	void stopGCBarrier();
+
+	bool isGCBarrierActive() const { return _gcBarrierActive; }
+
+	/**
+	 * Records an object as modified while the barrier is active.
+	 */
+	void gcObjectBarrier(reg_t addr) const {
+		if (_gcBarrierActive)
+			_gcModifiedObjects.setVal(addr, true);
+	}
+
+	/**
+	 * Records a whole segment as modified while the barrier is active.
+	 */
+	void gcSegmentBarrier(SegmentId seg) const {
+		if (_gcBarrierActive)
+			markGCSegment(seg, kGCSegmentModified);
+	}
+
+	/** Objects recorded since the barrier was started. */
+	const AddrSet &getGCModifiedObjects() const { return _gcModifiedObjects; }
+
+	/** Whether a segment was modified as a whole since the barrier was started. */
+	bool isGCModifiedSegment(SegmentId seg) const {
+		seg = getActualSegment(seg);
+		return seg < _gcSegmentFlags.size() && (_gcSegmentFlags[seg] & kGCSegmentModified);
+	}
+
+	/** Whether a segment was allocated since the barrier was started. */
+	bool isGCNewSegment(SegmentId seg) const {
+		seg = getActualSegment(seg);
+		return seg < _gcSegmentFlags.size() && (_gcSegmentFlags[seg] & kGCSegmentNew);
+	}
+
 private:
+	enum {
+		kGCSegmentModified = 1 << 0,
+		kGCSegmentNew = 1 << 1
+	};
+
+	void markGCSegment(SegmentId seg, byte flags) const;
+
+	bool _gcBarrierActive;
+	mutable AddrSet _gcModifiedObjects;
+	mutable Common::Array<byte> _gcSegmentFlags;
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
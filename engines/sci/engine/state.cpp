@@ -24,6 +24,7 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/features.h"
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -68,6 +69,7 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
+	_gcState(nullptr),
 	_msgState(nullptr),
 	_dirseeker() {
 
@@ -76,6 +78,7 @@ EngineState::EngineState(SegManager *segMan) :
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _gcState;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -119,6 +122,7 @@ void EngineState::reset(bool isRestoring) {
 
 	scriptStepCounter = 0;
 	scriptGCInterval = GC_INTERVAL;
+	gcIncremental = false;
 }
 
 void EngineState::speedThrottler(uint32 neededSleep) {
@@ -44,6 +44,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+struct GCState;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -188,6 +189,8 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	bool gcIncremental; /**< Spread the marking of the gc across frames (off by default, set from the console) */
+	GCState *_gcState; /**< Incremental gc state and pause statistics */
 
 	MessageState *_msgState;
 
@@ -510,6 +510,20 @@ int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4])
 	return offset;
 }
 
+/**
+ * Checks that a cached instruction still matches the bytecode it was decoded
+ * from, for the verify_predecode console variable.
+ */
+static void verifyPredecodedInstruction(const Script *scr, uint32 offset, const PredecodedInstruction &instruction) {
+	byte extOpcode;
+	int16 opparams[4];
+	const int size = readPMachineInstruction(scr->getBuf(offset), extOpcode, opparams);
+
+	if (size != instruction.size || extOpcode != instruction.extOpcode || memcmp(opparams, instruction.opparams, sizeof(opparams)))
+		error("run_vm(): predecoded instruction at %d:%04x does not match the script, opcode %02x (expected %02x)",
+			scr->getScriptNumber(), offset, instruction.extOpcode, extOpcode);
+}
+
 uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffset) {
 	uint32 offset;
 
@@ -543,7 +557,6 @@ void run_vm(EngineState *s) {
 	int temp;
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
-	int16 opparams[4]; // opcode parameters
 
 	s->r_rest = 0;	// &rest adjusts the parameter count by this value
 	// Current execution data:
@@ -621,8 +634,14 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		// The instruction is copied, as nested calls into the VM may add new
+		// instructions to the cache of the same script
+		const PredecodedInstruction instruction = scr->getPredecodedInstruction(s->xs->addr.pc.getOffset());
+		if (g_debug_verify_predecode)
+			verifyPredecodedInstruction(scr, s->xs->addr.pc.getOffset(), instruction);
+		s->xs->addr.pc.incOffset(instruction.size);
+		const int16 *opparams = instruction.opparams;
+		const byte extOpcode = instruction.extOpcode;
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -847,10 +866,16 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
+			// Run the garbage collector, if needed. Incremental collections
+			// mark in kGetEvent and kFrameOut, and free the garbage here.
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->gcIncremental)
+					startIncrementalGC(s);
+				else
+					run_gc(s);
+			} else if (isIncrementalGCMarked(s)) {
+				finishIncrementalGC(s);
 			}
 
 			// Call kernel function
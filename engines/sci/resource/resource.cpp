@@ -26,6 +26,7 @@
 #include "common/fs.h"
 #include "common/macresman.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
 #include "common/compression/installshield_cab.h"
@@ -210,9 +211,18 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_packedData = nullptr;
+	_unpackJob = nullptr;
+	_packedSize = 0;
+	_unpackedSize = 0;
+	_compression = kCompUnknown;
 }
 
 Resource::~Resource() {
+	if (_unpackJob)
+		_resMan->discardUnpackJob(this);
+	if (_packedData)
+		_resMan->removeFromPackedCache(this);
 	delete[] _data;
 	delete[] _header;
 	if (_source && _source->getSourceType() == kSourcePatch)
@@ -419,7 +429,21 @@ void ResourceManager::disposeVolumeFileStream(Common::SeekableReadStream *fileSt
 }
 
 void ResourceManager::loadResource(Resource *res) {
-	res->_source->loadResource(this, res);
+	if (res->_packedData) {
+		// The compressed data is still in memory, so the volume file does not
+		// need to be read again
+		_cacheUnpacks++;
+		touchPackedCache(res);
+		int error = res->unpackCachedData();
+		if (error) {
+			warning("Error %d occurred while unpacking %s: %s",
+					error, res->_id.toString().c_str(), s_errorDescriptions[error]);
+			res->unalloc();
+		}
+	} else {
+		_cacheDiskLoads++;
+		res->_source->loadResource(this, res);
+	}
 	if (_patcher) {
 		_patcher->applyPatch(*res);
 	};
@@ -437,6 +461,7 @@ void PatchResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 }
 
 static Common::Array<uint32> resTypeToMacTags(ResourceType type);
+static int unpackResourceData(const ResourceId &id, ResourceCompression compression, Common::ReadStream *src, byte *dest, uint32 szPacked, uint32 szUnpacked);
 
 void MacResourceForkResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 	ResourceType type = res->getType();
@@ -596,14 +621,14 @@ Common::SeekableReadStream *ResourceSource::getVolumeFile(ResourceManager *resMa
 	return fileStream;
 }
 
-void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
+Common::SeekableReadStream *ResourceSource::getResourceStream(ResourceManager *resMan, Resource *res, ResVersion &volVersion) {
 	Common::SeekableReadStream *fileStream = getVolumeFile(resMan, res);
 	if (!fileStream)
-		return;
+		return nullptr;
 
 	fileStream->seek(0, SEEK_SET);
 	ResourceType type = resMan->convertResType(fileStream->readByte());
-	ResVersion volVersion = resMan->getVolVersion();
+	volVersion = resMan->getVolVersion();
 
 	// FIXME: if resource.msg has different version from SCI, this has to be modified.
 	if (
@@ -614,6 +639,14 @@ void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 		g_sci && g_sci->getLanguage() == Common::KO_KOR)
 		volVersion = kResVersionSci11;
 	fileStream->seek(res->_fileOffset, SEEK_SET);
+	return fileStream;
+}
+
+void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
+	ResVersion volVersion;
+	Common::SeekableReadStream *fileStream = getResourceStream(resMan, res, volVersion);
+	if (!fileStream)
+		return;
 
 	int error = res->decompress(volVersion, fileStream);
 	if (error) {
@@ -626,6 +659,22 @@ void ResourceSource::loadResource(ResourceManager *resMan, Resource *res) {
 	resMan->disposeVolumeFileStream(fileStream, this);
 }
 
+void ResourceSource::loadPackedData(ResourceManager *resMan, Resource *res) {
+	ResVersion volVersion;
+	Common::SeekableReadStream *fileStream = getResourceStream(resMan, res, volVersion);
+	if (!fileStream)
+		return;
+
+	int error = res->loadPackedData(volVersion, fileStream);
+	if (error) {
+		warning("Error %d occurred while reading %s from resource file %s: %s",
+				error, res->_id.toString().c_str(), res->getResourceLocation().toString().c_str(),
+				s_errorDescriptions[error]);
+	}
+
+	resMan->disposeVolumeFileStream(fileStream, this);
+}
+
 Resource *ResourceManager::testResource(const ResourceId &id) const {
 	return _resMap.getValOrDefault(id, NULL);
 }
@@ -1007,9 +1056,17 @@ ResourceManager::ResourceManager(const bool detectionMode) :
 
 void ResourceManager::init() {
 	_maxMemoryLRU = 256 * 1024; // 256KiB
+	_maxMemoryPacked = 128 * 1024; // 128KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_memoryPacked = 0;
+	_packedLRU.clear();
+	_cacheHits = 0;
+	_cacheUnpacks = 0;
+	_cacheDiskLoads = 0;
+	_cachePrefetches = 0;
+	_unpackJobs.clear();
 	_resMap.clear();
 	_audioMapSCI1 = nullptr;
 #ifdef ENABLE_SCI32
@@ -1081,6 +1138,7 @@ void ResourceManager::init() {
 	// and making the renderer very slow.
 	if (getSciVersion() >= SCI_VERSION_2) {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
+		_maxMemoryPacked = 2048 * 1024; // 2MiB
 	}
 
 	switch (_viewType) {
@@ -1109,6 +1167,8 @@ void ResourceManager::init() {
 }
 
 ResourceManager::~ResourceManager() {
+	finishUnpackJobs(true);
+
 	// freeing resources
 	ResourceMap::iterator itr = _resMap.begin();
 	while (itr != _resMap.end()) {
@@ -1129,7 +1189,7 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+	_LRU.erase(res->_lruPosition);
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
@@ -1140,6 +1200,7 @@ void ResourceManager::addToLRU(Resource *res) {
 		return;
 	}
 	_LRU.push_front(res);
+	res->_lruPosition = _LRU.begin();
 	_memoryLRU += res->size();
 #ifdef SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1149,10 +1210,40 @@ void ResourceManager::addToLRU(Resource *res) {
 	res->_status = kResStatusEnqueued;
 }
 
+enum {
+	/** Number of least recently used resources considered for eviction */
+	kLRUEvictionWindow = 4,
+	/** Cost of reading a byte from a resource file, relative to unpacking a byte */
+	kDiskReadCost = 4
+};
+
+uint ResourceManager::getRestoreCost(const Resource *res) const {
+	// Estimated work needed to bring the resource back into memory, per byte
+	// of memory that is freed by unloading it
+	uint64 cost = 0;
+	if (res->_compression != kCompNone && res->_compression != kCompUnknown)
+		cost += res->size();
+	if (!res->_packedData)
+		cost += (uint64)(res->_packedSize ? res->_packedSize : res->size()) * kDiskReadCost;
+	return (uint)(cost * 16 / MAX<uint32>(res->size(), 1));
+}
+
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		// Of the least recently used resources, drop the one which is the
+		// cheapest to bring back
+		Common::List<Resource *>::iterator it = _LRU.reverse_begin();
+		Resource *goner = *it;
+		uint gonerCost = getRestoreCost(goner);
+		for (int i = 1; i < kLRUEvictionWindow && it != _LRU.begin(); ++i) {
+			--it;
+			const uint cost = getRestoreCost(*it);
+			if (cost < gonerCost) {
+				goner = *it;
+				gonerCost = cost;
+			}
+		}
 		removeFromLRU(goner);
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
@@ -1161,6 +1252,162 @@ void ResourceManager::freeOldResources() {
 	}
 }
 
+void ResourceManager::addToPackedCache(Resource *res, byte *packedData, uint32 packedSize, ResourceCompression compression) {
+	removeFromPackedCache(res);
+	res->_packedData = packedData;
+	res->_packedSize = packedSize;
+	res->_compression = compression;
+	_packedLRU.push_front(res);
+	res->_packedPosition = _packedLRU.begin();
+	_memoryPacked += packedSize;
+
+	freeOldPackedData();
+}
+
+void ResourceManager::touchPackedCache(Resource *res) {
+	_packedLRU.erase(res->_packedPosition);
+	_packedLRU.push_front(res);
+	res->_packedPosition = _packedLRU.begin();
+}
+
+void ResourceManager::removeFromPackedCache(Resource *res) {
+	if (!res->_packedData)
+		return;
+	if (res->_unpackJob)
+		finishUnpackJob(res);
+	_packedLRU.erase(res->_packedPosition);
+	_memoryPacked -= res->_packedSize;
+	delete[] res->_packedData;
+	res->_packedData = nullptr;
+}
+
+void ResourceManager::freeOldPackedData() {
+	while (_maxMemoryPacked < _memoryPacked) {
+		assert(!_packedLRU.empty());
+		removeFromPackedCache(*_packedLRU.reverse_begin());
+	}
+}
+
+bool ResourceManager::canCachePackedData(const Resource *res, ResourceCompression compression, uint32 packedSize) const {
+	return compression != kCompNone && res->getType() != kResourceTypeAudio && packedSize <= (uint32)_maxMemoryPacked;
+}
+
+/** Unpacking of a prefetched resource on a worker thread */
+struct ResourceUnpackJob {
+	Common::WorkerPool::JobGroup group;
+	ResourceId id;
+	ResourceCompression compression;
+	const byte *packedData;
+	uint32 packedSize;
+	byte *data;
+	uint32 size;
+	int error;
+};
+
+static void runUnpackJob(void *param) {
+	ResourceUnpackJob *job = (ResourceUnpackJob *)param;
+	Common::MemoryReadStream packedStream(job->packedData, job->packedSize);
+	job->error = unpackResourceData(job->id, job->compression, &packedStream, job->data, job->packedSize, job->size);
+}
+
+void ResourceManager::prefetchResource(ResourceId id) {
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+	if (!pool.getNumThreads())
+		return;
+
+	Resource *res = testResource(id);
+	if (!res || res->_status != kResStatusNoMalloc || res->_unpackJob || res->_source->getSourceType() != kSourceVolume)
+		return;
+
+	// The volume files are not thread-safe, so the compressed data is read
+	// here and only unpacking is left to the worker thread
+	if (res->_packedData) {
+		touchPackedCache(res);
+	} else {
+		res->_source->loadPackedData(this, res);
+		if (!res->_packedData)
+			return;
+	}
+
+	ResourceUnpackJob *job = new ResourceUnpackJob();
+	job->id = res->_id;
+	job->compression = res->_compression;
+	job->packedData = res->_packedData;
+	job->packedSize = res->_packedSize;
+	job->data = new byte[res->_unpackedSize];
+	job->size = res->_unpackedSize;
+	job->error = SCI_ERROR_NONE;
+
+	res->_unpackJob = job;
+	_unpackJobs.push_back(res);
+	pool.submit(job->group, runUnpackJob, job);
+}
+
+void ResourceManager::finishUnpackJob(Resource *res) {
+	ResourceUnpackJob *job = res->_unpackJob;
+	Common::WorkerPool::instance().wait(job->group);
+	res->_unpackJob = nullptr;
+	_unpackJobs.remove(res);
+
+	if (job->error) {
+		warning("Error %d occurred while unpacking %s: %s",
+				job->error, res->_id.toString().c_str(), s_errorDescriptions[job->error]);
+		delete[] job->data;
+	} else if (res->_status == kResStatusNoMalloc) {
+		res->_data = job->data;
+		res->_size = job->size;
+		res->_status = kResStatusAllocated;
+		_cachePrefetches++;
+		if (_patcher)
+			_patcher->applyPatch(*res);
+		addToLRU(res);
+	} else {
+		delete[] job->data;
+	}
+
+	delete job;
+}
+
+void ResourceManager::discardUnpackJob(Resource *res) {
+	ResourceUnpackJob *job = res->_unpackJob;
+	Common::WorkerPool::instance().wait(job->group);
+	res->_unpackJob = nullptr;
+	_unpackJobs.remove(res);
+	delete[] job->data;
+	delete job;
+}
+
+void ResourceManager::finishUnpackJobs(bool wait) {
+	Common::List<Resource *>::iterator it = _unpackJobs.begin();
+	while (it != _unpackJobs.end()) {
+		Resource *res = *it;
+		++it;
+		if (wait || Common::WorkerPool::instance().isDone(res->_unpackJob->group))
+			finishUnpackJob(res);
+	}
+}
+
+ResourceCacheStatistics ResourceManager::getCacheStatistics() const {
+	ResourceCacheStatistics stats;
+	stats.memoryLocked = _memoryLocked;
+	stats.memoryLRU = _memoryLRU;
+	stats.maxMemoryLRU = _maxMemoryLRU;
+	stats.memoryPacked = _memoryPacked;
+	stats.maxMemoryPacked = _maxMemoryPacked;
+	stats.hits = _cacheHits;
+	stats.unpacks = _cacheUnpacks;
+	stats.diskLoads = _cacheDiskLoads;
+	stats.prefetches = _cachePrefetches;
+	return stats;
+}
+
+void ResourceManager::setCacheBudgets(int maxMemoryLRU, int maxMemoryPacked) {
+	_maxMemoryLRU = maxMemoryLRU;
+	_maxMemoryPacked = maxMemoryPacked;
+	freeOldResources();
+	freeOldPackedData();
+}
+
 Common::List<ResourceId> ResourceManager::listResources(ResourceType type, int mapNumber) {
 	Common::List<ResourceId> resources;
 
@@ -1197,9 +1444,20 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return nullptr;
 
+	// Only wait for the resource itself if it is still being unpacked, and
+	// pick up any other prefetched resources which are done
+	if (!_unpackJobs.empty()) {
+		if (retval->_unpackJob)
+			finishUnpackJob(retval);
+		finishUnpackJobs(false);
+	}
+
 	if (retval->_status == kResStatusNoMalloc)
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+	else
+		_cacheHits++;
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -2243,6 +2501,16 @@ Resource *ResourceManager::updateResource(ResourceId resId, ResourceSource *src,
 			_resMap.setVal(resId, res);
 		}
 
+		// Neither a pending prefetch nor the compressed data cached for the
+		// old source are valid anymore
+		if (res->_unpackJob)
+			discardUnpackJob(res);
+		removeFromPackedCache(res);
+		// A prefetch which finished earlier left its data in the LRU
+		if (res->_status == kResStatusEnqueued) {
+			removeFromLRU(res);
+			res->unalloc();
+		}
 		res->_status = kResStatusNoMalloc;
 		res->_source = src;
 		res->_headerSize = 0;
@@ -2368,6 +2636,64 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 	if (errorNum)
 		return errorNum;
 
+	// Keep the data of compressed resources around, so that they can be
+	// unpacked again without reading the volume file after being freed
+	if (_resMan->canCachePackedData(this, compression, szPacked)) {
+		errorNum = readPackedData(file, szPacked, compression);
+		if (!errorNum) {
+			errorNum = unpackCachedData();
+			if (errorNum)
+				_resMan->removeFromPackedCache(this);
+		}
+		return errorNum;
+	}
+
+	_packedSize = szPacked;
+	_compression = compression;
+	return unpack(compression, file, szPacked);
+}
+
+int Resource::loadPackedData(ResVersion volVersion, Common::SeekableReadStream *file) {
+	uint32 szPacked = 0;
+	ResourceCompression compression = kCompUnknown;
+
+	int errorNum = readResourceInfo(volVersion, file, szPacked, compression);
+	if (errorNum)
+		return errorNum;
+
+	if (!_resMan->canCachePackedData(this, compression, szPacked)) {
+		_packedSize = szPacked;
+		_compression = compression;
+		return SCI_ERROR_NONE;
+	}
+
+	return readPackedData(file, szPacked, compression);
+}
+
+int Resource::readPackedData(Common::SeekableReadStream *file, uint32 szPacked, ResourceCompression compression) {
+	byte *packedData = new byte[szPacked];
+	if (file->read(packedData, szPacked) != szPacked) {
+		delete[] packedData;
+		return SCI_ERROR_IO_ERROR;
+	}
+
+	_unpackedSize = _size;
+	_resMan->addToPackedCache(this, packedData, szPacked, compression);
+	return SCI_ERROR_NONE;
+}
+
+int Resource::unpackCachedData() {
+	// Resource patches may have changed the size of the previous copy
+	_size = _unpackedSize;
+	Common::MemoryReadStream packedStream(_packedData, _packedSize);
+	return unpack(_compression, &packedStream, _packedSize);
+}
+
+/**
+ * Unpacks resource data. This only touches the given buffers, so it may run
+ * on a worker thread.
+ */
+static int unpackResourceData(const ResourceId &id, ResourceCompression compression, Common::ReadStream *src, byte *dest, uint32 szPacked, uint32 szUnpacked) {
 	// getting a decompressor
 	Decompressor *dec = nullptr;
 	switch (compression) {
@@ -2392,14 +2718,20 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		break;
 #endif
 	default:
-		error("Resource %s: Compression method %d not supported", _id.toString().c_str(), compression);
+		error("Resource %s: Compression method %d not supported", id.toString().c_str(), compression);
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
 
+	int errorNum = dec->unpack(src, dest, szPacked, szUnpacked);
+	delete dec;
+	return errorNum;
+}
+
+int Resource::unpack(ResourceCompression compression, Common::ReadStream *src, uint32 szPacked) {
 	byte *ptr = new byte[_size];
 	_data = ptr;
 	_status = kResStatusAllocated;
-	errorNum = ptr ? dec->unpack(file, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
+	int errorNum = ptr ? unpackResourceData(_id, compression, src, ptr, szPacked, _size) : SCI_ERROR_RESOURCE_TOO_BIG;
 	if (errorNum) {
 		unalloc();
 	} else {
@@ -2419,7 +2751,6 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		}
 	}
 
-	delete dec;
 	return errorNum;
 }
 
@@ -155,6 +155,7 @@ SciVersion getSciVersionForDetection();
 const char *getSciVersionDesc(SciVersion version);
 
 class ResourceManager;
+struct ResourceUnpackJob;
 class ResourceSource;
 class ResourcePatcher;
 
@@ -312,17 +313,48 @@ protected:
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
+	Common::List<Resource *>::iterator _lruPosition; /**< Position in the LRU list while enqueued */
+
+	/**
+	 * Compressed data of the resource as read from its volume, kept by the
+	 * resource cache so that the resource can be unpacked again without
+	 * reading the volume file. NULL if not cached.
+	 */
+	byte *_packedData;
+	uint32 _packedSize;
+	uint32 _unpackedSize; /**< Size of the unpacked data before resource patches are applied */
+	ResourceCompression _compression;
+	Common::List<Resource *>::iterator _packedPosition; /**< Position in the compressed data LRU list */
+	ResourceUnpackJob *_unpackJob; /**< Prefetch job unpacking the resource on a worker thread, or NULL */
+
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
 	bool loadFromWaveFile(Common::SeekableReadStream *file);
 	bool loadFromAudioVolumeSCI1(Common::SeekableReadStream *file);
 	bool loadFromAudioVolumeSCI11(Common::SeekableReadStream *file);
 	int decompress(ResVersion volVersion, Common::SeekableReadStream *file);
+	int loadPackedData(ResVersion volVersion, Common::SeekableReadStream *file);
+	int readPackedData(Common::SeekableReadStream *file, uint32 szPacked, ResourceCompression compression);
+	int unpack(ResourceCompression compression, Common::ReadStream *src, uint32 szPacked);
+	int unpackCachedData();
 	int readResourceInfo(ResVersion volVersion, Common::SeekableReadStream *file, uint32 &szPacked, ResourceCompression &compression);
 };
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/** Memory usage and hit counters of the resource cache, for the debugger */
+struct ResourceCacheStatistics {
+	int memoryLocked;     ///< bytes of locked resources
+	int memoryLRU;        ///< bytes of unpacked resources under LRU control
+	int maxMemoryLRU;     ///< budget for unpacked resources under LRU control
+	int memoryPacked;     ///< bytes of compressed resource data kept in memory
+	int maxMemoryPacked;  ///< budget for compressed resource data
+	uint32 hits;          ///< requests served from unpacked resources
+	uint32 unpacks;       ///< requests served by unpacking cached compressed data
+	uint32 diskLoads;     ///< requests that had to read from a resource file
+	uint32 prefetches;    ///< resources unpacked ahead of time on worker threads
+};
+
 class IntMapResourceSource;
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
@@ -337,6 +369,7 @@ class ResourceManager {
 	friend class WaveResourceSource;
 	friend class MacResourceForkResourceSource;
 	friend class ResourcePatcher;
+	friend class Resource;
 #ifdef ENABLE_SCI32
 	friend class ChunkResourceSource;
 #endif
@@ -394,6 +427,30 @@ public:
 	 */
 	Resource *testResource(const ResourceId &id) const;
 
+	/**
+	 * Starts unpacking a resource which is likely to be needed soon on a
+	 * worker thread. The compressed data is read right away, but unpacking
+	 * runs in the background; findResource() only waits for it if the
+	 * resource is requested before it is done. Does nothing for resources
+	 * which are already loaded or not compressed, or when no worker threads
+	 * are available.
+	 * @param id	Id of the resource to prefetch
+	 */
+	void prefetchResource(ResourceId id);
+
+	/**
+	 * Returns the memory usage and hit counters of the resource cache.
+	 */
+	ResourceCacheStatistics getCacheStatistics() const;
+
+	/**
+	 * Changes the memory budgets of the resource cache.
+	 * Resources are evicted right away if they exceed the new budgets.
+	 * @param maxMemoryLRU		Bytes allowed for unpacked resources that are not locked
+	 * @param maxMemoryPacked	Bytes allowed for cached compressed resource data
+	 */
+	void setCacheBudgets(int maxMemoryLRU, int maxMemoryPacked);
+
 	/**
 	 * Returns a list of all resources of the specified type.
 	 * @param type		The resource type to look for
@@ -494,6 +551,7 @@ protected:
 	// for resources which are not explicitly locked. However, a warning will be
 	// issued whenever this limit is exceeded.
 	int _maxMemoryLRU;
+	int _maxMemoryPacked; ///< Maximum number of bytes of compressed resource data to keep
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	typedef Common::List<ResourceSource *> SourcesList;
@@ -501,6 +559,13 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	int _memoryPacked;	///< Amount of compressed resource bytes kept in memory
+	Common::List<Resource *> _packedLRU; ///< Resources with compressed data, most recently used first
+	uint32 _cacheHits;
+	uint32 _cacheUnpacks;
+	uint32 _cacheDiskLoads;
+	uint32 _cachePrefetches;
+	Common::List<Resource *> _unpackJobs; ///< Resources being unpacked on worker threads
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -562,6 +627,15 @@ protected:
 	void disposeVolumeFileStream(Common::SeekableReadStream *fileStream, ResourceSource *source);
 	void loadResource(Resource *res);
 	void freeOldResources();
+	uint getRestoreCost(const Resource *res) const;
+	void addToPackedCache(Resource *res, byte *packedData, uint32 packedSize, ResourceCompression compression);
+	void touchPackedCache(Resource *res);
+	void removeFromPackedCache(Resource *res);
+	void freeOldPackedData();
+	bool canCachePackedData(const Resource *res, ResourceCompression compression, uint32 packedSize) const;
+	void finishUnpackJob(Resource *res);
+	void discardUnpackJob(Resource *res);
+	void finishUnpackJobs(bool wait);
 	bool validateResource(const ResourceId &resourceId, const Common::Path &sourceMapLocation, const Common::Path &sourceName, const uint32 offset, const uint32 size, const uint32 sourceSize) const;
 	Resource *addResource(ResourceId resId, ResourceSource *src, uint32 offset, uint32 size = 0, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
 	Resource *updateResource(ResourceId resId, ResourceSource *src, uint32 size, const Common::Path &sourceMapLocation = Common::Path("(no map location)"));
@@ -66,6 +66,9 @@ public:
 	// Auxiliary method, used by loadResource implementations.
 	Common::SeekableReadStream *getVolumeFile(ResourceManager *resMan, Resource *res);
 
+	// Auxiliary method, returns the volume file positioned at the resource.
+	Common::SeekableReadStream *getResourceStream(ResourceManager *resMan, Resource *res, ResVersion &volVersion);
+
 	/**
 	 * TODO: Document this
 	 */
@@ -83,6 +86,12 @@ public:
 	 */
 	virtual void loadResource(ResourceManager *resMan, Resource *res);
 
+	/**
+	 * Read the compressed data of a resource from a volume into the resource
+	 * cache, without unpacking it.
+	 */
+	void loadPackedData(ResourceManager *resMan, Resource *res);
+
 	// FIXME: This audio specific method is a hack. After all, why should a
 	// ResourceSource or a Resource (which uses this method) have audio
 	// specific methods? But for now we keep this, as it eases transition.
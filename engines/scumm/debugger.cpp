@@ -28,6 +28,7 @@
 #include "scumm/actor.h"
 #include "scumm/boxes.h"
 #include "scumm/debugger.h"
+#include "scumm/file.h"
 #include "scumm/imuse/imuse.h"
 #include "scumm/imuse_digi/dimuse_engine.h"
 #include "scumm/object.h"
@@ -37,6 +38,10 @@
 
 #include "scumm/akos.h"
 
+#if defined(ENABLE_SCUMM_7_8)
+#include "scumm/smush/smush_blocks.h"
+#endif
+
 namespace Scumm {
 
 void debugC(int channel, const char *s, ...) {
@@ -108,9 +113,13 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 #if defined(ENABLE_SCUMM_7_8)
 	else
 		registerCmd("imuse", WRAP_METHOD(ScummDebugger, Cmd_DiMuse));
+
+	if (_vm->_game.version >= 7)
+		registerCmd("smush_bench", WRAP_METHOD(ScummDebugger, Cmd_SmushBench));
 #endif
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+	registerCmd("screenstats",     WRAP_METHOD(ScummDebugger, Cmd_ScreenStats));
 }
 
 void ScummDebugger::preEnter() {
@@ -1408,10 +1417,77 @@ bool ScummDebugger::Cmd_Passcode(int argc, const char **argv) {
 	return false;
 }
 
+#if defined(ENABLE_SCUMM_7_8)
+bool ScummDebugger::Cmd_SmushBench(int argc, const char **argv) {
+	if (argc < 2 || argc > 3) {
+		debugPrintf("Usage: %s <san file> [<runs>]\n", argv[0]);
+		debugPrintf("Decodes the video frames of a SMUSH animation without displaying them\n");
+		return true;
+	}
+
+	const int runs = (argc == 3) ? MAX(atoi(argv[2]), 1) : 1;
+
+	ScummFile file(_vm);
+	if (!_vm->openFile(file, Common::Path(argv[1]))) {
+		debugPrintf("Could not open file %s\n", argv[1]);
+		return true;
+	}
+	// Read the whole file first, so that only the decoding is measured
+	Common::SeekableReadStream *data = file.readStream(file.size());
+	file.close();
+
+	SmushKernels kernels[2] = { kSmushKernelsScalar, getBestSmushKernels() };
+	const int numKernels = (kernels[1] != kSmushKernelsScalar) ? 2 : 1;
+
+	for (int i = 0; i < numKernels; i++) {
+		int frames = 0;
+		const uint32 start = _vm->_system->getMillis();
+		for (int run = 0; run < runs; run++) {
+			data->seek(0);
+			const int decoded = decodeSmushFrames(*data, kernels[i]);
+			if (decoded < 0) {
+				debugPrintf("%s is no SMUSH animation\n", argv[1]);
+				delete data;
+				return true;
+			}
+			frames += decoded;
+		}
+		const uint32 elapsed = MAX<uint32>(_vm->_system->getMillis() - start, 1);
+
+		debugPrintf("%-6s: %d frames in %u ms, %u frames/s\n", getSmushKernelsName(kernels[i]),
+			frames, elapsed, (uint32)((uint64)frames * 1000 / elapsed));
+	}
+
+	delete data;
+	return true;
+}
+#endif
+
 bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	_vm->resetCursors();
 	detach();
 	return false;
 }
 
+bool ScummDebugger::Cmd_ScreenStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	ScreenUpdateStats &stats = _vm->_screenStats;
+	if (argc == 2) {
+		stats = ScreenUpdateStats();
+		debugPrintf("Screen update counters reset\n");
+		return true;
+	}
+
+	const uint32 frames = MAX<uint32>(stats.frames, 1);
+	debugPrintf("Frames: %u\n", stats.frames);
+	debugPrintf("Dirty strips: %u (%u per frame)\n", stats.strips, stats.strips / frames);
+	debugPrintf("Blit rectangles: %u (%u per frame)\n", stats.rects, stats.rects / frames);
+	debugPrintf("Blit bytes: %u KiB (%u bytes per frame)\n", (uint32)(stats.bytes / 1024), (uint32)(stats.bytes / frames));
+	return true;
+}
+
 } // End of namespace Scumm
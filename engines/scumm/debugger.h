@@ -73,8 +73,12 @@ private:
 	bool Cmd_Cosdump(int argc, const char **argv);
 	bool Cmd_IMuse(int argc, const char **argv);
 	bool Cmd_DiMuse(int argc, const char **argv);
+#if defined(ENABLE_SCUMM_7_8)
+	bool Cmd_SmushBench(int argc, const char **argv);
+#endif
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
+	bool Cmd_ScreenStats(int argc, const char **argv);
 
 	void printBox(int box);
 	void drawBox(int box, int color);
@@ -529,6 +529,8 @@ void ScummEngine::markRectAsDirty(VirtScreenNumber virt, int left, int right, in
  * code in the backend is controlled from here.
  */
 void ScummEngine::drawDirtyScreenParts() {
+	_screenStats.frames++;
+
 	// Update verbs
 	updateDirtyScreen(kVerbVirtScreen);
 
@@ -593,35 +595,57 @@ void ScummEngine::updateDirtyScreen(VirtScreenNumber slot) {
 	if (vs->h == 0)
 		return;
 
-	int i;
-	int w = 8;
-	int start = 0;
-
-	for (i = 0; i < _gdi->_numStrips; i++) {
-		if (vs->bdirty[i]) {
-			const int top = vs->tdirty[i];
-			const int bottom = vs->bdirty[i];
+	// Neighboring dirty strips are coalesced into one span as long as the
+	// span does not cover more than kMaxStripMergeWaste lines of strips which
+	// are not dirty: one bigger blit is cheaper than several small ones. The
+	// NES full screen check in drawStripToScreen() needs exact spans.
+	const int maxWaste = (_game.platform == Common::kPlatformNES) ? 0 : kMaxStripMergeWaste;
+	int start = -1;
+	int top = 0, bottom = 0, area = 0;
+
+	for (int i = 0; i <= _gdi->_numStrips; i++) {
+		int stripTop = 0, stripBottom = 0;
+		if (i < _gdi->_numStrips && vs->bdirty[i]) {
+			stripTop = vs->tdirty[i];
+			stripBottom = vs->bdirty[i];
 			vs->tdirty[i] = vs->h;
 			vs->bdirty[i] = 0;
-			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top) {
-				// Simple optimizations: if two or more neighboring strips
-				// form one bigger rectangle, coalesce them.
-				w += 8;
-				continue;
+			_screenStats.strips++;
+		}
+
+		if (stripBottom > stripTop) {
+			if (start >= 0) {
+				const int spanTop = MIN(top, stripTop);
+				const int spanBottom = MAX(bottom, stripBottom);
+				area += stripBottom - stripTop;
+				if ((spanBottom - spanTop) * (i - start + 1) - area <= maxWaste) {
+					top = spanTop;
+					bottom = spanBottom;
+					continue;
+				}
+				drawDirtySpan(vs, start, i - start, top, bottom);
 			}
-#ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
-			if (_game.platform == Common::kPlatformFMTowns && vs->number == kBannerVirtScreen) {
-				int scl = _textSurfaceMultiplier;
-				towns_drawStripToScreen(vs, start * 8 * scl, (vs->topline + top) * scl, start * 8 * scl, top * scl, w * scl, bottom - top);
-			} else 
-#endif
-				drawStripToScreen(vs, start * 8, w, top, bottom);
-			w = 8;
+			start = i;
+			top = stripTop;
+			bottom = stripBottom;
+			area = stripBottom - stripTop;
+		} else if (start >= 0) {
+			drawDirtySpan(vs, start, i - start, top, bottom);
+			start = -1;
 		}
-		start = i + 1;
 	}
 }
 
+void ScummEngine::drawDirtySpan(VirtScreen *vs, int strip, int numStrips, int top, int bottom) {
+#ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
+	if (_game.platform == Common::kPlatformFMTowns && vs->number == kBannerVirtScreen) {
+		int scl = _textSurfaceMultiplier;
+		towns_drawStripToScreen(vs, strip * 8 * scl, (vs->topline + top) * scl, strip * 8 * scl, top * scl, numStrips * 8 * scl, bottom - top);
+	} else
+#endif
+		drawStripToScreen(vs, strip * 8, numStrips * 8, top, bottom);
+}
+
 /**
  * Blit the specified rectangle from the given virtual screen to the display.
  * Note: t and b are in *virtual screen* coordinates, while x is relative to
@@ -663,6 +687,8 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 		return;
 
 	if (_macScreen) {
+		_screenStats.rects++;
+		_screenStats.bytes += width * height * _outputPixelFormat.bytesPerPixel;
 		mac_drawStripToScreen(vs, top, x, y, width, height);
 		return;
 	}
@@ -697,6 +723,8 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 
 #ifndef DISABLE_TOWNS_DUAL_LAYER_MODE
 		if (_game.platform == Common::kPlatformFMTowns) {
+			_screenStats.rects++;
+			_screenStats.bytes += width * height * _outputPixelFormat.bytesPerPixel;
 			towns_drawStripToScreen(vs, x, y, x, top, width, height);
 			return;
 		} else
@@ -727,36 +755,7 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 #ifdef USE_ARM_GFX_ASM
 			asmDrawStripToScreen(height, width, text, src, _compositeBuf, vs->pitch, width, _textSurface.pitch);
 #else
-			// We blit four pixels at a time, for improved performance.
-			const uint32 *src32 = (const uint32 *)src;
-			uint32 *dst32 = (uint32 *)_compositeBuf;
-
-			vsPitch >>= 2;
-
-			const uint32 *text32 = (const uint32 *)text;
-			const int textPitch = (_textSurface.pitch - width * m) >> 2;
-			for (int h = height * m; h > 0; --h) {
-				for (int w = width * m; w > 0; w -= 4) {
-					uint32 temp = *text32++;
-
-					// Generate a byte mask for those text pixels (bytes) with
-					// value CHARSET_MASK_TRANSPARENCY. In the end, each byte
-					// in mask will be either equal to 0x00 or 0xFF.
-					// Doing it this way avoids branches and bytewise operations,
-					// at the cost of readability ;).
-					uint32 mask = temp ^ CHARSET_MASK_TRANSPARENCY_32;
-					mask = (((mask & 0x7f7f7f7f) + 0x7f7f7f7f) | mask) & 0x80808080;
-					mask = ((mask >> 7) + 0x7f7f7f7f) ^ 0x80808080;
-
-					// The following line is equivalent to this code:
-					//   *dst32++ = (*src32++ & mask) | (temp & ~mask);
-					// However, some compilers can generate somewhat better
-					// machine code for this equivalent statement:
-					*dst32++ = ((temp ^ *src32++) & mask) ^ temp;
-				}
-				src32 += vsPitch;
-				text32 += textPitch;
-			}
+			_compositeTextProc(_compositeBuf, width * m, (const byte *)src, width * m + vsPitch, (const byte *)text, _textSurface.pitch, width * m, height * m);
 #endif
 		}
 		src = _compositeBuf;
@@ -800,6 +799,8 @@ void ScummEngine::drawStripToScreen(VirtScreen *vs, int x, int width, int top, i
 	}
 
 	// Finally blit the whole thing to the screen
+	_screenStats.rects++;
+	_screenStats.bytes += width * height * _outputPixelFormat.bytesPerPixel;
 	_system->copyRectToScreen(src, pitch, x, y, width, height);
 }
 
@@ -24,6 +24,7 @@
 
 #include "common/system.h"
 #include "common/list.h"
+#include "common/rect.h"
 
 #include "graphics/surface.h"
 
@@ -127,6 +128,24 @@ enum HerculesDimensions {
 	kHercHeight = 350
 };
 
+/**
+ * How many lines of clean strips updateDirtyScreen() may blit, to coalesce
+ * neighboring dirty strips into one span.
+ */
+enum {
+	kMaxStripMergeWaste = 32
+};
+
+/** Counters of the work done to blit the virtual screens, for profiling */
+struct ScreenUpdateStats {
+	uint32 frames;  ///< calls of drawDirtyScreenParts()
+	uint32 strips;  ///< dirty strips
+	uint32 rects;   ///< rectangles blit to the screen
+	uint64 bytes;   ///< bytes blit to the screen
+
+	ScreenUpdateStats() : frames(0), strips(0), rects(0), bytes(0) {}
+};
+
 /** Camera modes */
 enum {
 	kNormalCameraMode = 1,
@@ -289,6 +308,18 @@ struct StripTable;
 #define CHARSET_MASK_TRANSPARENCY	 0xFD
 #define CHARSET_MASK_TRANSPARENCY_32 0xFDFDFDFD
 
+/**
+ * Compose the 8bpp text surface over the game graphics: text pixels equal to
+ * CHARSET_MASK_TRANSPARENCY let the game graphics through, all others are
+ * copied. The width has to be a multiple of 4.
+ */
+typedef void (*CompositeTextProc)(byte *dst, int dstPitch, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+
+void compositeText(byte *dst, int dstPitch, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+#ifdef SCUMMVM_SSE2
+void compositeTextSSE2(byte *dst, int dstPitch, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height);
+#endif
+
 class Gdi {
 protected:
 	ScummEngine *_vm;
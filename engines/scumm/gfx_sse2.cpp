@@ -0,0 +1,48 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "scumm/gfx.h"
+
+namespace Scumm {
+
+void compositeTextSSE2(byte *dst, int dstPitch, const byte *src, int srcPitch, const byte *text, int textPitch, int width, int height) {
+	const __m128i transparency = _mm_set1_epi8((char)CHARSET_MASK_TRANSPARENCY);
+	const int simdWidth = width & ~15;
+
+	for (int h = height; h > 0; --h) {
+		for (int x = 0; x < simdWidth; x += 16) {
+			const __m128i t = _mm_loadu_si128((const __m128i *)(text + x));
+			const __m128i s = _mm_loadu_si128((const __m128i *)(src + x));
+			const __m128i mask = _mm_cmpeq_epi8(t, transparency);
+			_mm_storeu_si128((__m128i *)(dst + x), _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, t)));
+		}
+		if (simdWidth < width)
+			compositeText(dst + simdWidth, 0, src + simdWidth, 0, text + simdWidth, 0, width - simdWidth, 1);
+
+		src += srcPitch;
+		text += textPitch;
+		dst += dstPitch;
+	}
+}
+
+} // End of namespace Scumm
@@ -16,6 +16,7 @@ MODULE_OBJS := \
 	dialogs.o \
 	file.o \
 	file_nes.o \
+	gfx_composite.o \
 	gfx_gui.o \
 	gfx_mac.o \
 	gfx_towns.o \
@@ -125,6 +126,7 @@ MODULE_OBJS += \
 	smush/codec20.o \
 	smush/codec37.o \
 	smush/codec47.o \
+	smush/smush_blocks.o \
 	smush/smush_player.o
 
 ifdef USE_ARM_SMUSH_ASM
@@ -132,6 +134,12 @@ MODULE_OBJS += \
 	smush/codec47ARM.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	smush/smush_blocks_sse2.o
+$(MODULE)/smush/smush_blocks_sse2.o: CXXFLAGS += -msse2
+endif
+
 endif
 
 ifdef USE_ARM_GFX_ASM
@@ -139,6 +147,12 @@ MODULE_OBJS += \
 	gfxARM.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	gfx_sse2.o
+$(MODULE)/gfx_sse2.o: CXXFLAGS += -msse2
+endif
+
 ifdef ENABLE_HE
 MODULE_OBJS += \
 	he/animation_he.o \
@@ -394,6 +394,11 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	else
 		_compositeBuf = nullptr;
 
+#ifdef SCUMMVM_SSE2
+	if (_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_compositeTextProc = compositeTextSSE2;
+#endif
+
 	if (_renderMode == Common::kRenderHercA || _renderMode == Common::kRenderHercG)
 		_hercCGAScaleBuf = (byte *)malloc(kHercWidth * kHercHeight);
 	else if (_renderMode == Common::kRenderCGA_BW || (_renderMode == Common::kRenderEGA && _supportsEGADithering))
@@ -1413,8 +1413,12 @@ protected:
 	bool _enableEGADithering = false;
 	bool _supportsEGADithering = false;
 
+	CompositeTextProc _compositeTextProc = compositeText;
+	ScreenUpdateStats _screenStats;
+
 	virtual void drawDirtyScreenParts();
 	void updateDirtyScreen(VirtScreenNumber slot);
+	void drawDirtySpan(VirtScreen *vs, int strip, int numStrips, int top, int bottom);
 	void drawStripToScreen(VirtScreen *vs, int x, int width, int top, int bottom);
 
 	void mac_markScreenAsDirty(int x, int y, int w, int h);
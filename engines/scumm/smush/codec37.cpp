@@ -25,6 +25,7 @@
 #include "common/util.h"
 #include "scumm/bomp.h"
 #include "scumm/smush/codec37.h"
+#include "scumm/smush/codec37_impl.h"
 
 namespace Scumm {
 
@@ -45,6 +46,7 @@ SmushDeltaBlocksDecoder::SmushDeltaBlocksDecoder(int width, int height) {
 	_prevSeqNb = 0;
 	_tableLastPitch = -1;
 	_tableLastIndex = -1;
+	_kernels = kSmushKernelsScalar;
 }
 
 SmushDeltaBlocksDecoder::~SmushDeltaBlocksDecoder() {
@@ -234,265 +236,19 @@ void SmushDeltaBlocksDecoder::makeTable(int pitch, int index) {
 	}
 }
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define DECLARE_LITERAL_TEMP(v) \
-	byte v
-
-#define READ_LITERAL_PIXEL(src, v) \
-	v = *src++
-
-#define WRITE_4X1_LINE(dst, v)  \
-	do {                        \
-		int j;                  \
-		for (j = 0; j < 4; j++) \
-			(dst)[j] = v;       \
-	} while (0)
-
-#define COPY_4X1_LINE(dst, src)  \
-	do {                         \
-		int j;                   \
-		for (j = 0; j < 4; j++)  \
-			(dst)[j] = (src)[j]; \
-	} while (0)
-
-#else /* SCUMM_NEED_ALIGNMENT */
-
-#define DECLARE_LITERAL_TEMP(v) \
-	uint32 v
-
-#define READ_LITERAL_PIXEL(src, v)             \
-	do {                                       \
-		v = *src++;                            \
-		v += (v << 8) + (v << 16) + (v << 24); \
-	} while (0)
-
-#define WRITE_4X1_LINE(dst, v) \
-	*(uint32 *)(dst) = v
-
-#define COPY_4X1_LINE(dst, src)               \
-	*(uint32 *)(dst) = *(const uint32 *)(src)
-
-#endif /* SCUMM_NEED_ALIGNMENT */
-
-/* Fill a 4x4 pixel block with a literal pixel value */
-
-#define LITERAL_4X4(src, dst, pitch)            \
-	do {                                        \
-		int x;                                  \
-		DECLARE_LITERAL_TEMP(t);                \
-		READ_LITERAL_PIXEL(src, t);             \
-		for (x = 0; x < 4; x++) {               \
-			WRITE_4X1_LINE(dst + pitch * x, t); \
-		}                                       \
-		dst += 4;                               \
-	} while (0)
-
-/* Fill four 4x1 pixel blocks with literal pixel values */
-
-#define LITERAL_4X1(src, dst, pitch)            \
-	do {                                        \
-		int x;                                  \
-		DECLARE_LITERAL_TEMP(t);                \
-		for (x = 0; x < 4; x++) {               \
-			READ_LITERAL_PIXEL(src, t);	        \
-			WRITE_4X1_LINE(dst + pitch * x, t); \
-		}                                       \
-		dst += 4;                               \
-	} while (0)
-
-/* Fill sixteen 1x1 pixel blocks with literal pixel values */
-
-#define LITERAL_1X1(src, dst, pitch)             \
-	do {                                         \
-		int x;                                   \
-		for (x = 0; x < 4; x++) {                \
-			COPY_4X1_LINE(dst + pitch * x, src); \
-			src += 4;                            \
-		}                                        \
-		dst += 4;                                \
-	} while (0)
-
-/* Copy a 4x4 pixel block from a different place in the framebuffer */
-
-#define COPY_4X4(dst2, dst, pitch)                            \
-	do {                                                      \
-		int x;                                                \
-		for (x=0; x<4; x++) {                                 \
-			COPY_4X1_LINE(dst + pitch * x, dst2 + pitch * x); \
-		}                                                     \
-		dst += 4;                                             \
-	} while (0)
-
-void SmushDeltaBlocksDecoder::proc1(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
-	uint8 code;
-	bool filling, skipCode;
-	int32 len;
-	int i, p;
-	uint32 pitches[16];
-
-	i = bw;
-	for (p = 0; p < 16; ++p) {
-		pitches[p] = (p >> 2) * pitch + (p & 0x3);
-	}
-	code = 0;
-	filling = false;
-	len = -1;
-	while (1) {
-		if (len < 0) {
-			filling = (*src & 1) == 1;
-			len = *src++ >> 1;
-			skipCode = false;
-		} else {
-			skipCode = true;
-		}
-		if (!filling || !skipCode) {
-			code = *src++;
-			if (code == 0xFF) {
-				--len;
-				for (p = 0; p < 0x10; ++p) {
-					if (len < 0) {
-						filling = (*src & 1) == 1;
-						len = *src++ >> 1;
-						if (filling) {
-							code = *src++;
-						}
-					}
-					if (filling) {
-						*(dst + pitches[p]) = code;
-					} else {
-						*(dst + pitches[p]) = *src++;
-					}
-					--len;
-				}
-				dst += 4;
-				--i;
-				if (i == 0) {
-					dst += pitch * 3;
-					--bh;
-					if (bh == 0) return;
-					i = bw;
-				}
-				continue;
-			}
-		}
-		byte *dst2 = dst + offsetTable[code] + nextOffs;
-		COPY_4X4(dst2, dst, pitch);
-		--i;
-		if (i == 0) {
-			dst += pitch * 3;
-			--bh;
-			if (bh == 0) return;
-			i = bw;
-		}
-		--len;
+void SmushDeltaBlocksDecoder::decodeDeltaBlocks(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch) {
+	switch (_kernels) {
+#ifdef SCUMMVM_SSE2
+	case kSmushKernelsSSE2:
+		decodeBlocksSSE2(type, maskFlags, dst, src, nextOffs, bw, bh, pitch);
+		break;
+#endif
+	default:
+		decodeBlocks<SmushScalarBlockOps>(type, maskFlags, dst, src, nextOffs, bw, bh, pitch);
+		break;
 	}
 }
 
-void SmushDeltaBlocksDecoder::proc3WithFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
-	do {
-		int32 i = bw;
-		do {
-			int32 code = *src++;
-			if (code == 0xFD) {
-				LITERAL_4X4(src, dst, pitch);
-			} else if (code == 0xFE) {
-				LITERAL_4X1(src, dst, pitch);
-			} else if (code == 0xFF) {
-				LITERAL_1X1(src, dst, pitch);
-			} else {
-				byte *dst2 = dst + _offsetTable[code] + nextOffs;
-				COPY_4X4(dst2, dst, pitch);
-			}
-		} while (--i);
-		dst += pitch * 3;
-	} while (--bh);
-}
-
-void SmushDeltaBlocksDecoder::proc3WithoutFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
-	do {
-		int32 i = bw;
-		do {
-			int32 code = *src++;
-			if (code == 0xFF) {
-				LITERAL_1X1(src, dst, pitch);
-			} else {
-				byte *dst2 = dst + _offsetTable[code] + nextOffs;
-				COPY_4X4(dst2, dst, pitch);
-			}
-		} while (--i);
-		dst += pitch * 3;
-	} while (--bh);
-}
-
-void SmushDeltaBlocksDecoder::proc4WithFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
-	do {
-		int32 i = bw;
-		do {
-			int32 code = *src++;
-			if (code == 0xFD) {
-				LITERAL_4X4(src, dst, pitch);
-			} else if (code == 0xFE) {
-				LITERAL_4X1(src, dst, pitch);
-			} else if (code == 0xFF) {
-				LITERAL_1X1(src, dst, pitch);
-			} else if (code == 0x00) {
-				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
-				if (bh == 0) {
-					return;
-				}
-				i++;
-			} else {
-				byte *dst2 = dst + _offsetTable[code] + nextOffs;
-				COPY_4X4(dst2, dst, pitch);
-			}
-		} while (--i);
-		dst += pitch * 3;
-	} while (--bh);
-}
-
-void SmushDeltaBlocksDecoder::proc4WithoutFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
-	do {
-		int32 i = bw;
-		do {
-			int32 code = *src++;
-			if (code == 0xFF) {
-				LITERAL_1X1(src, dst, pitch);
-			} else if (code == 0x00) {
-				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
-				if (bh == 0) {
-					return;
-				}
-				i++;
-			} else {
-				byte *dst2 = dst + _offsetTable[code] + nextOffs;
-				COPY_4X4(dst2, dst, pitch);
-			}
-		} while (--i);
-		dst += pitch * 3;
-	} while (--bh);
-}
-
 void SmushDeltaBlocksDecoder::decode(byte *dst, const byte *src) {
 	int32 bw = (_width + 3) / 4, bh = (_height + 3) / 4;
 	int32 pitch = bw * 4;
@@ -518,8 +274,8 @@ void SmushDeltaBlocksDecoder::decode(byte *dst, const byte *src) {
 		if ((seqNb & 1) || !(maskFlags & 1)) {
 			_curTable ^= 1;
 		}
-		proc1(_deltaBufs[_curTable], src + 16, _deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable],
-										bw, bh, pitch, _offsetTable);
+		decodeDeltaBlocks(1, maskFlags, _deltaBufs[_curTable], src + 16,
+										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh, pitch);
 		break;
 	case 2:
 		bompDecodeLine(_deltaBufs[_curTable], src + 16, decodedSize);
@@ -532,34 +288,12 @@ void SmushDeltaBlocksDecoder::decode(byte *dst, const byte *src) {
 		}
 		break;
 	case 3:
-		if ((seqNb & 1) || !(maskFlags & 1)) {
-			_curTable ^= 1;
-		}
-
-		if ((maskFlags & 4) != 0) {
-			proc3WithFDFE(_deltaBufs[_curTable], src + 16,
-										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh,
-										pitch, _offsetTable);
-		} else {
-			proc3WithoutFDFE(_deltaBufs[_curTable], src + 16,
-										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh,
-										pitch, _offsetTable);
-		}
-		break;
 	case 4:
 		if ((seqNb & 1) || !(maskFlags & 1)) {
 			_curTable ^= 1;
 		}
-
-		if ((maskFlags & 4) != 0) {
-			proc4WithFDFE(_deltaBufs[_curTable], src + 16,
-										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh,
-										pitch, _offsetTable);
-		} else {
-			proc4WithoutFDFE(_deltaBufs[_curTable], src + 16,
-										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh,
-										pitch, _offsetTable);
-		}
+		decodeDeltaBlocks(src[0], maskFlags, _deltaBufs[_curTable], src + 16,
+										_deltaBufs[_curTable ^ 1] - _deltaBufs[_curTable], bw, bh, pitch);
 		break;
 	default:
 		break;
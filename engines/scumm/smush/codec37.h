@@ -24,6 +24,8 @@
 
 #include "common/scummsys.h"
 
+#include "scumm/smush/smush_blocks.h"
+
 namespace Scumm {
 
 class SmushDeltaBlocksDecoder {
@@ -39,19 +41,34 @@ private:
 	int _tableLastIndex;
 	int32 _frameSize;
 	int _width, _height;
+	SmushKernels _kernels;
 
 public:
 	SmushDeltaBlocksDecoder(int width, int height);
 	~SmushDeltaBlocksDecoder();
 protected:
 	void makeTable(int, int);
+	template<class Ops>
 	void proc1(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	template<class Ops>
 	void proc3WithFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	template<class Ops>
 	void proc3WithoutFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	template<class Ops>
 	void proc4WithFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	template<class Ops>
 	void proc4WithoutFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	template<class Ops>
+	void decodeBlocks(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch);
+#ifdef SCUMMVM_SSE2
+	void decodeBlocksSSE2(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch);
+#endif
+	void decodeDeltaBlocks(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch);
 public:
 	void decode(byte *dst, const byte *src);
+
+	/** Select the block kernels used for decoding. */
+	void setKernels(SmushKernels kernels) { _kernels = kernels; }
 };
 
 } // End of namespace Scumm
@@ -0,0 +1,306 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCUMM_SMUSH_CODEC37_IMPL_H
+#define SCUMM_SMUSH_CODEC37_IMPL_H
+
+// Block decoding of codec 37, shared by codec37.cpp and the SIMD variants
+// in smush_blocks_*.cpp.
+
+#include "common/util.h"
+#include "scumm/smush/codec37.h"
+#include "scumm/smush/smush_blocks.h"
+
+namespace Scumm {
+
+#define DECLARE_LITERAL_TEMP(v) \
+	typename Ops::Fill v
+
+#define READ_LITERAL_PIXEL(src, v) \
+	v = Ops::makeFill(*src++)
+
+#define WRITE_4X1_LINE(dst, v) \
+	Ops::fill4(dst, v)
+
+#define COPY_4X1_LINE(dst, src) \
+	Ops::copy4(dst, src)
+
+/* Fill a 4x4 pixel block with a literal pixel value */
+
+#define LITERAL_4X4(src, dst, pitch)            \
+	do {                                        \
+		int x;                                  \
+		DECLARE_LITERAL_TEMP(t);                \
+		READ_LITERAL_PIXEL(src, t);             \
+		for (x = 0; x < 4; x++) {               \
+			WRITE_4X1_LINE(dst + pitch * x, t); \
+		}                                       \
+		dst += 4;                               \
+	} while (0)
+
+/* Fill four 4x1 pixel blocks with literal pixel values */
+
+#define LITERAL_4X1(src, dst, pitch)            \
+	do {                                        \
+		int x;                                  \
+		DECLARE_LITERAL_TEMP(t);                \
+		for (x = 0; x < 4; x++) {               \
+			READ_LITERAL_PIXEL(src, t);	        \
+			WRITE_4X1_LINE(dst + pitch * x, t); \
+		}                                       \
+		dst += 4;                               \
+	} while (0)
+
+/* Fill sixteen 1x1 pixel blocks with literal pixel values */
+
+#define LITERAL_1X1(src, dst, pitch)             \
+	do {                                         \
+		int x;                                   \
+		for (x = 0; x < 4; x++) {                \
+			COPY_4X1_LINE(dst + pitch * x, src); \
+			src += 4;                            \
+		}                                        \
+		dst += 4;                                \
+	} while (0)
+
+/* Copy a 4x4 pixel block from a different place in the framebuffer */
+
+#define COPY_4X4(dst2, dst, pitch)                            \
+	do {                                                      \
+		int x;                                                \
+		for (x=0; x<4; x++) {                                 \
+			COPY_4X1_LINE(dst + pitch * x, dst2 + pitch * x); \
+		}                                                     \
+		dst += 4;                                             \
+	} while (0)
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::proc1(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
+	uint8 code;
+	bool filling, skipCode;
+	int32 len;
+	int i, p;
+	uint32 pitches[16];
+
+	i = bw;
+	for (p = 0; p < 16; ++p) {
+		pitches[p] = (p >> 2) * pitch + (p & 0x3);
+	}
+	code = 0;
+	filling = false;
+	len = -1;
+	while (1) {
+		if (len < 0) {
+			filling = (*src & 1) == 1;
+			len = *src++ >> 1;
+			skipCode = false;
+		} else {
+			skipCode = true;
+		}
+		if (!filling || !skipCode) {
+			code = *src++;
+			if (code == 0xFF) {
+				--len;
+				for (p = 0; p < 0x10; ++p) {
+					if (len < 0) {
+						filling = (*src & 1) == 1;
+						len = *src++ >> 1;
+						if (filling) {
+							code = *src++;
+						}
+					}
+					if (filling) {
+						*(dst + pitches[p]) = code;
+					} else {
+						*(dst + pitches[p]) = *src++;
+					}
+					--len;
+				}
+				dst += 4;
+				--i;
+				if (i == 0) {
+					dst += pitch * 3;
+					--bh;
+					if (bh == 0) return;
+					i = bw;
+				}
+				continue;
+			}
+		}
+		byte *dst2 = dst + offsetTable[code] + nextOffs;
+		COPY_4X4(dst2, dst, pitch);
+		--i;
+		if (i == 0) {
+			dst += pitch * 3;
+			--bh;
+			if (bh == 0) return;
+			i = bw;
+		}
+		--len;
+	}
+}
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::proc3WithFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
+	do {
+		int32 i = bw;
+		do {
+			int32 code = *src++;
+			if (code == 0xFD) {
+				LITERAL_4X4(src, dst, pitch);
+			} else if (code == 0xFE) {
+				LITERAL_4X1(src, dst, pitch);
+			} else if (code == 0xFF) {
+				LITERAL_1X1(src, dst, pitch);
+			} else {
+				byte *dst2 = dst + _offsetTable[code] + nextOffs;
+				COPY_4X4(dst2, dst, pitch);
+			}
+		} while (--i);
+		dst += pitch * 3;
+	} while (--bh);
+}
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::proc3WithoutFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
+	do {
+		int32 i = bw;
+		do {
+			int32 code = *src++;
+			if (code == 0xFF) {
+				LITERAL_1X1(src, dst, pitch);
+			} else {
+				byte *dst2 = dst + _offsetTable[code] + nextOffs;
+				COPY_4X4(dst2, dst, pitch);
+			}
+		} while (--i);
+		dst += pitch * 3;
+	} while (--bh);
+}
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::proc4WithFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
+	do {
+		int32 i = bw;
+		do {
+			int32 code = *src++;
+			if (code == 0xFD) {
+				LITERAL_4X4(src, dst, pitch);
+			} else if (code == 0xFE) {
+				LITERAL_4X1(src, dst, pitch);
+			} else if (code == 0xFF) {
+				LITERAL_1X1(src, dst, pitch);
+			} else if (code == 0x00) {
+				int32 length = *src++ + 1;
+				while (length > 0) {
+					// Copy the blocks up to the end of the block row at once
+					int32 count = MIN(length, i);
+					for (int x = 0; x < 4; x++) {
+						Ops::copyRow(dst + pitch * x, dst + nextOffs + pitch * x, count * 4);
+					}
+					dst += count * 4;
+					length -= count;
+					i -= count;
+					if (i == 0) {
+						dst += pitch * 3;
+						bh--;
+						i = bw;
+					}
+				}
+				if (bh == 0) {
+					return;
+				}
+				i++;
+			} else {
+				byte *dst2 = dst + _offsetTable[code] + nextOffs;
+				COPY_4X4(dst2, dst, pitch);
+			}
+		} while (--i);
+		dst += pitch * 3;
+	} while (--bh);
+}
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::proc4WithoutFDFE(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
+	do {
+		int32 i = bw;
+		do {
+			int32 code = *src++;
+			if (code == 0xFF) {
+				LITERAL_1X1(src, dst, pitch);
+			} else if (code == 0x00) {
+				int32 length = *src++ + 1;
+				while (length > 0) {
+					// Copy the blocks up to the end of the block row at once
+					int32 count = MIN(length, i);
+					for (int x = 0; x < 4; x++) {
+						Ops::copyRow(dst + pitch * x, dst + nextOffs + pitch * x, count * 4);
+					}
+					dst += count * 4;
+					length -= count;
+					i -= count;
+					if (i == 0) {
+						dst += pitch * 3;
+						bh--;
+						i = bw;
+					}
+				}
+				if (bh == 0) {
+					return;
+				}
+				i++;
+			} else {
+				byte *dst2 = dst + _offsetTable[code] + nextOffs;
+				COPY_4X4(dst2, dst, pitch);
+			}
+		} while (--i);
+		dst += pitch * 3;
+	} while (--bh);
+}
+
+template<class Ops>
+void SmushDeltaBlocksDecoder::decodeBlocks(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch) {
+	switch (type) {
+	case 1:
+		proc1<Ops>(dst, src, nextOffs, bw, bh, pitch, _offsetTable);
+		break;
+	case 3:
+		if ((maskFlags & 4) != 0) {
+			proc3WithFDFE<Ops>(dst, src, nextOffs, bw, bh, pitch, _offsetTable);
+		} else {
+			proc3WithoutFDFE<Ops>(dst, src, nextOffs, bw, bh, pitch, _offsetTable);
+		}
+		break;
+	case 4:
+		if ((maskFlags & 4) != 0) {
+			proc4WithFDFE<Ops>(dst, src, nextOffs, bw, bh, pitch, _offsetTable);
+		} else {
+			proc4WithoutFDFE<Ops>(dst, src, nextOffs, bw, bh, pitch, _offsetTable);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+} // End of namespace Scumm
+
+#endif
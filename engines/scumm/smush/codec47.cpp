@@ -25,56 +25,10 @@
 #include "common/util.h"
 #include "scumm/bomp.h"
 #include "scumm/smush/codec47.h"
+#include "scumm/smush/codec47_impl.h"
 
 namespace Scumm {
 
-#if defined(SCUMM_NEED_ALIGNMENT)
-
-#define COPY_4X1_LINE(dst, src) \
-	do {                        \
-		(dst)[0] = (src)[0];    \
-		(dst)[1] = (src)[1];    \
-		(dst)[2] = (src)[2];    \
-		(dst)[3] = (src)[3];    \
-	} while (0)
-
-#define COPY_2X1_LINE(dst, src) \
-	do {                        \
-		(dst)[0] = (src)[0];    \
-		(dst)[1] = (src)[1];    \
-	} while (0)
-
-
-#else /* SCUMM_NEED_ALIGNMENT */
-
-#define COPY_4X1_LINE(dst, src)               \
-	*(uint32 *)(dst) = *(const uint32 *)(src)
-
-#define COPY_2X1_LINE(dst, src)               \
-	*(uint16 *)(dst) = *(const uint16 *)(src)
-
-#endif
-
-#define FILL_4X1_LINE(dst, val) \
-	do {                        \
-		(dst)[0] = val;         \
-		(dst)[1] = val;         \
-		(dst)[2] = val;         \
-		(dst)[3] = val;         \
-	} while (0)
-
-#define FILL_2X1_LINE(dst, val) \
-	do {                        \
-		(dst)[0] = val;         \
-		(dst)[1] = val;         \
-	} while (0)
-
-#define MOTION_OFFSET_TABLE_SIZE 0xF8
-#define PROCESS_SUBBLOCKS        0xFF
-#define FILL_SINGLE_COLOR        0xFE
-#define DRAW_GLYPH               0xFD
-#define COPY_PREV_BUFFER         0xFC
-
 static const  int8 codecGlyph4XVec[] = {
   0, 1, 2, 3, 3, 3, 3, 2, 1, 0, 0, 0, 1, 2, 2, 1,
 };
@@ -372,170 +326,21 @@ extern "C" void ARM_Smush_decode2(      byte  *dst,
 				   _offset1,_offset2,_tableSmall)
 
 #else
-void SmushDeltaGlyphsDecoder::level3(byte *dDst) {
-	int32 tmp;
-	byte code = *_dSrc++;
-
-	if (code < MOTION_OFFSET_TABLE_SIZE) {
-		tmp = _table[code] + _offset1;
-		COPY_2X1_LINE(dDst, dDst + tmp);
-		COPY_2X1_LINE(dDst + _dPitch, dDst + _dPitch + tmp);
-	} else if (code == PROCESS_SUBBLOCKS) {
-		COPY_2X1_LINE(dDst, _dSrc + 0);
-		COPY_2X1_LINE(dDst + _dPitch, _dSrc + 2);
-		_dSrc += 4;
-	} else if (code == FILL_SINGLE_COLOR) {
-		byte t = *_dSrc++;
-		FILL_2X1_LINE(dDst, t);
-		FILL_2X1_LINE(dDst + _dPitch, t);
-	} else if (code == COPY_PREV_BUFFER) {
-		tmp = _offset2;
-		COPY_2X1_LINE(dDst, dDst + tmp);
-		COPY_2X1_LINE(dDst + _dPitch, dDst + _dPitch + tmp);
-	} else {
-		byte t = _paramPtr[code];
-		FILL_2X1_LINE(dDst, t);
-		FILL_2X1_LINE(dDst + _dPitch, t);
-	}
-}
-
-void SmushDeltaGlyphsDecoder::level2(byte *d_dst) {
-	int32 tmp;
-	byte code = *_dSrc++;
-	int i;
-
-	if (code < MOTION_OFFSET_TABLE_SIZE) {
-		tmp = _table[code] + _offset1;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst, d_dst + tmp);
-			d_dst += _dPitch;
-		}
-	} else if (code == PROCESS_SUBBLOCKS) {
-		level3(d_dst);
-		d_dst += 2;
-		level3(d_dst);
-		d_dst += _dPitch * 2 - 2;
-		level3(d_dst);
-		d_dst += 2;
-		level3(d_dst);
-	} else if (code == FILL_SINGLE_COLOR) {
-		byte t = *_dSrc++;
-		for (i = 0; i < 4; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			d_dst += _dPitch;
-		}
-	} else if (code == DRAW_GLYPH) {
-		byte *tmpPtr = _tableSmall + *_dSrc++ * 128;
-		int32 l = tmpPtr[96];
-		byte val = *_dSrc++;
-		int16 *tmpPtr2 = (int16 *)tmpPtr;
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
-			tmpPtr2++;
-		}
-		l = tmpPtr[97];
-		val = *_dSrc++;
-		tmpPtr2 = (int16 *)(tmpPtr + 32);
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
-			tmpPtr2++;
-		}
-	} else if (code == COPY_PREV_BUFFER) {
-		tmp = _offset2;
-		for (i = 0; i < 4; i++) {
-			COPY_4X1_LINE(d_dst, d_dst + tmp);
-			d_dst += _dPitch;
-		}
-	} else {
-		byte t = _paramPtr[code];
-		for (i = 0; i < 4; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			d_dst += _dPitch;
-		}
-	}
-}
-
-void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
-	int32 tmp;
-	byte code = *_dSrc++;
-	int i;
-
-	if (code < MOTION_OFFSET_TABLE_SIZE) {
-		tmp = _table[code] + _offset1;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
-			d_dst += _dPitch;
-		}
-	} else if (code == PROCESS_SUBBLOCKS) {
-		level2(d_dst);
-		d_dst += 4;
-		level2(d_dst);
-		d_dst += _dPitch * 4 - 4;
-		level2(d_dst);
-		d_dst += 4;
-		level2(d_dst);
-	} else if (code == FILL_SINGLE_COLOR) {
-		byte t = *_dSrc++;
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _dPitch;
-		}
-	} else if (code == DRAW_GLYPH) {
-		tmp = *_dSrc++;
-		byte *tmpPtr = _tableBig + tmp * 388;
-		byte l = tmpPtr[384];
-		byte val = *_dSrc++;
-		int16 *tmpPtr2 = (int16 *)tmpPtr;
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
-			tmpPtr2++;
-		}
-		l = tmpPtr[385];
-		val = *_dSrc++;
-		tmpPtr2 = (int16 *)(tmpPtr + 128);
-		while (l--) {
-			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
-			tmpPtr2++;
-		}
-	} else if (code == COPY_PREV_BUFFER) {
-		tmp = _offset2;
-		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
-			d_dst += _dPitch;
-		}
-	} else {
-		byte t = _paramPtr[code];
-		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
-			d_dst += _dPitch;
-		}
-	}
-}
-
 void SmushDeltaGlyphsDecoder::decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr) {
-	_dSrc = src;
-	_paramPtr = param_ptr - MOTION_OFFSET_TABLE_SIZE;
-	int bw = (width + 7) / 8;
-	int bh = (height + 7) / 8;
-	int nextLine = width * 7;
-	_dPitch = width;
-
-	do {
-		int tmpBw = bw;
-		do {
-			level1(dst);
-			dst += 8;
-		} while (--tmpBw);
-		dst += nextLine;
-	} while (--bh);
+	switch (_kernels) {
+#ifdef SCUMMVM_SSE2
+	case kSmushKernelsSSE2:
+		decodeBlocksSSE2(dst, src, width, height, param_ptr);
+		break;
+#endif
+	default:
+		decodeBlocks<SmushScalarBlockOps>(dst, src, width, height, param_ptr);
+		break;
+	}
 }
 #endif
 
-SmushDeltaGlyphsDecoder::SmushDeltaGlyphsDecoder(int width, int height) : _prevSeqNb(0), _dSrc(nullptr), _paramPtr(nullptr), _dPitch(0), _offset1(0), _offset2(0) {
+SmushDeltaGlyphsDecoder::SmushDeltaGlyphsDecoder(int width, int height) : _prevSeqNb(0), _dSrc(nullptr), _paramPtr(nullptr), _dPitch(0), _offset1(0), _offset2(0), _kernels(kSmushKernelsScalar) {
 	_lastTableWidth = -1;
 	_width = width;
 	_height = height;
@@ -24,6 +24,8 @@
 
 #include "common/scummsys.h"
 
+#include "scumm/smush/smush_blocks.h"
+
 namespace Scumm {
 
 class SmushDeltaGlyphsDecoder {
@@ -43,18 +45,30 @@ private:
 	int16 _table[256];
 	int32 _frameSize;
 	int _width, _height;
+	SmushKernels _kernels;
 
 	void makeTablesInterpolation(int param);
 	void makeCodecTables(int width);
+	template<class Ops>
 	void level1(byte *d_dst);
+	template<class Ops>
 	void level2(byte *d_dst);
+	template<class Ops>
 	void level3(byte *d_dst);
+	template<class Ops>
+	void decodeBlocks(byte *dst, const byte *src, int width, int height, const byte *param_ptr);
+#ifdef SCUMMVM_SSE2
+	void decodeBlocksSSE2(byte *dst, const byte *src, int width, int height, const byte *param_ptr);
+#endif
 	void decode2(byte *dst, const byte *src, int width, int height, const byte *param_ptr);
 
 public:
 	SmushDeltaGlyphsDecoder(int width, int height);
 	~SmushDeltaGlyphsDecoder();
 	bool decode(byte *dst, const byte *src);
+
+	/** Select the block kernels used for decoding. */
+	void setKernels(SmushKernels kernels) { _kernels = kernels; }
 };
 
 } // End of namespace Scumm
@@ -0,0 +1,203 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCUMM_SMUSH_CODEC_47_IMPL_H
+#define SCUMM_SMUSH_CODEC_47_IMPL_H
+
+// Block decoding of codec 47, shared by codec47.cpp and the SIMD variants
+// in smush_blocks_*.cpp.
+
+#include "scumm/smush/codec47.h"
+#include "scumm/smush/smush_blocks.h"
+
+namespace Scumm {
+
+#define MOTION_OFFSET_TABLE_SIZE 0xF8
+#define PROCESS_SUBBLOCKS        0xFF
+#define FILL_SINGLE_COLOR        0xFE
+#define DRAW_GLYPH               0xFD
+#define COPY_PREV_BUFFER         0xFC
+
+template<class Ops>
+void SmushDeltaGlyphsDecoder::level3(byte *dDst) {
+	int32 tmp;
+	byte code = *_dSrc++;
+
+	if (code < MOTION_OFFSET_TABLE_SIZE) {
+		tmp = _table[code] + _offset1;
+		Ops::copy2(dDst, dDst + tmp);
+		Ops::copy2(dDst + _dPitch, dDst + _dPitch + tmp);
+	} else if (code == PROCESS_SUBBLOCKS) {
+		Ops::copy2(dDst, _dSrc + 0);
+		Ops::copy2(dDst + _dPitch, _dSrc + 2);
+		_dSrc += 4;
+	} else if (code == FILL_SINGLE_COLOR) {
+		typename Ops::Fill t = Ops::makeFill(*_dSrc++);
+		Ops::fill2(dDst, t);
+		Ops::fill2(dDst + _dPitch, t);
+	} else if (code == COPY_PREV_BUFFER) {
+		tmp = _offset2;
+		Ops::copy2(dDst, dDst + tmp);
+		Ops::copy2(dDst + _dPitch, dDst + _dPitch + tmp);
+	} else {
+		typename Ops::Fill t = Ops::makeFill(_paramPtr[code]);
+		Ops::fill2(dDst, t);
+		Ops::fill2(dDst + _dPitch, t);
+	}
+}
+
+template<class Ops>
+void SmushDeltaGlyphsDecoder::level2(byte *d_dst) {
+	int32 tmp;
+	byte code = *_dSrc++;
+	int i;
+
+	if (code < MOTION_OFFSET_TABLE_SIZE) {
+		tmp = _table[code] + _offset1;
+		for (i = 0; i < 4; i++) {
+			Ops::copy4(d_dst, d_dst + tmp);
+			d_dst += _dPitch;
+		}
+	} else if (code == PROCESS_SUBBLOCKS) {
+		level3<Ops>(d_dst);
+		d_dst += 2;
+		level3<Ops>(d_dst);
+		d_dst += _dPitch * 2 - 2;
+		level3<Ops>(d_dst);
+		d_dst += 2;
+		level3<Ops>(d_dst);
+	} else if (code == FILL_SINGLE_COLOR) {
+		typename Ops::Fill t = Ops::makeFill(*_dSrc++);
+		for (i = 0; i < 4; i++) {
+			Ops::fill4(d_dst, t);
+			d_dst += _dPitch;
+		}
+	} else if (code == DRAW_GLYPH) {
+		byte *tmpPtr = _tableSmall + *_dSrc++ * 128;
+		int32 l = tmpPtr[96];
+		byte val = *_dSrc++;
+		int16 *tmpPtr2 = (int16 *)tmpPtr;
+		while (l--) {
+			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
+			tmpPtr2++;
+		}
+		l = tmpPtr[97];
+		val = *_dSrc++;
+		tmpPtr2 = (int16 *)(tmpPtr + 32);
+		while (l--) {
+			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
+			tmpPtr2++;
+		}
+	} else if (code == COPY_PREV_BUFFER) {
+		tmp = _offset2;
+		for (i = 0; i < 4; i++) {
+			Ops::copy4(d_dst, d_dst + tmp);
+			d_dst += _dPitch;
+		}
+	} else {
+		typename Ops::Fill t = Ops::makeFill(_paramPtr[code]);
+		for (i = 0; i < 4; i++) {
+			Ops::fill4(d_dst, t);
+			d_dst += _dPitch;
+		}
+	}
+}
+
+template<class Ops>
+void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
+	int32 tmp;
+	byte code = *_dSrc++;
+	int i;
+
+	if (code < MOTION_OFFSET_TABLE_SIZE) {
+		tmp = _table[code] + _offset1;
+		for (i = 0; i < 8; i++) {
+			Ops::copy8(d_dst, d_dst + tmp);
+			d_dst += _dPitch;
+		}
+	} else if (code == PROCESS_SUBBLOCKS) {
+		level2<Ops>(d_dst);
+		d_dst += 4;
+		level2<Ops>(d_dst);
+		d_dst += _dPitch * 4 - 4;
+		level2<Ops>(d_dst);
+		d_dst += 4;
+		level2<Ops>(d_dst);
+	} else if (code == FILL_SINGLE_COLOR) {
+		typename Ops::Fill t = Ops::makeFill(*_dSrc++);
+		for (i = 0; i < 8; i++) {
+			Ops::fill8(d_dst, t);
+			d_dst += _dPitch;
+		}
+	} else if (code == DRAW_GLYPH) {
+		tmp = *_dSrc++;
+		byte *tmpPtr = _tableBig + tmp * 388;
+		byte l = tmpPtr[384];
+		byte val = *_dSrc++;
+		int16 *tmpPtr2 = (int16 *)tmpPtr;
+		while (l--) {
+			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
+			tmpPtr2++;
+		}
+		l = tmpPtr[385];
+		val = *_dSrc++;
+		tmpPtr2 = (int16 *)(tmpPtr + 128);
+		while (l--) {
+			*(d_dst + READ_LE_UINT16(tmpPtr2)) = val;
+			tmpPtr2++;
+		}
+	} else if (code == COPY_PREV_BUFFER) {
+		tmp = _offset2;
+		for (i = 0; i < 8; i++) {
+			Ops::copy8(d_dst, d_dst + tmp);
+			d_dst += _dPitch;
+		}
+	} else {
+		typename Ops::Fill t = Ops::makeFill(_paramPtr[code]);
+		for (i = 0; i < 8; i++) {
+			Ops::fill8(d_dst, t);
+			d_dst += _dPitch;
+		}
+	}
+}
+
+template<class Ops>
+void SmushDeltaGlyphsDecoder::decodeBlocks(byte *dst, const byte *src, int width, int height, const byte *param_ptr) {
+	_dSrc = src;
+	_paramPtr = param_ptr - MOTION_OFFSET_TABLE_SIZE;
+	int bw = (width + 7) / 8;
+	int bh = (height + 7) / 8;
+	int nextLine = width * 7;
+	_dPitch = width;
+
+	do {
+		int tmpBw = bw;
+		do {
+			level1<Ops>(dst);
+			dst += 8;
+		} while (--tmpBw);
+		dst += nextLine;
+	} while (--bh);
+}
+
+} // End of namespace Scumm
+
+#endif
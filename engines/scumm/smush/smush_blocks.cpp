@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/compression/deflate.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "scumm/smush/codec37.h"
+#include "scumm/smush/codec47.h"
+#include "scumm/smush/smush_blocks.h"
+
+namespace Scumm {
+
+SmushKernels getBestSmushKernels() {
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return kSmushKernelsSSE2;
+#endif
+	return kSmushKernelsScalar;
+}
+
+const char *getSmushKernelsName(SmushKernels kernels) {
+	switch (kernels) {
+	case kSmushKernelsSSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+int decodeSmushFrames(Common::SeekableReadStream &stream, SmushKernels kernels) {
+	SmushDeltaBlocksDecoder *deltaBlocksCodec = nullptr;
+	SmushDeltaGlyphsDecoder *deltaGlyphsCodec = nullptr;
+	byte *dst = nullptr;
+	int frameWidth = 0, frameHeight = 0;
+	int frames = 0;
+
+	if (stream.readUint32BE() != MKTAG('A','N','I','M'))
+		return -1;
+	const uint32 animSize = stream.readUint32BE() + 8;
+
+	while ((uint32)stream.pos() + 8 <= animSize && !stream.eos()) {
+		const uint32 type = stream.readUint32BE();
+		const int32 size = stream.readUint32BE();
+		const int64 offset = stream.pos();
+
+		if (type == MKTAG('F','R','M','E')) {
+			bool decoded = false;
+			int32 frameSize = size;
+
+			while (frameSize > 0 && !stream.eos()) {
+				const uint32 subType = stream.readUint32BE();
+				const int32 subSize = stream.readUint32BE();
+				const int64 subOffset = stream.pos();
+
+				byte *object = nullptr;
+				if (subType == MKTAG('F','O','B','J') && subSize >= 14) {
+					object = (byte *)malloc(subSize);
+					stream.read(object, subSize);
+				} else if (subType == MKTAG('Z','F','O','B') && subSize >= 4) {
+					byte *chunk = (byte *)malloc(subSize);
+					stream.read(chunk, subSize);
+					unsigned long objectSize = READ_BE_UINT32(chunk);
+					object = (byte *)malloc(objectSize);
+					if (objectSize < 14 || !Common::inflateZlib(object, &objectSize, chunk + 4, subSize - 4)) {
+						free(object);
+						object = nullptr;
+					}
+					free(chunk);
+				}
+
+				if (object) {
+					const int codec = READ_LE_UINT16(object);
+					const int width = READ_LE_UINT16(object + 6);
+					const int height = READ_LE_UINT16(object + 8);
+
+					// Like the player, only decode the objects covering the whole frame
+					if ((codec == 37 || codec == 47) && !dst) {
+						frameWidth = width;
+						frameHeight = height;
+						dst = (byte *)malloc(width * height);
+					}
+
+					if (width == frameWidth && height == frameHeight) {
+						if (codec == 37) {
+							if (!deltaBlocksCodec) {
+								deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
+								deltaBlocksCodec->setKernels(kernels);
+							}
+							deltaBlocksCodec->decode(dst, object + 14);
+							decoded = true;
+						} else if (codec == 47) {
+							if (!deltaGlyphsCodec) {
+								deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
+								deltaGlyphsCodec->setKernels(kernels);
+							}
+							deltaGlyphsCodec->decode(dst, object + 14);
+							decoded = true;
+						}
+					}
+					free(object);
+				}
+
+				frameSize -= subSize + 8 + (subSize & 1);
+				stream.seek(subOffset + subSize + (subSize & 1), SEEK_SET);
+			}
+
+			if (decoded)
+				frames++;
+		}
+
+		stream.seek(offset + size, SEEK_SET);
+	}
+
+	delete deltaBlocksCodec;
+	delete deltaGlyphsCodec;
+	free(dst);
+
+	return frames;
+}
+
+} // End of namespace Scumm
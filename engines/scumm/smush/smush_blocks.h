@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCUMM_SMUSH_BLOCKS_H
+#define SCUMM_SMUSH_BLOCKS_H
+
+#include "common/endian.h"
+#include "common/scummsys.h"
+
+namespace Common {
+class SeekableReadStream;
+}
+
+namespace Scumm {
+
+/**
+ * Block kernels used by the delta codecs 37 and 47. The codecs pick one
+ * of them at runtime through setKernels().
+ */
+enum SmushKernels {
+	kSmushKernelsScalar,
+	kSmushKernelsSSE2
+};
+
+/** Return the fastest kernels the CPU supports. */
+SmushKernels getBestSmushKernels();
+
+/** Return a name for the kernels, for debug output. */
+const char *getSmushKernelsName(SmushKernels kernels);
+
+/**
+ * Decode the codec 37 and 47 frame objects of a SMUSH animation without
+ * displaying them, to measure the speed of the block kernels.
+ *
+ * @return the number of frames decoded, or -1 if this is no animation
+ */
+int decodeSmushFrames(Common::SeekableReadStream &stream, SmushKernels kernels);
+
+/**
+ * Scalar block kernels.
+ *
+ * The codecs are templates on a class providing these functions, and are
+ * instantiated with this one and with the SSE2 variant from
+ * smush_blocks_sse2.cpp. Blocks copied from another place always come from
+ * a different frame buffer, so source and destination never overlap.
+ */
+struct SmushScalarBlockOps {
+	/** A pixel value repeated to fill a block row */
+	typedef uint32 Fill;
+
+	static inline Fill makeFill(byte color) {
+		return color * 0x01010101U;
+	}
+
+	static inline void fill2(byte *dst, Fill v) {
+		WRITE_UINT16(dst, (uint16)v);
+	}
+
+	static inline void fill4(byte *dst, Fill v) {
+		WRITE_UINT32(dst, v);
+	}
+
+	static inline void fill8(byte *dst, Fill v) {
+		WRITE_UINT32(dst, v);
+		WRITE_UINT32(dst + 4, v);
+	}
+
+	static inline void copy2(byte *dst, const byte *src) {
+		WRITE_UINT16(dst, READ_UINT16(src));
+	}
+
+	static inline void copy4(byte *dst, const byte *src) {
+		WRITE_UINT32(dst, READ_UINT32(src));
+	}
+
+	static inline void copy8(byte *dst, const byte *src) {
+		WRITE_UINT32(dst, READ_UINT32(src));
+		WRITE_UINT32(dst + 4, READ_UINT32(src + 4));
+	}
+
+	/** Copy a row of several 4 pixel wide blocks. */
+	static inline void copyRow(byte *dst, const byte *src, int width) {
+		memcpy(dst, src, width);
+	}
+};
+
+} // End of namespace Scumm
+
+#endif
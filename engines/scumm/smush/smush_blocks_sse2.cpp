@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "scumm/smush/codec37_impl.h"
+#include "scumm/smush/codec47_impl.h"
+
+namespace Scumm {
+
+/**
+ * SSE2 block kernels. 8 pixel rows are moved with a single 64-bit load and
+ * store, and runs of blocks with 16 byte wide ones. Rows of 4 and 2 pixels
+ * keep the scalar stores, which are as wide as they can be.
+ */
+struct SmushSSE2BlockOps {
+	typedef __m128i Fill;
+
+	static inline Fill makeFill(byte color) {
+		return _mm_set1_epi8((char)color);
+	}
+
+	static inline void fill2(byte *dst, Fill v) {
+		WRITE_UINT16(dst, (uint16)_mm_cvtsi128_si32(v));
+	}
+
+	static inline void fill4(byte *dst, Fill v) {
+		WRITE_UINT32(dst, (uint32)_mm_cvtsi128_si32(v));
+	}
+
+	static inline void fill8(byte *dst, Fill v) {
+		_mm_storel_epi64((__m128i *)dst, v);
+	}
+
+	static inline void copy2(byte *dst, const byte *src) {
+		SmushScalarBlockOps::copy2(dst, src);
+	}
+
+	static inline void copy4(byte *dst, const byte *src) {
+		SmushScalarBlockOps::copy4(dst, src);
+	}
+
+	static inline void copy8(byte *dst, const byte *src) {
+		_mm_storel_epi64((__m128i *)dst, _mm_loadl_epi64((const __m128i *)src));
+	}
+
+	static inline void copyRow(byte *dst, const byte *src, int width) {
+		for (; width >= 16; width -= 16, dst += 16, src += 16)
+			_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		if (width >= 8) {
+			copy8(dst, src);
+			width -= 8;
+			dst += 8;
+			src += 8;
+		}
+		if (width >= 4)
+			copy4(dst, src);
+	}
+};
+
+void SmushDeltaBlocksDecoder::decodeBlocksSSE2(byte type, byte maskFlags, byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch) {
+	decodeBlocks<SmushSSE2BlockOps>(type, maskFlags, dst, src, nextOffs, bw, bh, pitch);
+}
+
+void SmushDeltaGlyphsDecoder::decodeBlocksSSE2(byte *dst, const byte *src, int width, int height, const byte *param_ptr) {
+	decodeBlocks<SmushSSE2BlockOps>(dst, src, width, height, param_ptr);
+}
+
+} // End of namespace Scumm
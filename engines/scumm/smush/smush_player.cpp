@@ -777,14 +777,18 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		smushDecodeRLE(_dst, src, left, top, width, height, _vm->_screenWidth);
 		break;
 	case SMUSH_CODEC_DELTA_BLOCKS:
-		if (!_deltaBlocksCodec)
+		if (!_deltaBlocksCodec) {
 			_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
+			_deltaBlocksCodec->setKernels(getBestSmushKernels());
+		}
 		if (_deltaBlocksCodec)
 			_deltaBlocksCodec->decode(_dst, src);
 		break;
 	case SMUSH_CODEC_DELTA_GLYPHS:
-		if (!_deltaGlyphsCodec)
+		if (!_deltaGlyphsCodec) {
 			_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
+			_deltaGlyphsCodec->setKernels(getBestSmushKernels());
+		}
 		if (_deltaGlyphsCodec)
 			_deltaGlyphsCodec->decode(_dst, src);
 		break;
@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/dirtytiles.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Graphics {
+
+uint64 DirtyTileTracker::hashTileSSE2(const byte *src, uint pitch, uint rowBytes, uint rows) {
+	const __m128i multiplierLow = _mm_set1_epi64x(kHashMultiplierLow);
+	const __m128i multiplierHigh = _mm_set1_epi64x(kHashMultiplierHigh);
+	__m128i lanes = _mm_set_epi64x(kHashSeed1, kHashSeed0);
+	const uint chunkBytes = rowBytes & ~15;
+
+	for (uint y = 0; y < rows; y++) {
+		uint x = 0;
+		for (; x < chunkBytes; x += 16) {
+			lanes = _mm_xor_si128(lanes, _mm_loadu_si128((const __m128i *)(src + x)));
+			lanes = _mm_add_epi64(_mm_mul_epu32(lanes, multiplierLow),
+				_mm_mul_epu32(_mm_srli_epi64(lanes, 32), multiplierHigh));
+		}
+		if (x < rowBytes) {
+			byte padded[16];
+			memset(padded, 0, sizeof(padded));
+			memcpy(padded, src + x, rowBytes - x);
+			lanes = _mm_xor_si128(lanes, _mm_loadu_si128((const __m128i *)padded));
+			lanes = _mm_add_epi64(_mm_mul_epu32(lanes, multiplierLow),
+				_mm_mul_epu32(_mm_srli_epi64(lanes, 32), multiplierHigh));
+		}
+		src += pitch;
+	}
+
+	uint64 result[2];
+	_mm_storeu_si128((__m128i *)result, lanes);
+	return finishHash(result[0], result[1]);
+}
+
+} // End of namespace Graphics
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
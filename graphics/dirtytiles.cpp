@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/endian.h"
+#include "common/system.h"
+
+#include "graphics/dirtytiles.h"
+#include "graphics/surface.h"
+
+namespace Graphics {
+
+DirtyTileTracker::DirtyTileTracker(TileHashFunc hashTile) : _hashTile(hashTile), _columns(0), _rows(0),
+		_bytesPerPixel(0), _valid(false), _checkedPixels(0), _changedPixels(0) {
+	if (_hashTile)
+		return;
+
+	_hashTile = hashTileGeneric;
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		_hashTile = hashTileSSE2;
+#endif
+}
+
+void DirtyTileTracker::reset() {
+	_valid = false;
+}
+
+void DirtyTileTracker::resetStatistics() {
+	_checkedPixels = 0;
+	_changedPixels = 0;
+}
+
+uint DirtyTileTracker::update(const Surface &surface, const Common::Rect &area, Common::Array<Common::Rect> &dirtyRects) {
+	dirtyRects.clear();
+
+	const uint columns = (surface.w + kTileSize - 1) / kTileSize;
+	const uint rows = (surface.h + kTileSize - 1) / kTileSize;
+	if (columns != _columns || rows != _rows || surface.format.bytesPerPixel != _bytesPerPixel) {
+		_columns = columns;
+		_rows = rows;
+		_bytesPerPixel = surface.format.bytesPerPixel;
+		_hashes.resize(columns * rows);
+		_valid = false;
+	}
+
+	Common::Rect checked(surface.w, surface.h);
+	if (_valid)
+		checked.clip(area);
+	if (checked.isEmpty())
+		return 0;
+
+	const uint firstColumn = checked.left / kTileSize;
+	const uint lastColumn = (checked.right - 1) / kTileSize;
+	const uint firstRow = checked.top / kTileSize;
+	const uint lastRow = (checked.bottom - 1) / kTileSize;
+
+	uint changedPixels = 0;
+	for (uint row = firstRow; row <= lastRow; row++) {
+		const int top = row * kTileSize;
+		const int bottom = MIN<int>(top + kTileSize, surface.h);
+		const uint rowStart = dirtyRects.size();
+		int runStart = -1;
+
+		for (uint column = firstColumn; column <= lastColumn + 1; column++) {
+			bool changed = false;
+			if (column <= lastColumn) {
+				const int left = column * kTileSize;
+				const int right = MIN<int>(left + kTileSize, surface.w);
+				const uint64 hash = _hashTile((const byte *)surface.getBasePtr(left, top), surface.pitch,
+					(right - left) * _bytesPerPixel, bottom - top);
+
+				uint64 &previous = _hashes[row * _columns + column];
+				changed = !_valid || hash != previous;
+				previous = hash;
+
+				_checkedPixels += (right - left) * (bottom - top);
+				if (changed)
+					changedPixels += (right - left) * (bottom - top);
+			}
+
+			if (changed) {
+				if (runStart < 0)
+					runStart = column * kTileSize;
+				continue;
+			}
+			if (runStart < 0)
+				continue;
+
+			// Grow the rectangle of the previous tile row spanning the same
+			// columns, if there is one, instead of starting a new one
+			const Common::Rect run(runStart, top, MIN<int>(column * kTileSize, surface.w), bottom);
+			runStart = -1;
+
+			bool merged = false;
+			for (uint i = 0; i < rowStart; i++) {
+				Common::Rect &r = dirtyRects[i];
+				if (r.left == run.left && r.right == run.right && r.bottom == run.top) {
+					r.bottom = run.bottom;
+					merged = true;
+					break;
+				}
+			}
+			if (!merged)
+				dirtyRects.push_back(run);
+		}
+	}
+
+	_valid = true;
+	_changedPixels += changedPixels;
+	return changedPixels;
+}
+
+uint64 DirtyTileTracker::finishHash(uint64 lane0, uint64 lane1) {
+	uint64 hash = lane0 ^ (lane1 * 0xff51afd7ed558ccdULL);
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 29;
+	return hash;
+}
+
+uint64 DirtyTileTracker::hashTileGeneric(const byte *src, uint pitch, uint rowBytes, uint rows) {
+	uint64 lane0 = kHashSeed0;
+	uint64 lane1 = kHashSeed1;
+	const uint chunkBytes = rowBytes & ~15;
+
+	for (uint y = 0; y < rows; y++) {
+		for (uint x = 0; x < rowBytes; x += 16) {
+			const byte *chunk = src + x;
+
+			// The last bytes of a row are zero padded to a whole chunk
+			byte padded[16];
+			if (x >= chunkBytes) {
+				memset(padded, 0, sizeof(padded));
+				memcpy(padded, chunk, rowBytes - x);
+				chunk = padded;
+			}
+
+			lane0 ^= READ_LE_UINT64(chunk);
+			lane1 ^= READ_LE_UINT64(chunk + 8);
+			lane0 = (lane0 & 0xffffffff) * kHashMultiplierLow + (lane0 >> 32) * kHashMultiplierHigh;
+			lane1 = (lane1 & 0xffffffff) * kHashMultiplierLow + (lane1 >> 32) * kHashMultiplierHigh;
+		}
+		src += pitch;
+	}
+
+	return finishHash(lane0, lane1);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,120 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_DIRTYTILES_H
+#define GRAPHICS_DIRTYTILES_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirtytiles Dirty tiles
+ * @ingroup graphics
+ *
+ * @brief DirtyTileTracker class for finding the changed parts of a surface.
+ * @{
+ */
+
+struct Surface;
+
+typedef uint64 (*TileHashFunc)(const byte *src, uint pitch, uint rowBytes, uint rows);
+
+/**
+ * Finds the parts of a surface which changed since it was last checked, by
+ * comparing checksums of 16x16 pixel tiles with the ones computed for the
+ * previous frame.
+ *
+ * This is meant for backends running engines which redraw their whole screen
+ * every frame, for which the areas passed to copyRectToScreen() do not tell
+ * what actually changed on the screen.
+ */
+class DirtyTileTracker {
+public:
+	static const int kTileSize = 16;
+
+	/**
+	 * @param hashTile  The checksum function to use, by default the fastest
+	 *                  one for the host CPU.
+	 */
+	explicit DirtyTileTracker(TileHashFunc hashTile = nullptr);
+
+	/**
+	 * Forget the checksums of the previous frame, so that the whole surface
+	 * is reported as changed by the next update().
+	 */
+	void reset();
+
+	/**
+	 * Compare the tiles overlapping the given area with the previous frame.
+	 *
+	 * @param surface     The surface to check.
+	 * @param area        The part of the surface which may have changed. The
+	 *                    tiles outside of it are assumed to be unchanged.
+	 * @param dirtyRects  Filled with the changed areas, clipped to the surface.
+	 *                    Adjacent changed tiles are merged into rectangles.
+	 * @return The number of pixels in the changed areas.
+	 */
+	uint update(const Surface &surface, const Common::Rect &area, Common::Array<Common::Rect> &dirtyRects);
+
+	/** Number of pixels compared by update() since the last resetStatistics(). */
+	uint64 getCheckedPixels() const { return _checkedPixels; }
+	/** Number of pixels found changed by update() since the last resetStatistics(). */
+	uint64 getChangedPixels() const { return _changedPixels; }
+	void resetStatistics();
+
+	/**
+	 * Checksum of a tile, computed over rows of rowBytes bytes. All the
+	 * variants return the same value for the same input.
+	 */
+	static uint64 hashTileGeneric(const byte *src, uint pitch, uint rowBytes, uint rows);
+#ifdef SCUMMVM_SSE2
+	static uint64 hashTileSSE2(const byte *src, uint pitch, uint rowBytes, uint rows);
+#endif
+
+private:
+	// Every 16 bytes of a row are xored into two 64-bit lanes, each lane
+	// then being multiplied with the constants below, a half at a time.
+	static const uint32 kHashMultiplierLow = 0x9e3779b1;
+	static const uint32 kHashMultiplierHigh = 0x85ebca77;
+	static const uint64 kHashSeed0 = 0x243f6a8885a308d3ULL;
+	static const uint64 kHashSeed1 = 0x13198a2e03707344ULL;
+
+	static uint64 finishHash(uint64 lane0, uint64 lane1);
+
+	TileHashFunc _hashTile;
+
+	Common::Array<uint64> _hashes;
+	uint _columns, _rows;
+	uint _bytesPerPixel;
+	bool _valid;
+
+	uint64 _checkedPixels;
+	uint64 _changedPixels;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
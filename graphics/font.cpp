@@ -55,7 +55,8 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	// that we do allow an empty width to be specified here. This allows us
 	// to obtain the complete bounding box of a string.
 	const int leftX = x, rightX = w ? (x + w + 1) : 0x7FFFFFFF;
-	int width = font.getStringWidth(str);
+	const Common::Array<int> *layout = font.getStringLayout(str);
+	int width = layout ? layout->back() : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -67,16 +68,22 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	Common::Rect bbox;
 
 	typename StringType::unsigned_type last = 0;
-	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
-		const typename StringType::unsigned_type cur = *i;
-		x += font.getKerningOffset(last, cur);
-		last = cur;
+	for (uint i = 0; i < str.size(); ++i) {
+		const typename StringType::unsigned_type cur = str[i];
+		int charX;
+		if (layout) {
+			charX = x + (*layout)[i];
+		} else {
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+			charX = x;
+		}
 
 		Common::Rect charBox = font.getBoundingBox(cur);
-		if (x + charBox.right > rightX)
+		if (charX + charBox.right > rightX)
 			break;
-		if (x + charBox.right >= leftX) {
-			charBox.translate(x, y);
+		if (charX + charBox.right >= leftX) {
+			charBox.translate(charX, y);
 			if (first) {
 				bbox = charBox;
 				first = false;
@@ -85,7 +92,8 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 			}
 		}
 
-		x += font.getCharWidth(cur);
+		if (!layout)
+			x += font.getCharWidth(cur);
 	}
 
 	return bbox;
@@ -93,6 +101,10 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 
 template<class StringType>
 int getStringWidthImpl(const Font &font, const StringType &str) {
+	const Common::Array<int> *layout = font.getStringLayout(str);
+	if (layout)
+		return layout->back();
+
 	int space = 0;
 	typename StringType::unsigned_type last = 0;
 
@@ -112,7 +124,8 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 	assert(dst != 0);
 
 	const int leftX = x, rightX = x + w + 1;
-	int width = font.getStringWidth(str);
+	const Common::Array<int> *layout = font.getStringLayout(str);
+	int width = layout ? layout->back() : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -121,18 +134,25 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 	x += deltax;
 
 	typename StringType::unsigned_type last = 0;
-	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
-		const typename StringType::unsigned_type cur = *i;
-		x += font.getKerningOffset(last, cur);
-		last = cur;
+	for (uint i = 0; i < str.size(); ++i) {
+		const typename StringType::unsigned_type cur = str[i];
+		int charX;
+		if (layout) {
+			charX = x + (*layout)[i];
+		} else {
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+			charX = x;
+		}
 
 		Common::Rect charBox = font.getBoundingBox(cur);
-		if (x + charBox.right > rightX)
+		if (charX + charBox.right > rightX)
 			break;
-		if (x + charBox.right >= leftX)
-			font.drawChar(dst, cur, x, y, color);
+		if (charX + charBox.right >= leftX)
+			font.drawChar(dst, cur, charX, y, color);
 
-		x += font.getCharWidth(cur);
+		if (!layout)
+			x += font.getCharWidth(cur);
 	}
 }
 
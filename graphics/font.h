@@ -166,6 +166,24 @@ public:
 	 */
 	virtual Common::Rect getBoundingBox(uint32 chr) const;
 
+	/**
+	 * Query the cached layout of a string.
+	 *
+	 * The layout holds the pen position of every character of the string,
+	 * kerning included, followed by the width of the whole string. It stays
+	 * valid until the next layout is queried from the font.
+	 *
+	 * The default implementation does not cache layouts, in which case
+	 * drawString and friends query every character on their own.
+	 *
+	 * @param str  The string to lay out.
+	 *
+	 * @return The layout of the string, or nullptr if none is available.
+	 */
+	virtual const Common::Array<int> *getStringLayout(const Common::String &str) const { return nullptr; }
+	/** @overload */
+	virtual const Common::Array<int> *getStringLayout(const Common::U32String &str) const { return nullptr; }
+
 	/**
 	 * Return the bounding box of a string drawn with drawString.
 	 *
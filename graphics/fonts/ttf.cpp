@@ -32,6 +32,7 @@
 #include "graphics/managed_surface.h"
 
 #include "common/ustr.h"
+#include "common/debug.h"
 #include "common/file.h"
 #include "common/config-manager.h"
 #include "common/singleton.h"
@@ -87,6 +88,17 @@ inline int divRoundToNearest(int dividend, int divisor) {
 	return (dividend + (divisor / 2)) / divisor;
 }
 
+// Default size of the atlas pages the glyph bitmaps are packed into
+const int kAtlasPageSize = 256;
+
+// Atlas memory of a font above which it reuses its least recently used page
+// instead of allocating another one
+const uint32 kAtlasFontBudget = 2 * 1024 * 1024;
+
+// Number of string layouts cached per font, and the longest cached string
+const uint kMaxLayouts = 256;
+const uint kMaxLayoutLength = 1024;
+
 } // End of anonymous namespace
 
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
@@ -101,9 +113,15 @@ public:
 
 	bool loadFont(const uint8 *file, const int32 face_index, const uint32 size, FT_Face &face);
 	void closeFont(FT_Face &face);
+
+	/**
+	 * Usage of the glyph atlases and layout caches, shared by all fonts.
+	 */
+	TTFCacheStats &getCacheStats() { return _cacheStats; }
 private:
 	FT_Library _library;
 	bool _initialized;
+	TTFCacheStats _cacheStats;
 };
 
 void shutdownTTF() {
@@ -136,6 +154,20 @@ void TTFLibrary::closeFont(FT_Face &face) {
 	FT_Done_Face(face);
 }
 
+TTFCacheStats getTTFCacheStats() {
+	TTFCacheStats stats = g_ttf.getCacheStats();
+	stats.atlasBudget = kAtlasFontBudget;
+	return stats;
+}
+
+void resetTTFCacheStats() {
+	TTFCacheStats &stats = g_ttf.getCacheStats();
+	stats.atlasPeakBytes = stats.atlasBytes;
+	stats.atlasEvictions = 0;
+	stats.layoutHits = 0;
+	stats.layoutMisses = 0;
+}
+
 class TTFFont : public Font {
 public:
 	TTFFont();
@@ -158,6 +190,9 @@ public:
 
 	Common::Rect getBoundingBox(uint32 chr) const override;
 
+	const Common::Array<int> *getStringLayout(const Common::String &str) const override;
+	const Common::Array<int> *getStringLayout(const Common::U32String &str) const override;
+
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
@@ -172,7 +207,9 @@ private:
 	int _ascent, _descent;
 
 	struct Glyph {
-		Surface image;
+		int page;
+		int x, y;
+		int width, height;
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
@@ -184,6 +221,53 @@ private:
 	bool _allowLateCaching;
 	void assureCached(uint32 chr) const;
 
+	// The glyph bitmaps are packed into 8bpp atlas pages, filled shelf by
+	// shelf from the top
+	struct AtlasPage {
+		Surface surface;
+		int shelfX, shelfY;
+		int shelfHeight;
+		uint32 lastUse;
+	};
+
+	typedef Common::Array<AtlasPage *> Atlas;
+	mutable Atlas _atlas;
+	mutable int _atlasFillPage;      ///< Page new glyphs are added to, or -1
+	mutable uint32 _atlasBytes;      ///< Memory used by the pages of this font
+	mutable uint32 _atlasUseCounter; ///< Time stamp of the last page use
+	uint8 *allocateGlyph(Glyph &glyph, int width, int height, int &pitch) const;
+	int evictAtlasPage(int width, int height) const;
+	void touchAtlasPage(int page) const;
+	void freeAtlas() const;
+
+	// Laid out strings, linked in most recently used order. Single byte and
+	// UTF-32 strings are looked up in separate maps, so that neither has to
+	// be converted to the other.
+	struct TextLayout {
+		Common::String str;
+		Common::U32String u32Str;
+		bool isU32;
+		Common::Array<int> penX;
+		int prev, next;
+
+		TextLayout() : isU32(false), prev(-1), next(-1) {}
+	};
+
+	typedef Common::HashMap<Common::String, int> TextLayoutMap;
+	typedef Common::HashMap<Common::U32String, int> U32TextLayoutMap;
+	mutable Common::Array<TextLayout> _layouts;
+	mutable TextLayoutMap _layoutMap;
+	mutable U32TextLayoutMap _u32LayoutMap;
+	mutable int _layoutFirst, _layoutLast;
+	const Common::Array<int> *useLayout(int index) const;
+	int allocateLayout() const;
+	template<class StringType>
+	void layOutString(TextLayout &layout, const StringType &str) const;
+	static uint32 getLayoutBytes(const TextLayout &layout);
+	void freeLayouts() const;
+	void linkLayout(int index) const;
+	void unlinkLayout(int index) const;
+
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
@@ -203,7 +287,9 @@ private:
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
+	  _hasKerning(false), _allowLateCaching(false), _atlasFillPage(-1), _atlasBytes(0),
+	  _atlasUseCounter(0), _layoutFirst(-1), _layoutLast(-1),
+	  _fakeBold(false), _fakeItalic(false) {
 }
 
 TTFFont::~TTFFont() {
@@ -213,11 +299,11 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	freeAtlas();
+	freeLayouts();
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode,
@@ -373,8 +459,9 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 
 		// Load all ISO-8859-1 characters.
 		for (uint i = 0; i < 256; ++i) {
-			if (!cacheGlyph(_glyphs[i], i)) {
-				_glyphs.erase(i);
+			Glyph glyph;
+			if (cacheGlyph(glyph, i)) {
+				_glyphs[i] = glyph;
 			}
 		}
 	} else {
@@ -386,16 +473,16 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 			const bool isRequired = (mapping[i] & 0x80000000) != 0;
 			// Check whether loading an important glyph fails and error out if
 			// that is the case.
-			if (!cacheGlyph(_glyphs[i], unicode)) {
-				_glyphs.erase(i);
-				if (isRequired) {
-					g_ttf.closeFont(_face);
+			Glyph glyph;
+			if (cacheGlyph(glyph, unicode)) {
+				_glyphs[i] = glyph;
+			} else if (isRequired) {
+				g_ttf.closeFont(_face);
 
-					// Don't delete ttfFile as we return fail
-					_ttfFile = 0;
+				// Don't delete ttfFile as we return fail
+				_ttfFile = 0;
 
-					return false;
-				}
+				return false;
 			}
 		}
 	}
@@ -565,12 +652,12 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
 	FT_UInt leftGlyph, rightGlyph;
 	GlyphCache::const_iterator glyphEntry;
 
+	// Caching the right glyph may make room in the atlas by dropping the
+	// left one, so its slot is looked up first
+	assureCached(left);
 	glyphEntry = _glyphs.find(left);
 	if (glyphEntry != _glyphs.end()) {
 		leftGlyph = glyphEntry->_value.slot;
@@ -578,6 +665,7 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 		return 0;
 	}
 
+	assureCached(right);
 	glyphEntry = _glyphs.find(right);
 	if (glyphEntry != _glyphs.end()) {
 		rightGlyph = glyphEntry->_value.slot;
@@ -599,13 +687,145 @@ Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
 	if (glyphEntry == _glyphs.end()) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		const Glyph &glyph = glyphEntry->_value;
+		return Common::Rect(glyph.xOffset, glyph.yOffset, glyph.xOffset + glyph.width, glyph.yOffset + glyph.height);
 	}
 }
 
+const Common::Array<int> *TTFFont::getStringLayout(const Common::String &str) const {
+	if (str.size() > kMaxLayoutLength)
+		return nullptr;
+
+	TextLayoutMap::const_iterator entry = _layoutMap.find(str);
+	if (entry != _layoutMap.end())
+		return useLayout(entry->_value);
+
+	const int index = allocateLayout();
+	TextLayout &layout = _layouts[index];
+	layout.str = str;
+	layout.isU32 = false;
+	layOutString(layout, str);
+	_layoutMap[str] = index;
+	return &layout.penX;
+}
+
+const Common::Array<int> *TTFFont::getStringLayout(const Common::U32String &str) const {
+	if (str.size() > kMaxLayoutLength)
+		return nullptr;
+
+	U32TextLayoutMap::const_iterator entry = _u32LayoutMap.find(str);
+	if (entry != _u32LayoutMap.end())
+		return useLayout(entry->_value);
+
+	const int index = allocateLayout();
+	TextLayout &layout = _layouts[index];
+	layout.u32Str = str;
+	layout.isU32 = true;
+	layOutString(layout, str);
+	_u32LayoutMap[str] = index;
+	return &layout.penX;
+}
+
+const Common::Array<int> *TTFFont::useLayout(int index) const {
+	g_ttf.getCacheStats().layoutHits++;
+	if (index != _layoutFirst) {
+		unlinkLayout(index);
+		linkLayout(index);
+	}
+	return &_layouts[index].penX;
+}
+
+int TTFFont::allocateLayout() const {
+	TTFCacheStats &stats = g_ttf.getCacheStats();
+	stats.layoutMisses++;
+
+	int index;
+	if (_layouts.size() < kMaxLayouts) {
+		index = _layouts.size();
+		_layouts.push_back(TextLayout());
+		stats.layouts++;
+	} else {
+		// Reuse the least recently used layout
+		index = _layoutLast;
+		unlinkLayout(index);
+
+		TextLayout &layout = _layouts[index];
+		stats.layoutBytes -= getLayoutBytes(layout);
+		if (layout.isU32) {
+			_u32LayoutMap.erase(layout.u32Str);
+			layout.u32Str.clear();
+		} else {
+			_layoutMap.erase(layout.str);
+			layout.str.clear();
+		}
+	}
+
+	linkLayout(index);
+	return index;
+}
+
+template<class StringType>
+void TTFFont::layOutString(TextLayout &layout, const StringType &str) const {
+	layout.penX.resize(str.size() + 1);
+
+	// This is the same pen movement as drawString does without a layout. The
+	// characters of single byte strings are used as they are.
+	int x = 0;
+	typename StringType::unsigned_type last = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		const typename StringType::unsigned_type cur = str[i];
+		x += getKerningOffset(last, cur);
+		last = cur;
+
+		layout.penX[i] = x;
+		x += getCharWidth(cur);
+	}
+	layout.penX[str.size()] = x;
+
+	g_ttf.getCacheStats().layoutBytes += getLayoutBytes(layout);
+}
+
+uint32 TTFFont::getLayoutBytes(const TextLayout &layout) {
+	const uint32 strBytes = layout.isU32 ? layout.u32Str.size() * sizeof(Common::u32char_type_t) : layout.str.size();
+	return sizeof(TextLayout) + strBytes + layout.penX.size() * sizeof(int);
+}
+
+void TTFFont::freeLayouts() const {
+	TTFCacheStats &stats = g_ttf.getCacheStats();
+	for (uint i = 0; i < _layouts.size(); ++i)
+		stats.layoutBytes -= getLayoutBytes(_layouts[i]);
+	stats.layouts -= _layouts.size();
+
+	_layouts.clear();
+	_layoutMap.clear();
+	_u32LayoutMap.clear();
+	_layoutFirst = _layoutLast = -1;
+}
+
+void TTFFont::linkLayout(int index) const {
+	TextLayout &layout = _layouts[index];
+	layout.prev = -1;
+	layout.next = _layoutFirst;
+	if (_layoutFirst >= 0)
+		_layouts[_layoutFirst].prev = index;
+	else
+		_layoutLast = index;
+	_layoutFirst = index;
+}
+
+void TTFFont::unlinkLayout(int index) const {
+	TextLayout &layout = _layouts[index];
+	if (layout.prev >= 0)
+		_layouts[layout.prev].next = layout.next;
+	else
+		_layoutFirst = layout.next;
+	if (layout.next >= 0)
+		_layouts[layout.next].prev = layout.prev;
+	else
+		_layoutLast = layout.prev;
+	layout.prev = layout.next = -1;
+}
+
 namespace {
 
 template<typename ColorType>
@@ -632,14 +852,23 @@ static void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos,
 					dstFormat.colorToARGB(*rDst, dA, dR, dG, dB);
 				}
 
-				double sAn = (double)sA / 255.0;
-				double dAn = (double)dA / 255.0;
-				double oAn = sAn + dAn * (1.0 - sAn);
-
-				dR = static_cast<uint8>(sR * sAn + dR * dAn * (1.0 - sAn) / oAn);
-				dG = static_cast<uint8>(sG * sAn + dG * dAn * (1.0 - sAn) / oAn);
-				dB = static_cast<uint8>(sB * sAn + dB * dAn * (1.0 - sAn) / oAn);
-				dA = static_cast<uint8>(oAn * 255.0);
+				if (dA == 255) {
+					// Blending onto an opaque pixel keeps it opaque, which
+					// works out in integers
+					const uint invA = 255 - sA;
+					dR = (sR * sA + dR * invA) / 255;
+					dG = (sG * sA + dG * invA) / 255;
+					dB = (sB * sA + dB * invA) / 255;
+				} else {
+					double sAn = (double)sA / 255.0;
+					double dAn = (double)dA / 255.0;
+					double oAn = sAn + dAn * (1.0 - sAn);
+
+					dR = static_cast<uint8>(sR * sAn + dR * dAn * (1.0 - sAn) / oAn);
+					dG = static_cast<uint8>(sG * sAn + dG * dAn * (1.0 - sAn) / oAn);
+					dB = static_cast<uint8>(sB * sAn + dB * dAn * (1.0 - sAn) / oAn);
+					dA = static_cast<uint8>(oAn * 255.0);
+				}
 
 				*rDst = dstFormat.ARGBToColor(dA, dR, dG, dB);
 			}
@@ -680,6 +909,8 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	const Glyph &glyph = glyphEntry->_value;
+	if (glyph.page < 0)
+		return;
 
 	x += glyph.xOffset;
 	y += glyph.yOffset;
@@ -689,10 +920,12 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 	if (y > dst->h)
 		return;
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+	int w = glyph.width;
+	int h = glyph.height;
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+	const Surface &atlas = _atlas[glyph.page]->surface;
+	const uint8 *srcPos = (const uint8 *)atlas.getBasePtr(glyph.x, glyph.y);
+	const int srcPitch = atlas.pitch;
 
 	// Make sure we are not drawing outside the screen bounds
 	if (x < 0) {
@@ -708,7 +941,7 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 		return;
 
 	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
+		srcPos -= y * srcPitch;
 		h += y;
 		y = 0;
 	}
@@ -737,14 +970,14 @@ void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
 			}
 
 			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+			srcPos += srcPitch;
 		}
 	} else if (dst->format.bytesPerPixel == 1) {
-		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
+		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, srcPitch, w, h, color, dst->format, transparentColor);
 	}
 }
 
@@ -813,7 +1046,10 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	if (bitmap->pixel_mode != FT_PIXEL_MODE_MONO && bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) {
+		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		return false;
+	}
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -822,41 +1058,33 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	int dstPitch;
+	uint8 *dst = allocateGlyph(glyph, bitmap->width, bitmap->rows, dstPitch);
 
-	switch (bitmap->pixel_mode) {
-	case FT_PIXEL_MODE_MONO:
-		for (int y = 0; y < (int)bitmap->rows; ++y) {
+	if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO) {
+		for (int y = 0; y < glyph.height; ++y) {
 			const uint8 *curSrc = src;
 			uint8 mask = 0;
 
-			for (int x = 0; x < (int)bitmap->width; ++x) {
+			for (int x = 0; x < glyph.width; ++x) {
 				if ((x % 8) == 0)
 					mask = *curSrc++;
 
 				if (mask & 0x80)
-					*dst = 255;
+					dst[x] = 255;
 
 				mask <<= 1;
-				++dst;
 			}
 
+			dst += dstPitch;
 			src += srcPitch;
 		}
-		break;
-
-	case FT_PIXEL_MODE_GRAY:
-		for (int y = 0; y < (int)bitmap->rows; ++y) {
-			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+	} else {
+		for (int y = 0; y < glyph.height; ++y) {
+			memcpy(dst, src, glyph.width);
+			dst += dstPitch;
 			src += srcPitch;
 		}
-		break;
-
-	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
 	}
 
 #if FAKE_BOLD == 1
@@ -868,8 +1096,138 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
+uint8 *TTFFont::allocateGlyph(Glyph &glyph, int width, int height, int &pitch) const {
+	glyph.page = -1;
+	glyph.x = glyph.y = 0;
+	glyph.width = width;
+	glyph.height = height;
+	pitch = 0;
+
+	// Empty glyphs, like spaces, take no room in the atlas
+	if (!width || !height)
+		return nullptr;
+
+	// Only one page is filled at a time, the glyph goes onto its current
+	// shelf or else starts the next one
+	AtlasPage *page = _atlasFillPage < 0 ? nullptr : _atlas[_atlasFillPage];
+	if (page && page->shelfX + width > page->surface.w) {
+		page->shelfX = 0;
+		page->shelfY += page->shelfHeight;
+		page->shelfHeight = 0;
+	}
+
+	if (!page || page->shelfX + width > page->surface.w || page->shelfY + height > page->surface.h) {
+		const int pageWidth = MAX(kAtlasPageSize, width);
+		const int pageHeight = MAX(kAtlasPageSize, height);
+		const uint32 pageBytes = pageWidth * pageHeight;
+
+		// Rather than going over its budget, a font which can cache its
+		// glyphs again on demand makes room by dropping the glyphs of its
+		// least recently used page
+		if (_initialized && _allowLateCaching && !_atlas.empty() && _atlasBytes + pageBytes > kAtlasFontBudget) {
+			_atlasFillPage = evictAtlasPage(width, height);
+			page = _atlas[_atlasFillPage];
+		} else {
+			page = new AtlasPage();
+			page->surface.create(pageWidth, pageHeight, PixelFormat::createFormatCLUT8());
+			_atlas.push_back(page);
+			_atlasFillPage = _atlas.size() - 1;
+
+			TTFCacheStats &stats = g_ttf.getCacheStats();
+			stats.atlasPages++;
+			stats.atlasBytes += pageBytes;
+			stats.atlasPeakBytes = MAX(stats.atlasPeakBytes, stats.atlasBytes);
+			_atlasBytes += pageBytes;
+		}
+
+		page->shelfX = page->shelfY = 0;
+		page->shelfHeight = 0;
+	}
+
+	page->lastUse = ++_atlasUseCounter;
+	glyph.page = _atlasFillPage;
+	glyph.x = page->shelfX;
+	glyph.y = page->shelfY;
+
+	page->shelfX += width;
+	page->shelfHeight = MAX(page->shelfHeight, height);
+
+	pitch = page->surface.pitch;
+	return (uint8 *)page->surface.getBasePtr(glyph.x, glyph.y);
+}
+
+int TTFFont::evictAtlasPage(int width, int height) const {
+	int lru = 0;
+	for (uint i = 1; i < _atlas.size(); ++i) {
+		if (_atlas[i]->lastUse < _atlas[lru]->lastUse)
+			lru = i;
+	}
+
+	Common::Array<uint32> dropped;
+	for (GlyphCache::const_iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i) {
+		if (i->_value.page == lru)
+			dropped.push_back(i->_key);
+	}
+	for (uint i = 0; i < dropped.size(); ++i)
+		_glyphs.erase(dropped[i]);
+
+	debug(3, "TTFFont::evictAtlasPage: Dropping %u glyphs of %s to stay within the atlas budget",
+	      dropped.size(), getFontName().c_str());
+
+	TTFCacheStats &stats = g_ttf.getCacheStats();
+	stats.atlasEvictions++;
+
+	Surface &surface = _atlas[lru]->surface;
+	if (surface.w < width || surface.h < height) {
+		// The page is too small for the glyph, which is larger than a page
+		const uint32 oldBytes = surface.w * surface.h;
+		surface.free();
+		surface.create(MAX<int>(kAtlasPageSize, width), MAX<int>(kAtlasPageSize, height), PixelFormat::createFormatCLUT8());
+
+		const uint32 newBytes = surface.w * surface.h;
+		stats.atlasBytes += newBytes - oldBytes;
+		stats.atlasPeakBytes = MAX(stats.atlasPeakBytes, stats.atlasBytes);
+		_atlasBytes += newBytes - oldBytes;
+	} else {
+		memset(surface.getPixels(), 0, surface.pitch * surface.h);
+	}
+
+	return lru;
+}
+
+void TTFFont::touchAtlasPage(int page) const {
+	if (page >= 0)
+		_atlas[page]->lastUse = ++_atlasUseCounter;
+}
+
+void TTFFont::freeAtlas() const {
+	if (_atlas.empty())
+		return;
+
+	TTFCacheStats &stats = g_ttf.getCacheStats();
+
+	for (Atlas::iterator i = _atlas.begin(), end = _atlas.end(); i != end; ++i) {
+		stats.atlasPages--;
+		stats.atlasBytes -= (*i)->surface.w * (*i)->surface.h;
+
+		(*i)->surface.free();
+		delete *i;
+	}
+
+	_atlas.clear();
+	_atlasFillPage = -1;
+	_atlasBytes = 0;
+}
+
 void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
+	if (!chr || !_allowLateCaching) {
+		return;
+	}
+
+	// Using a glyph keeps its page from being evicted
+	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry != _glyphs.end()) {
+		touchAtlasPage(glyphEntry->_value.page);
 		return;
 	}
 
@@ -142,6 +142,34 @@ Font *loadTTFFontFromArchive(const Common::String &filename, int size, TTFSizeMo
  */
 Font *findTTFace(const Common::Array<Common::Path> &files, const Common::U32String &faceName, bool bold, bool italic, int size, uint xdpi = 0, uint ydpi = 0,TTFRenderMode renderMode = kTTFRenderModeLight, const uint32 *mapping = 0);
 
+/**
+ * Usage of the glyph atlases and string layout caches of all TTF fonts.
+ */
+struct TTFCacheStats {
+	uint32 atlasPages;      ///< Number of allocated atlas pages.
+	uint32 atlasBytes;      ///< Memory used by the atlas pages.
+	uint32 atlasPeakBytes;  ///< Highest memory used by the atlas pages.
+	uint32 atlasBudget;     ///< Memory per font above which it reuses its least recently used page.
+	uint32 atlasEvictions;  ///< Number of pages whose glyphs were dropped to make room.
+	uint32 layouts;         ///< Number of cached string layouts.
+	uint32 layoutBytes;     ///< Approximate memory used by the cached string layouts.
+	uint32 layoutHits;      ///< String layouts found in the caches.
+	uint32 layoutMisses;    ///< String layouts which had to be computed.
+
+	TTFCacheStats() : atlasPages(0), atlasBytes(0), atlasPeakBytes(0), atlasBudget(0),
+		atlasEvictions(0), layouts(0), layoutBytes(0), layoutHits(0), layoutMisses(0) {}
+};
+
+/**
+ * Query the usage of the TTF glyph atlases and string layout caches.
+ */
+TTFCacheStats getTTFCacheStats();
+
+/**
+ * Reset the peak atlas memory and the eviction and layout counters.
+ */
+void resetTTFCacheStats();
+
 void shutdownTTF();
 
 } // End of namespace Graphics
@@ -7,6 +7,7 @@ MODULE_OBJS := \
 	blit/blit-generic.o \
 	blit/blit-scale.o \
 	cursorman.o \
+	dirtytiles.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -92,9 +93,19 @@ MODULE_OBJS += \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
+	tinygl/zspan.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/zspan-avx2.o
+endif
 endif
 
 ifdef USE_ASPECT
@@ -148,7 +159,8 @@ MODULE_OBJS += \
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	dirtytiles-sse2.o
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
@@ -287,6 +287,7 @@ public:
 
 	bool canDrawCursor() const override { return true; }
 	uint extraPixels() const override { return 0; }
+	bool isThreadSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
@@ -166,7 +166,7 @@ static void scale3x(void* void_dst, unsigned dst_slice, const void* void_src, un
  * The destination bitmap must be manually allocated before calling the function,
  * note that the resulting size is exactly 4x4 times the size of the source bitmap.
  * \note This function requires also a small buffer bitmap used internally to store
- * intermediate results. This bitmap must have at least a horizontal size in bytes of 2*width*pixel,
+ * intermediate results. This bitmap must have at least a horizontal size in bytes of 2*width*pixel + 16,
  * and a vertical size of 6 rows. The memory of this buffer must not be allocated
  * in video memory because it's also read and not only written. Generally
  * a heap (malloc) or a stack (alloca) buffer is the best choices.
@@ -184,6 +184,7 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 	unsigned char* dst = (unsigned char*)void_dst;
 	const unsigned char* src = (const unsigned char*)void_src;
 	unsigned count;
+	unsigned border;
 	unsigned char* mid[6];
 
 	assert(height >= 4);
@@ -198,13 +199,23 @@ static void scale4x_buf(void* void_dst, unsigned dst_slice, void* void_mid, unsi
 	mid[4] = mid[3] + mid_slice;
 	mid[5] = mid[4] + mid_slice;
 
-	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width);
-	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width);
+	/*
+	 * The MMX implementation reads the pixels on the left and on the right
+	 * of each row. The buffer rows are computed with a border of 8 bytes on
+	 * both sides, so that these pixels come from the source bitmap instead
+	 * of whatever is stored around the buffer rows. The result of each row
+	 * then only depends on the source pixels around it.
+	 */
+	border = 4 / pixel;
+	src -= border * pixel;
+
+	stage_scale2x(SCMID(0), SCMID(1), SCSRC(0), SCSRC(1), SCSRC(2), pixel, width + 2 * border);
+	stage_scale2x(SCMID(2), SCMID(3), SCSRC(1), SCSRC(2), SCSRC(3), pixel, width + 2 * border);
 	while (count) {
 		unsigned char* tmp;
 
-		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width);
-		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1), SCMID(2), SCMID(3), SCMID(4), pixel, width);
+		stage_scale2x(SCMID(4), SCMID(5), SCSRC(2), SCSRC(3), SCSRC(4), pixel, width + 2 * border);
+		stage_scale4x(SCDST(0), SCDST(1), SCDST(2), SCDST(3), SCMID(1) + 8, SCMID(2) + 8, SCMID(3) + 8, SCMID(4) + 8, pixel, width);
 
 		dst = SCDST(4);
 		src = SCSRC(1);
@@ -246,7 +257,7 @@ static void scale4x(void* void_dst, unsigned dst_slice, const void* void_src, un
 	unsigned mid_slice;
 	void* mid;
 
-	mid_slice = 2 * pixel * width; /* required space for 1 row buffer */
+	mid_slice = 2 * pixel * width + 16; /* required space for 1 row buffer, with its borders */
 
 	mid_slice = (mid_slice + 0x7) & ~0x7; /* align to 8 bytes */
 
@@ -382,6 +393,7 @@ public:
 
 	bool canDrawCursor() const override { return true; }
 	uint extraPixels() const override { return 4; }
+	bool isThreadSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
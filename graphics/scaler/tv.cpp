@@ -89,6 +89,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 0; }
+	bool isThreadSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
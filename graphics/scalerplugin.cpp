@@ -20,6 +20,8 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/thread.h"
+
 namespace {
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
@@ -40,6 +42,23 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 		dstPtr += dstPitch;
 	}
 }
+
+struct ScalerBand {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height;
+	int x, y;
+};
+
+void scaleBand(void *param) {
+	ScalerBand *band = (ScalerBand *)param;
+	band->scaler->scale(band->srcPtr, band->srcPitch, band->dstPtr, band->dstPitch,
+	                    band->width, band->height, band->x, band->y);
+}
+
 } // End of anonymous namespace
 
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
@@ -57,6 +76,39 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	}
 }
 
+void Scaler::scaleInBands(Common::WorkerPool &pool, uint numBands, const uint8 *srcPtr, uint32 srcPitch,
+                          uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y) {
+	// Some scalers process the source rows four by four
+	const int kMinBandHeight = 4;
+	const uint kMaxBands = 32;
+
+	numBands = MIN<uint>(MIN<uint>(numBands, kMaxBands), height / kMinBandHeight);
+	if (numBands <= 1) {
+		scale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		return;
+	}
+
+	ScalerBand bands[kMaxBands];
+	Common::WorkerPool::JobGroup group;
+	for (uint i = 0; i < numBands; i++) {
+		const int top = height * i / numBands;
+		const int bottom = height * (i + 1) / numBands;
+
+		ScalerBand &band = bands[i];
+		band.scaler = this;
+		band.srcPtr = srcPtr + top * srcPitch;
+		band.srcPitch = srcPitch;
+		band.dstPtr = dstPtr + top * _factor * dstPitch;
+		band.dstPitch = dstPitch;
+		band.width = width;
+		band.height = bottom - top;
+		band.x = x;
+		band.y = y + top;
+		pool.submit(group, scaleBand, &band);
+	}
+	pool.wait(group);
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
@@ -25,6 +25,10 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+namespace Common {
+class WorkerPool;
+}
+
 class Scaler {
 public:
 	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
@@ -45,6 +49,24 @@ public:
 	void scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	           uint32 dstPitch, int width, int height, int x, int y);
 
+	/**
+	 * Scale a rect like scale(), split into horizontal bands which are
+	 * scaled at the same time by the threads of a worker pool. This may
+	 * only be used with the scalers of thread safe plugins.
+	 *
+	 * Each band reads up to ScalerPluginObject::extraPixels() rows of the
+	 * source around it, exactly like a single call for the whole rect, so
+	 * the result is identical. The source must not be modified until this
+	 * returns.
+	 *
+	 * @param pool     The worker pool running the bands.
+	 * @param numBands The maximal number of bands to split the rect into.
+	 *
+	 * @see ScalerPluginObject::isThreadSafe
+	 */
+	void scaleInBands(Common::WorkerPool &pool, uint numBands, const uint8 *srcPtr, uint32 srcPitch,
+	                  uint8 *dstPtr, uint32 dstPitch, int width, int height, int x, int y);
+
 	/**
 	 * Increase the factor of scaling.
 	 * @return The new factor
@@ -199,6 +221,15 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether the scalers created by this plugin can scale several rects
+	 * of the same surface at the same time, from different threads. This
+	 * requires the scaler not to modify any state while scaling.
+	 *
+	 * @see Scaler::scaleInBands
+	 */
+	virtual bool isThreadSafe() const { return false; }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -152,6 +152,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_enableDirtyRectangles = dirtyRectsEnable;
 	stencil_buffer_supported = enableStencilBuffer;
 
+	SpanFiller::init();
 	fb = new TinyGL::FrameBuffer(screenW, screenH, pixelFormat, enableStencilBuffer);
 	renderRect = Common::Rect(0, 0, screenW, screenH);
 
@@ -358,12 +359,18 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
+	_tiledRasterizationRequested = false;
+	_tiledRasterizationBands = 0;
+	_isRasterizationBand = false;
+	updateRasterizationBands();
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
 void GLContext::deinit() {
 	disposeDrawCallLists();
 	disposeResources();
+	disposeRasterizationBands();
 
 	specbuf_cleanup();
 	for (int i = 0; i < 3; i++)
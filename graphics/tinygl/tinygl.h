@@ -39,6 +39,15 @@ void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
+/**
+ * Enable or disable splitting the rasterization of the current context in
+ * horizontal bands executed on the worker pool, starting with the next frame.
+ * The output is the same either way. This is disabled by default, and engines
+ * have to request it. It is only effective if the worker pool has more than
+ * one thread, unless numBands asks for a given number of bands instead of
+ * one per thread.
+ */
+void enableTiledRasterization(bool enable, uint numBands = 0);
 void getSurfaceRef(Graphics::Surface &surface);
 Graphics::Surface *copyFromFrameBuffer(const Graphics::PixelFormat &dstFormat);
 
@@ -49,6 +49,7 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
 	else
 		_sbuf = nullptr;
+	_ownsBuffers = true;
 
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
@@ -59,6 +60,8 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
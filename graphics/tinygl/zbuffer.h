@@ -31,6 +31,7 @@
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/zspan.h"
 
 #include "common/rect.h"
 
@@ -106,6 +107,15 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Make this frame buffer render into the buffers of parent, starting with
+	 * a copy of its state. The buffers stay owned by parent.
+	 */
+	void shareBuffers(const FrameBuffer &parent) {
+		*this = parent;
+		_ownsBuffers = false;
+	}
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -681,6 +691,16 @@ private:
 	void selectOffscreenBuffer(Buffer *buffer);
 	void clearOffscreenBuffer(Buffer *buffer);
 
+	/**
+	 * Return the span kernel able to draw untextured triangles with the current
+	 * state, or nullptr if they have to be drawn by the scalar code.
+	 */
+	ShadedSpanFunc selectShadedSpanFunc(ShadedSpanMode &mode, bool blending, bool depthTest, bool depthWrite) const;
+
+	template <bool kSmoothMode, bool kDepthWrite, bool kEnableScissor>
+	FORCEINLINE bool fillShadedSpan(ShadedSpanFunc func, const ShadedSpanMode &mode, int pixelOffset, uint *pz, int x, int count,
+	                                uint z, uint r, uint g, uint b, uint a, int dzdx, int drdx, int dgdx, int dbdx, int dadx);
+
 	template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
 	          bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
 	          bool kBlendingEnabled, bool kStencilEnabled, bool kStippleEnabled, bool kDepthTestEnabled>
@@ -763,6 +783,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/thread.h"
 
 namespace TinyGL {
 
@@ -188,20 +189,14 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 	}
 
 	if (!rectangles.empty()) {
+		Common::List<Common::Rect> clippingRectangles;
 		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+			clippingRectangles.push_back((*itRect).rectangle);
 			dirtyAreas.push_back((*itRect).rectangle);
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
-				}
-			}
-		}
+		executeDrawCalls(&clippingRectangles);
 
 		if (_debugRectsEnabled) {
 			// Draw debug rectangles.
@@ -240,8 +235,9 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 
 	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
 
+	executeDrawCalls(nullptr);
+
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
 		delete *it;
 	}
 
@@ -259,6 +255,7 @@ void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	} else {
 		c->presentBufferSimple(dirtyAreas);
 	}
+	c->updateRasterizationBands();
 }
 
 void presentBuffer() {
@@ -266,6 +263,173 @@ void presentBuffer() {
 	presentBuffer(dirtyAreas);
 }
 
+void enableTiledRasterization(bool enable, uint numBands) {
+	GLContext *c = gl_get_context();
+	c->_tiledRasterizationRequested = enable;
+	c->_tiledRasterizationBands = numBands;
+}
+
+// A horizontal slice of the frame buffer, rasterized by its own context
+// sharing the buffers of the main one.
+struct RasterizationBand {
+	GLContext *context;
+	Common::Rect rectangle;
+	Common::List<DrawCall *>::const_iterator begin, end;
+	const Common::List<Common::Rect> *clippingRectangles;
+};
+
+static void executeDrawCall(const DrawCall &drawCall, const Common::List<Common::Rect> *clippingRectangles) {
+	if (!clippingRectangles) {
+		drawCall.execute(true);
+		return;
+	}
+
+	Common::Rect drawCallRegion = drawCall.getDirtyRegion();
+	for (Common::List<Common::Rect>::const_iterator it = clippingRectangles->begin(); it != clippingRectangles->end(); ++it) {
+		if ((*it).intersects(drawCallRegion)) {
+			drawCall.execute(*it, true);
+		}
+	}
+}
+
+static void rasterizeBand(void *param) {
+	RasterizationBand *band = (RasterizationBand *)param;
+
+	for (Common::List<DrawCall *>::const_iterator it = band->begin; it != band->end; ++it) {
+		Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		if (!band->clippingRectangles) {
+			if (band->rectangle.intersects(drawCallRegion)) {
+				(*it)->executeInBand(band->context, band->rectangle);
+			}
+			continue;
+		}
+		// Dirty rectangles never overlap, so the order in which they are processed does not matter.
+		for (Common::List<Common::Rect>::const_iterator itRect = band->clippingRectangles->begin(); itRect != band->clippingRectangles->end(); ++itRect) {
+			Common::Rect clippingRectangle = (*itRect).findIntersectingRect(band->rectangle);
+			if (clippingRectangle.intersects(drawCallRegion)) {
+				(*it)->executeInBand(band->context, clippingRectangle);
+			}
+		}
+	}
+}
+
+void GLContext::updateRasterizationBands() {
+	const int kMinBandHeight = 16;
+
+	uint numBands = 1;
+	if (_tiledRasterizationRequested) {
+		numBands = _tiledRasterizationBands ? _tiledRasterizationBands : Common::WorkerPool::instance().getNumThreads();
+		numBands = MIN<uint>(numBands, fb->getPixelBufferHeight() / kMinBandHeight);
+	}
+	_tiledRasterization = numBands > 1;
+
+	if (!_tiledRasterization) {
+		disposeRasterizationBands();
+		return;
+	}
+	if (numBands == _rasterizationBands.size())
+		return;
+
+	disposeRasterizationBands();
+
+	int width = fb->getPixelBufferWidth();
+	int height = fb->getPixelBufferHeight();
+	for (uint i = 0; i < numBands; i++) {
+		RasterizationBand *band = new RasterizationBand();
+		band->context = new GLContext();
+		band->context->_isRasterizationBand = true;
+		band->context->_tiledRasterization = false;
+		band->context->_tiledRasterizationRequested = false;
+		band->context->_tiledRasterizationBands = 0;
+		band->context->fb = new FrameBuffer(*fb);
+		band->context->fb->shareBuffers(*fb);
+		band->context->vertex_max = POLYGON_MAX_VERTEX;
+		band->context->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+		band->rectangle = Common::Rect(0, height * i / numBands, width, height * (i + 1) / numBands);
+		_rasterizationBands.push_back(band);
+	}
+}
+
+void GLContext::disposeRasterizationBands() {
+	for (uint i = 0; i < _rasterizationBands.size(); i++) {
+		GLContext *c = _rasterizationBands[i]->context;
+		gl_free(c->vertex);
+		delete c->fb;
+		delete c;
+		delete _rasterizationBands[i];
+	}
+	_rasterizationBands.clear();
+}
+
+void GLContext::rasterizeInBands(Common::List<DrawCall *>::const_iterator begin, Common::List<DrawCall *>::const_iterator end,
+                                 const Common::List<Common::Rect> *clippingRectangles) {
+	if (begin == end)
+		return;
+
+	Common::WorkerPool &pool = Common::WorkerPool::instance();
+	Common::WorkerPool::JobGroup group;
+	for (uint i = 0; i < _rasterizationBands.size(); i++) {
+		RasterizationBand *band = _rasterizationBands[i];
+		band->begin = begin;
+		band->end = end;
+		band->clippingRectangles = clippingRectangles;
+		pool.submit(group, rasterizeBand, band);
+	}
+	pool.wait(group);
+}
+
+// Give a band the state of the main context c.
+static void shareBandState(GLContext *band, const GLContext *c, const RasterizationDrawCall::RasterizationState &state) {
+	band->fb->shareBuffers(*c->fb);
+
+	// The state draw calls capture, in case one relies on the state left by
+	// the calls before it...
+	RasterizationDrawCall::applyState(band, state);
+
+	// ...and the state they take from the context as it is.
+	band->renderRect = c->renderRect;
+	band->_scissorRect = c->renderRect;
+	band->_enableDirtyRectangles = c->_enableDirtyRectangles;
+	band->_profilingEnabled = c->_profilingEnabled;
+	band->render_mode = c->render_mode;
+	band->current_cull_face = c->current_cull_face;
+	band->vertex_n = c->vertex_n;
+	band->draw_triangle_front = c->draw_triangle_front;
+	band->draw_triangle_back = c->draw_triangle_back;
+	band->fog_color = c->fog_color;
+	band->viewport = c->viewport;
+}
+
+void GLContext::executeDrawCalls(const Common::List<Common::Rect> *clippingRectangles) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	if (!_tiledRasterization || render_mode == TGL_SELECT) {
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			executeDrawCall(**it, clippingRectangles);
+		}
+		return;
+	}
+
+	const RasterizationDrawCall::RasterizationState state = RasterizationDrawCall::captureState(this);
+	for (uint i = 0; i < _rasterizationBands.size(); i++) {
+		shareBandState(_rasterizationBands[i]->context, this, state);
+	}
+
+	// Bands can only be rasterized in parallel up to a call which has to
+	// run on the main context, such as a blit, which is then executed on
+	// its own.
+	DrawCallIterator segmentBegin = _drawCallsQueue.begin();
+	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+		if (!(*it)->canBeTiled()) {
+			rasterizeInBands(segmentBegin, it, clippingRectangles);
+			executeDrawCall(**it, clippingRectangles);
+			segmentBegin = it;
+			++segmentBegin;
+		}
+	}
+	rasterizeInBands(segmentBegin, _drawCallsQueue.end(), clippingRectangles);
+}
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -294,8 +458,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleFront = c->draw_triangle_front;
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
-	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	_state = captureState(c);
+	if (c->_enableDirtyRectangles || c->_tiledRasterization) {
 		computeDirtyRegion();
 	}
 }
@@ -334,18 +498,32 @@ void RasterizationDrawCall::computeDirtyRegion() {
 }
 
 void RasterizationDrawCall::execute(bool restoreState) const {
-	GLContext *c = gl_get_context();
+	rasterize(gl_get_context(), restoreState);
+}
 
+void RasterizationDrawCall::rasterize(GLContext *c, bool restoreState) const {
 	RasterizationDrawCall::RasterizationState backupState;
 	if (restoreState) {
-		backupState = captureState();
+		backupState = captureState(c);
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
-	c->vertex = _vertex;
+	if (c->_isRasterizationBand) {
+		// Some primitives modify their vertices while being drawn, so every
+		// band works on its own copy of them.
+		if (c->vertex_max < _vertexCount) {
+			gl_free(c->vertex);
+			c->vertex_max = _vertexCount;
+			c->vertex = (GLVertex *)gl_malloc(_vertexCount * sizeof(GLVertex));
+			prevVertex = c->vertex;
+		}
+		memcpy(c->vertex, _vertex, _vertexCount * sizeof(GLVertex));
+	} else {
+		c->vertex = _vertex;
+	}
 	c->vertex_cnt = _vertexCount;
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
@@ -429,13 +607,12 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	c->vertex_cnt = prevVertexCount;
 
 	if (restoreState) {
-		applyState(backupState);
+		applyState(c, backupState);
 	}
 }
 
-RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
+RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState(const GLContext *c) {
 	RasterizationState state;
-	GLContext *c = gl_get_context();
 	state.enableBlending = c->blending_enabled;
 	state.sfactor = c->source_blending_factor;
 	state.dfactor = c->destination_blending_factor;
@@ -486,8 +663,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -553,10 +729,16 @@ void RasterizationDrawCall::applyState(const RasterizationDrawCall::Rasterizatio
 void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
 	TinyGL::GLContext *c = gl_get_context();
 	c->fb->setScissorRectangle(clippingRectangle);
-	execute(restoreState);
+	rasterize(c, restoreState);
 	c->fb->resetScissorRectangle();
 }
 
+void RasterizationDrawCall::executeInBand(GLContext *band, const Common::Rect &clippingRectangle) const {
+	band->fb->setScissorRectangle(clippingRectangle);
+	rasterize(band, true);
+	band->fb->resetScissorRectangle();
+}
+
 bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const {
 	if (_vertexCount == other._vertexCount &&
 		_drawTriangleFront == other._drawTriangleFront &&
@@ -577,7 +759,8 @@ BlittingDrawCall::BlittingDrawCall(BlitImage *image, const BlitTransform &transf
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
 	_imageVersion = tglGetBlitImageVersion(image);
-	if (gl_get_context()->_enableDirtyRectangles) {
+	GLContext *c = gl_get_context();
+	if (c->_enableDirtyRectangles || c->_tiledRasterization) {
 		computeDirtyRegion();
 	}
 }
@@ -694,7 +877,7 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_tiledRasterization) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -705,7 +888,14 @@ void ClearBufferDrawCall::execute(bool restoreState) const {
 }
 
 void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+	clearRegion(gl_get_context(), clippingRectangle);
+}
+
+void ClearBufferDrawCall::executeInBand(GLContext *band, const Common::Rect &clippingRectangle) const {
+	clearRegion(band, clippingRectangle);
+}
+
+void ClearBufferDrawCall::clearRegion(GLContext *c, const Common::Rect &clippingRectangle) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(),
 	                   _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
@@ -57,6 +57,10 @@ public:
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
+	// Whether the call can be executed clipped to a rasterization band, giving the same pixels as executing it at once.
+	virtual bool canBeTiled() const { return false; }
+	// Execute the call clipped to a band, on the context of the band rather than the current one.
+	virtual void executeInBand(GLContext *band, const Common::Rect &clippingRectangle) const { assert(false); }
 protected:
 	Common::Rect _dirtyRegion;
 private:
@@ -70,6 +74,8 @@ public:
 	bool operator==(const ClearBufferDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool canBeTiled() const { return true; }
+	virtual void executeInBand(GLContext *band, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -77,6 +83,8 @@ public:
 
 	void operator delete(void *p) { }
 private:
+	void clearRegion(GLContext *c, const Common::Rect &clippingRectangle) const;
+
 	bool _clearZBuffer, _clearColorBuffer, _clearStencilBuffer;
 	int _rValue, _gValue, _bValue, _zValue, _stencilValue;
 };
@@ -89,18 +97,8 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
-
-	void *operator new(size_t size) {
-		return Internal::allocateFrame(size);
-	}
-
-	void operator delete(void *p) { }
-private:
-	void computeDirtyRegion();
-	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
-	int _vertexCount;
-	GLVertex *_vertex;
-	gl_draw_triangle_func_ptr _drawTriangleFront, _drawTriangleBack;
+	virtual bool canBeTiled() const { return true; }
+	virtual void executeInBand(GLContext *band, const Common::Rect &clippingRectangle) const;
 
 	struct RasterizationState {
 		int beginType;
@@ -150,10 +148,24 @@ private:
 		bool operator==(const RasterizationState &other) const;
 	};
 
-	RasterizationState _state;
+	// Capture the state of a context, or apply it to a context.
+	static RasterizationState captureState(const GLContext *c);
+	static void applyState(GLContext *c, const RasterizationState &state);
 
-	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	void *operator new(size_t size) {
+		return Internal::allocateFrame(size);
+	}
+
+	void operator delete(void *p) { }
+private:
+	void computeDirtyRegion();
+	void rasterize(GLContext *c, bool restoreState) const;
+	typedef void (*gl_draw_triangle_func_ptr)(GLContext *c, TinyGL::GLVertex *p0, TinyGL::GLVertex *p1, TinyGL::GLVertex *p2);
+	int _vertexCount;
+	GLVertex *_vertex;
+	gl_draw_triangle_func_ptr _drawTriangleFront, _drawTriangleBack;
+
+	RasterizationState _state;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -278,6 +278,8 @@ struct GLContext;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
 
+struct RasterizationBand;
+
 // display context
 
 struct GLContext {
@@ -467,6 +469,13 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Tiled rasterization
+	bool _tiledRasterization;
+	bool _tiledRasterizationRequested;
+	uint _tiledRasterizationBands;
+	bool _isRasterizationBand;
+	Common::Array<RasterizationBand *> _rasterizationBands;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -524,6 +533,12 @@ public:
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
 
+	void executeDrawCalls(const Common::List<Common::Rect> *clippingRectangles);
+	void updateRasterizationBands();
+	void rasterizeInBands(Common::List<DrawCall *>::const_iterator begin, Common::List<DrawCall *>::const_iterator end,
+	                      const Common::List<Common::Rect> *clippingRectangles);
+	void disposeRasterizationBands();
+
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
 	GLSpecBuf *specbuf_get_buffer(const int shininess_i, const float shininess);
@@ -0,0 +1,234 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace TinyGL {
+
+struct SpanRegistersAVX2 {
+	__m256i z, r, g, b, a;
+	__m256i dz, dr, dg, db, da;
+	__m256i depthLess, depthEqual, depthGreater;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+	__m256i alphaBits;
+};
+
+static FORCEINLINE __m256i interpolateAVX2(uint value, int delta) {
+	const uint step = delta;
+	return _mm256_set_epi32(value + 7 * step, value + 6 * step, value + 5 * step, value + 4 * step,
+	                        value + 3 * step, value + 2 * step, value + step, value);
+}
+
+static FORCEINLINE __m256i depthSelectAVX2(bool enabled) {
+	return enabled ? _mm256_set1_epi32(-1) : _mm256_setzero_si256();
+}
+
+// Same as the TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA case of FrameBuffer::writePixel()
+static FORCEINLINE __m256i blendChannelAVX2(__m256i src, __m256i dst, __m128i shift, __m256i alpha, __m256i invAlpha) {
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	// All the values are below 256, so 16 bit multiplications can not overflow
+	dst = _mm256_and_si256(_mm256_srl_epi32(dst, shift), byteMask);
+	src = _mm256_srli_epi32(_mm256_mullo_epi16(src, alpha), 8);
+	dst = _mm256_srli_epi32(_mm256_mullo_epi16(dst, invAlpha), 8);
+	return _mm256_min_epi16(_mm256_add_epi32(src, dst), byteMask);
+}
+
+static FORCEINLINE __m256i packColorAVX2(__m256i a, __m256i r, __m256i g, __m256i b, const SpanRegistersAVX2 &s) {
+	return _mm256_or_si256(_mm256_or_si256(
+		_mm256_sll_epi32(_mm256_srl_epi32(a, s.aLoss), s.aShift),
+		_mm256_sll_epi32(_mm256_srl_epi32(r, s.rLoss), s.rShift)), _mm256_or_si256(
+		_mm256_sll_epi32(_mm256_srl_epi32(g, s.gLoss), s.gShift),
+		_mm256_sll_epi32(_mm256_srl_epi32(b, s.bLoss), s.bShift)));
+}
+
+// Pack the low halves of eight 32 bit lanes into 16 bit values
+static FORCEINLINE __m128i packTo16AVX2(__m256i value) {
+	// Sign extend the values so that packing them does not saturate them
+	value = _mm256_srai_epi32(_mm256_slli_epi32(value, 16), 16);
+	value = _mm256_permute4x64_epi64(_mm256_packs_epi32(value, value), 0x08);
+	return _mm256_castsi256_si128(value);
+}
+
+template<int kBpp, bool kBlending, bool kDepthWrite>
+static FORCEINLINE void fillBlockAVX2(byte *pbuf, uint *zbuf, const SpanRegistersAVX2 &s) {
+	const __m256i signBit = _mm256_set1_epi32((int)0x80000000);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+
+	// The depth values are compared unsigned, see FrameBuffer::compareDepth()
+	__m256i zDst = _mm256_loadu_si256((const __m256i *)zbuf);
+	__m256i zSrcSigned = _mm256_xor_si256(s.z, signBit);
+	__m256i zDstSigned = _mm256_xor_si256(zDst, signBit);
+	__m256i pass = _mm256_or_si256(_mm256_or_si256(
+		_mm256_and_si256(_mm256_cmpgt_epi32(zSrcSigned, zDstSigned), s.depthLess),
+		_mm256_and_si256(_mm256_cmpeq_epi32(s.z, zDst), s.depthEqual)),
+		_mm256_and_si256(_mm256_cmpgt_epi32(zDstSigned, zSrcSigned), s.depthGreater));
+	if (_mm256_movemask_epi8(pass) == 0)
+		return;
+
+	if (kDepthWrite) {
+		// The scalar code stores the depth through a float, which rounds it
+		__m256i zRounded = _mm256_cvttps_epi32(_mm256_cvtepi32_ps(s.z));
+		_mm256_storeu_si256((__m256i *)zbuf, _mm256_blendv_epi8(zDst, zRounded, pass));
+	}
+
+	__m256i r = _mm256_and_si256(_mm256_srli_epi32(s.r, ZB_POINT_RED_BITS - 8), byteMask);
+	__m256i g = _mm256_and_si256(_mm256_srli_epi32(s.g, ZB_POINT_GREEN_BITS - 8), byteMask);
+	__m256i b = _mm256_and_si256(_mm256_srli_epi32(s.b, ZB_POINT_BLUE_BITS - 8), byteMask);
+	__m256i a = _mm256_and_si256(_mm256_srli_epi32(s.a, ZB_POINT_ALPHA_BITS - 8), byteMask);
+
+	if (kBpp == 2) {
+		__m128i color = packTo16AVX2(packColorAVX2(a, r, g, b, s));
+		__m128i dst = _mm_loadu_si128((const __m128i *)pbuf);
+		_mm_storeu_si128((__m128i *)pbuf, _mm_blendv_epi8(dst, color, packTo16AVX2(pass)));
+	} else {
+		__m256i dst = _mm256_loadu_si256((const __m256i *)pbuf);
+		__m256i color;
+		if (kBlending) {
+			__m256i invA = _mm256_sub_epi32(byteMask, a);
+			color = _mm256_or_si256(_mm256_or_si256(s.alphaBits,
+				_mm256_sll_epi32(blendChannelAVX2(r, dst, s.rShift, a, invA), s.rShift)), _mm256_or_si256(
+				_mm256_sll_epi32(blendChannelAVX2(g, dst, s.gShift, a, invA), s.gShift),
+				_mm256_sll_epi32(blendChannelAVX2(b, dst, s.bShift, a, invA), s.bShift)));
+		} else {
+			color = packColorAVX2(a, r, g, b, s);
+		}
+		_mm256_storeu_si256((__m256i *)pbuf, _mm256_blendv_epi8(dst, color, pass));
+	}
+}
+
+template<int kBpp, bool kBlending, bool kDepthWrite>
+static void fillSpanAVX2(const ShadedSpan &span, SpanRegistersAVX2 &s) {
+	byte *pbuf = span.pbuf;
+	uint *zbuf = span.zbuf;
+	int count = span.count;
+
+	while (count >= 8) {
+		fillBlockAVX2<kBpp, kBlending, kDepthWrite>(pbuf, zbuf, s);
+		s.z = _mm256_add_epi32(s.z, s.dz);
+		s.r = _mm256_add_epi32(s.r, s.dr);
+		s.g = _mm256_add_epi32(s.g, s.dg);
+		s.b = _mm256_add_epi32(s.b, s.db);
+		s.a = _mm256_add_epi32(s.a, s.da);
+		pbuf += 8 * kBpp;
+		zbuf += 8;
+		count -= 8;
+	}
+
+	if (count > 0) {
+		// Draw the last pixels through a copy, so that nothing past the end of the
+		// span is accessed
+		uint32 pixels[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		uint depths[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		memcpy(pixels, pbuf, count * kBpp);
+		memcpy(depths, zbuf, count * sizeof(uint));
+		fillBlockAVX2<kBpp, kBlending, kDepthWrite>((byte *)pixels, depths, s);
+		memcpy(pbuf, pixels, count * kBpp);
+		memcpy(zbuf, depths, count * sizeof(uint));
+	}
+}
+
+void SpanFiller::fillShadedSpanAVX2(const ShadedSpan &span, const ShadedSpanMode &mode) {
+	bool depthLess = false, depthEqual = false, depthGreater = false;
+	switch (mode.depthFunc) {
+	case TGL_NEVER:
+		return;
+	case TGL_LESS:
+		depthLess = true;
+		break;
+	case TGL_EQUAL:
+		depthEqual = true;
+		break;
+	case TGL_LEQUAL:
+		depthLess = depthEqual = true;
+		break;
+	case TGL_GREATER:
+		depthGreater = true;
+		break;
+	case TGL_NOTEQUAL:
+		depthLess = depthGreater = true;
+		break;
+	case TGL_GEQUAL:
+		depthGreater = depthEqual = true;
+		break;
+	default:
+		depthLess = depthEqual = depthGreater = true;
+		break;
+	}
+
+	SpanRegistersAVX2 s;
+	s.z = interpolateAVX2(span.z, span.dzdx);
+	s.r = interpolateAVX2(span.r, span.drdx);
+	s.g = interpolateAVX2(span.g, span.dgdx);
+	s.b = interpolateAVX2(span.b, span.dbdx);
+	s.a = interpolateAVX2(span.a, span.dadx);
+	s.dz = _mm256_set1_epi32(8 * (uint)span.dzdx);
+	s.dr = _mm256_set1_epi32(8 * (uint)span.drdx);
+	s.dg = _mm256_set1_epi32(8 * (uint)span.dgdx);
+	s.db = _mm256_set1_epi32(8 * (uint)span.dbdx);
+	s.da = _mm256_set1_epi32(8 * (uint)span.dadx);
+	s.depthLess = depthSelectAVX2(depthLess);
+	s.depthEqual = depthSelectAVX2(depthEqual);
+	s.depthGreater = depthSelectAVX2(depthGreater);
+	s.rLoss = _mm_cvtsi32_si128(mode.rLoss);
+	s.gLoss = _mm_cvtsi32_si128(mode.gLoss);
+	s.bLoss = _mm_cvtsi32_si128(mode.bLoss);
+	s.aLoss = _mm_cvtsi32_si128(mode.aLoss);
+	s.rShift = _mm_cvtsi32_si128(mode.rShift);
+	s.gShift = _mm_cvtsi32_si128(mode.gShift);
+	s.bShift = _mm_cvtsi32_si128(mode.bShift);
+	s.aShift = _mm_cvtsi32_si128(mode.aShift);
+	s.alphaBits = _mm256_set1_epi32((0xFF >> mode.aLoss) << mode.aShift);
+
+	if (mode.bpp == 2) {
+		if (mode.depthWrite)
+			fillSpanAVX2<2, false, true>(span, s);
+		else
+			fillSpanAVX2<2, false, false>(span, s);
+	} else if (mode.blending) {
+		if (mode.depthWrite)
+			fillSpanAVX2<4, true, true>(span, s);
+		else
+			fillSpanAVX2<4, true, false>(span, s);
+	} else {
+		if (mode.depthWrite)
+			fillSpanAVX2<4, false, true>(span, s);
+		else
+			fillSpanAVX2<4, false, false>(span, s);
+	}
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
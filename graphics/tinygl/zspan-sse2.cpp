@@ -0,0 +1,233 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zbuffer.h"
+#include "graphics/tinygl/zspan.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace TinyGL {
+
+struct SpanRegistersSSE2 {
+	__m128i z, r, g, b, a;
+	__m128i dz, dr, dg, db, da;
+	__m128i depthLess, depthEqual, depthGreater;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+	__m128i alphaBits;
+};
+
+static FORCEINLINE __m128i interpolateSSE2(uint value, int delta) {
+	const uint step = delta;
+	return _mm_set_epi32(value + 3 * step, value + 2 * step, value + step, value);
+}
+
+static FORCEINLINE __m128i depthSelectSSE2(bool enabled) {
+	return enabled ? _mm_set1_epi32(-1) : _mm_setzero_si128();
+}
+
+// Same as the TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA case of FrameBuffer::writePixel()
+static FORCEINLINE __m128i blendChannelSSE2(__m128i src, __m128i dst, __m128i shift, __m128i alpha, __m128i invAlpha) {
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	// All the values are below 256, so 16 bit multiplications can not overflow
+	dst = _mm_and_si128(_mm_srl_epi32(dst, shift), byteMask);
+	src = _mm_srli_epi32(_mm_mullo_epi16(src, alpha), 8);
+	dst = _mm_srli_epi32(_mm_mullo_epi16(dst, invAlpha), 8);
+	return _mm_min_epi16(_mm_add_epi32(src, dst), byteMask);
+}
+
+template<int kBpp, bool kBlending, bool kDepthWrite>
+static FORCEINLINE void fillBlockSSE2(byte *pbuf, uint *zbuf, const SpanRegistersSSE2 &s) {
+	const __m128i signBit = _mm_set1_epi32((int)0x80000000);
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+	// The depth values are compared unsigned, see FrameBuffer::compareDepth()
+	__m128i zDst = _mm_loadu_si128((const __m128i *)zbuf);
+	__m128i zSrcSigned = _mm_xor_si128(s.z, signBit);
+	__m128i zDstSigned = _mm_xor_si128(zDst, signBit);
+	__m128i pass = _mm_or_si128(_mm_or_si128(
+		_mm_and_si128(_mm_cmpgt_epi32(zSrcSigned, zDstSigned), s.depthLess),
+		_mm_and_si128(_mm_cmpeq_epi32(s.z, zDst), s.depthEqual)),
+		_mm_and_si128(_mm_cmpgt_epi32(zDstSigned, zSrcSigned), s.depthGreater));
+	if (_mm_movemask_epi8(pass) == 0)
+		return;
+
+	if (kDepthWrite) {
+		// The scalar code stores the depth through a float, which rounds it
+		__m128i zRounded = _mm_cvttps_epi32(_mm_cvtepi32_ps(s.z));
+		_mm_storeu_si128((__m128i *)zbuf, _mm_or_si128(_mm_and_si128(pass, zRounded), _mm_andnot_si128(pass, zDst)));
+	}
+
+	__m128i r = _mm_and_si128(_mm_srli_epi32(s.r, ZB_POINT_RED_BITS - 8), byteMask);
+	__m128i g = _mm_and_si128(_mm_srli_epi32(s.g, ZB_POINT_GREEN_BITS - 8), byteMask);
+	__m128i b = _mm_and_si128(_mm_srli_epi32(s.b, ZB_POINT_BLUE_BITS - 8), byteMask);
+	__m128i a = _mm_and_si128(_mm_srli_epi32(s.a, ZB_POINT_ALPHA_BITS - 8), byteMask);
+
+	if (kBpp == 2) {
+		__m128i color = _mm_or_si128(_mm_or_si128(
+			_mm_sll_epi32(_mm_srl_epi32(a, s.aLoss), s.aShift),
+			_mm_sll_epi32(_mm_srl_epi32(r, s.rLoss), s.rShift)), _mm_or_si128(
+			_mm_sll_epi32(_mm_srl_epi32(g, s.gLoss), s.gShift),
+			_mm_sll_epi32(_mm_srl_epi32(b, s.bLoss), s.bShift)));
+		// Sign extend the colors so that packing them does not saturate them
+		color = _mm_srai_epi32(_mm_slli_epi32(color, 16), 16);
+		color = _mm_packs_epi32(color, color);
+		pass = _mm_packs_epi32(pass, pass);
+		__m128i dst = _mm_loadl_epi64((const __m128i *)pbuf);
+		_mm_storel_epi64((__m128i *)pbuf, _mm_or_si128(_mm_and_si128(pass, color), _mm_andnot_si128(pass, dst)));
+	} else {
+		__m128i dst = _mm_loadu_si128((const __m128i *)pbuf);
+		__m128i color;
+		if (kBlending) {
+			__m128i invA = _mm_sub_epi32(byteMask, a);
+			color = _mm_or_si128(_mm_or_si128(s.alphaBits,
+				_mm_sll_epi32(blendChannelSSE2(r, dst, s.rShift, a, invA), s.rShift)), _mm_or_si128(
+				_mm_sll_epi32(blendChannelSSE2(g, dst, s.gShift, a, invA), s.gShift),
+				_mm_sll_epi32(blendChannelSSE2(b, dst, s.bShift, a, invA), s.bShift)));
+		} else {
+			color = _mm_or_si128(_mm_or_si128(
+				_mm_sll_epi32(_mm_srl_epi32(a, s.aLoss), s.aShift),
+				_mm_sll_epi32(_mm_srl_epi32(r, s.rLoss), s.rShift)), _mm_or_si128(
+				_mm_sll_epi32(_mm_srl_epi32(g, s.gLoss), s.gShift),
+				_mm_sll_epi32(_mm_srl_epi32(b, s.bLoss), s.bShift)));
+		}
+		_mm_storeu_si128((__m128i *)pbuf, _mm_or_si128(_mm_and_si128(pass, color), _mm_andnot_si128(pass, dst)));
+	}
+}
+
+template<int kBpp, bool kBlending, bool kDepthWrite>
+static void fillSpanSSE2(const ShadedSpan &span, SpanRegistersSSE2 &s) {
+	byte *pbuf = span.pbuf;
+	uint *zbuf = span.zbuf;
+	int count = span.count;
+
+	while (count >= 4) {
+		fillBlockSSE2<kBpp, kBlending, kDepthWrite>(pbuf, zbuf, s);
+		s.z = _mm_add_epi32(s.z, s.dz);
+		s.r = _mm_add_epi32(s.r, s.dr);
+		s.g = _mm_add_epi32(s.g, s.dg);
+		s.b = _mm_add_epi32(s.b, s.db);
+		s.a = _mm_add_epi32(s.a, s.da);
+		pbuf += 4 * kBpp;
+		zbuf += 4;
+		count -= 4;
+	}
+
+	if (count > 0) {
+		// Draw the last pixels through a copy, so that nothing past the end of the
+		// span is accessed
+		uint32 pixels[4] = { 0, 0, 0, 0 };
+		uint depths[4] = { 0, 0, 0, 0 };
+		memcpy(pixels, pbuf, count * kBpp);
+		memcpy(depths, zbuf, count * sizeof(uint));
+		fillBlockSSE2<kBpp, kBlending, kDepthWrite>((byte *)pixels, depths, s);
+		memcpy(pbuf, pixels, count * kBpp);
+		memcpy(zbuf, depths, count * sizeof(uint));
+	}
+}
+
+void SpanFiller::fillShadedSpanSSE2(const ShadedSpan &span, const ShadedSpanMode &mode) {
+	bool depthLess = false, depthEqual = false, depthGreater = false;
+	switch (mode.depthFunc) {
+	case TGL_NEVER:
+		return;
+	case TGL_LESS:
+		depthLess = true;
+		break;
+	case TGL_EQUAL:
+		depthEqual = true;
+		break;
+	case TGL_LEQUAL:
+		depthLess = depthEqual = true;
+		break;
+	case TGL_GREATER:
+		depthGreater = true;
+		break;
+	case TGL_NOTEQUAL:
+		depthLess = depthGreater = true;
+		break;
+	case TGL_GEQUAL:
+		depthGreater = depthEqual = true;
+		break;
+	default:
+		depthLess = depthEqual = depthGreater = true;
+		break;
+	}
+
+	SpanRegistersSSE2 s;
+	s.z = interpolateSSE2(span.z, span.dzdx);
+	s.r = interpolateSSE2(span.r, span.drdx);
+	s.g = interpolateSSE2(span.g, span.dgdx);
+	s.b = interpolateSSE2(span.b, span.dbdx);
+	s.a = interpolateSSE2(span.a, span.dadx);
+	s.dz = _mm_set1_epi32(4 * (uint)span.dzdx);
+	s.dr = _mm_set1_epi32(4 * (uint)span.drdx);
+	s.dg = _mm_set1_epi32(4 * (uint)span.dgdx);
+	s.db = _mm_set1_epi32(4 * (uint)span.dbdx);
+	s.da = _mm_set1_epi32(4 * (uint)span.dadx);
+	s.depthLess = depthSelectSSE2(depthLess);
+	s.depthEqual = depthSelectSSE2(depthEqual);
+	s.depthGreater = depthSelectSSE2(depthGreater);
+	s.rLoss = _mm_cvtsi32_si128(mode.rLoss);
+	s.gLoss = _mm_cvtsi32_si128(mode.gLoss);
+	s.bLoss = _mm_cvtsi32_si128(mode.bLoss);
+	s.aLoss = _mm_cvtsi32_si128(mode.aLoss);
+	s.rShift = _mm_cvtsi32_si128(mode.rShift);
+	s.gShift = _mm_cvtsi32_si128(mode.gShift);
+	s.bShift = _mm_cvtsi32_si128(mode.bShift);
+	s.aShift = _mm_cvtsi32_si128(mode.aShift);
+	s.alphaBits = _mm_set1_epi32((0xFF >> mode.aLoss) << mode.aShift);
+
+	if (mode.bpp == 2) {
+		if (mode.depthWrite)
+			fillSpanSSE2<2, false, true>(span, s);
+		else
+			fillSpanSSE2<2, false, false>(span, s);
+	} else if (mode.blending) {
+		if (mode.depthWrite)
+			fillSpanSSE2<4, true, true>(span, s);
+		else
+			fillSpanSSE2<4, true, false>(span, s);
+	} else {
+		if (mode.depthWrite)
+			fillSpanSSE2<4, false, true>(span, s);
+		else
+			fillSpanSSE2<4, false, false>(span, s);
+	}
+}
+
+} // end of namespace TinyGL
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
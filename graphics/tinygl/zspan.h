@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H_
+#define GRAPHICS_TINYGL_ZSPAN_H_
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * One horizontal run of pixels of an untextured, Gouraud or flat shaded
+ * triangle. The interpolated values use the same fixed point encodings
+ * as ZBufferPoint and are stepped once per pixel.
+ */
+struct ShadedSpan {
+	byte *pbuf;     // first pixel of the span in the color buffer
+	uint *zbuf;     // first pixel of the span in the depth buffer
+	int count;      // number of pixels, at least 1
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+};
+
+/**
+ * Frame buffer state a span is drawn with. Only the state a span kernel
+ * has to implement is described here: the frame buffer falls back to
+ * its scalar path for alpha test, fog, stencil and stipple.
+ */
+struct ShadedSpanMode {
+	int bpp;        // 2 or 4
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+	int depthFunc;  // TGL_ALWAYS when the depth test is disabled
+	bool depthWrite;
+	bool blending;  // TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA on 4 bytes per pixel
+};
+
+typedef void (*ShadedSpanFunc)(const ShadedSpan &span, const ShadedSpanMode &mode);
+
+/**
+ * Vectorized span kernels used by FrameBuffer::fillTriangle. The kernel
+ * is picked at runtime depending on the host CPU, in the same way as
+ * the BlendBlit backends.
+ */
+class SpanFiller {
+public:
+	/**
+	 * Select the best span kernel for the host CPU. Calling this more than
+	 * once has no effect.
+	 */
+	static void init();
+
+	/**
+	 * Use the given kernel rather than detecting the CPU features, which
+	 * the null OSystem used by the unit tests cannot do.
+	 */
+	static void init(ShadedSpanFunc func) {
+		shadedSpanFunc = func;
+		_initialized = true;
+	}
+
+	/** The kernel in use, or nullptr to draw every pixel with the scalar code. */
+	static ShadedSpanFunc shadedSpanFunc;
+
+#ifdef SCUMMVM_SSE2
+	static void fillShadedSpanSSE2(const ShadedSpan &span, const ShadedSpanMode &mode);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void fillShadedSpanAVX2(const ShadedSpan &span, const ShadedSpanMode &mode);
+#endif
+
+private:
+	static bool _initialized;
+};
+
+} // end of namespace TinyGL
+
+#endif
@@ -179,6 +179,76 @@ void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &
 	z += dzdx;
 }
 
+ShadedSpanFunc FrameBuffer::selectShadedSpanFunc(ShadedSpanMode &mode, bool blending, bool depthTest, bool depthWrite) const {
+	ShadedSpanFunc func = SpanFiller::shadedSpanFunc;
+	if (!func || (_pbufBpp != 2 && _pbufBpp != 4))
+		return nullptr;
+	if (blending) {
+		// Only the usual transparency blending is vectorized
+		if (_pbufBpp != 4 || _pbufFormat.rLoss || _pbufFormat.gLoss || _pbufFormat.bLoss ||
+		    _sourceBlendingFactor != TGL_SRC_ALPHA || _destinationBlendingFactor != TGL_ONE_MINUS_SRC_ALPHA)
+			return nullptr;
+	}
+
+	mode.bpp = _pbufBpp;
+	mode.rLoss = _pbufFormat.rLoss;
+	mode.gLoss = _pbufFormat.gLoss;
+	mode.bLoss = _pbufFormat.bLoss;
+	mode.aLoss = _pbufFormat.aLoss;
+	mode.rShift = _pbufFormat.rShift;
+	mode.gShift = _pbufFormat.gShift;
+	mode.bShift = _pbufFormat.bShift;
+	mode.aShift = _pbufFormat.aShift;
+	mode.depthFunc = depthTest ? _depthFunc : TGL_ALWAYS;
+	mode.depthWrite = depthWrite;
+	mode.blending = blending;
+	return func;
+}
+
+template <bool kSmoothMode, bool kDepthWrite, bool kEnableScissor>
+bool FrameBuffer::fillShadedSpan(ShadedSpanFunc func, const ShadedSpanMode &mode, int pixelOffset, uint *pz, int x, int count,
+                                 uint z, uint r, uint g, uint b, uint a, int dzdx, int drdx, int dgdx, int dbdx, int dadx) {
+	int skip = 0;
+	if (kEnableScissor) {
+		skip = MAX(_clipRectangle.left - x, 0);
+		count = MIN<int>(count, _clipRectangle.right - x) - skip;
+	}
+	if (count <= 0)
+		return true;
+
+	if (kDepthWrite) {
+		// The kernels convert the depth to float as a signed value, which only
+		// matches the scalar code as long as it stays below 2^31
+		int64 zFirst = z;
+		int64 zLast = zFirst + (int64)(count - 1) * dzdx;
+		if (zFirst < 0 || zFirst > 0x7FFFFFFF || zLast < 0 || zLast > 0x7FFFFFFF)
+			return false;
+	}
+
+	// Like putPixelNoTexture(), pixels left of the scissor rectangle do not step
+	// the interpolated values
+	ShadedSpan span;
+	span.pbuf = _pbuf + (pixelOffset + skip) * _pbufBpp;
+	span.zbuf = pz + skip;
+	span.count = count;
+	span.z = z;
+	span.r = r;
+	span.g = g;
+	span.b = b;
+	span.a = a;
+	span.dzdx = dzdx;
+	if (kSmoothMode) {
+		span.drdx = drdx;
+		span.dgdx = dgdx;
+		span.dbdx = dbdx;
+		span.dadx = dadx;
+	} else {
+		span.drdx = span.dgdx = span.dbdx = span.dadx = 0;
+	}
+	func(span, mode);
+	return true;
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
           bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
           bool kBlendingEnabled, bool kStencilEnabled, bool kStippleEnabled, bool kDepthTestEnabled>
@@ -358,6 +428,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		pr1 = p0;
 		pr2 = p2;
 	}
+	ShadedSpanFunc spanFunc = nullptr;
+	ShadedSpanMode spanMode;
+	if (kInterpRGB && kInterpZ && !(kInterpST || kInterpSTZ) && !kFogMode && !kAlphaTestEnabled && !kStencilEnabled && !kStippleEnabled) {
+		spanFunc = selectShadedSpanFunc(spanMode, kBlendingEnabled, kDepthTestEnabled, kDepthWrite);
+	}
+
 	nb_lines = p1->y - p0->y;
 	y = p0->y;
 	for (part = 0; part < 2; part++) {
@@ -446,7 +522,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// The whole scan line is outside of the scissor rectangle
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -484,6 +562,10 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					n -= 1;
 					x += 1;
 				}
+			} else if (!(kInterpST || kInterpSTZ) && spanFunc &&
+			           fillShadedSpan<kSmoothMode, kDepthWrite, kEnableScissor>(spanFunc, spanMode, pp1 + x1, pz1 + x1, x1, (x2 >> 16) - x1 + 1,
+			                                                                    z1, r1, g1, b1, a1, dzdx, drdx, dgdx, dbdx, dadx)) {
+				// The whole span was drawn by the vectorized span filler
 			} else if (!(kInterpST || kInterpSTZ)) {
 				uint *pz;
 				byte *ps = nullptr;
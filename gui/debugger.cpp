@@ -26,6 +26,8 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
+#include "common/algorithm.h"
+#include "common/timer.h"
 
 #ifndef DISABLE_MD5
 #include "common/md5.h"
@@ -36,6 +38,8 @@
 
 #include "engines/engine.h"
 
+#include "graphics/fonts/ttf.h"
+
 #include "gui/debugger.h"
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 	#include "gui/console.h"
@@ -81,6 +85,10 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+	registerCmd("timers",			WRAP_METHOD(Debugger, cmdTimers));
+#ifdef USE_FREETYPE2
+	registerCmd("fontcache",		WRAP_METHOD(Debugger, cmdFontCache));
+#endif
 }
 
 Debugger::~Debugger() {
@@ -857,6 +865,66 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+static bool timerStatisticsLess(const Common::TimerManager::TimerStatistics &l, const Common::TimerManager::TimerStatistics &r) {
+	return l.id.compareToIgnoreCase(r.id) < 0;
+}
+
+bool Debugger::cmdTimers(int argc, const char **argv) {
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			timerManager->resetTimerStatistics();
+			debugPrintf("Reset the timer statistics\n");
+		} else {
+			debugPrintf("timers [reset]\n");
+		}
+		return true;
+	}
+
+	Common::Array<Common::TimerManager::TimerStatistics> stats;
+	timerManager->getTimerStatistics(stats);
+	if (stats.empty()) {
+		debugPrintf("No timer statistics available\n");
+		return true;
+	}
+
+	Common::sort(stats.begin(), stats.end(), timerStatisticsLess);
+
+	debugPrintf("%-24s %10s %8s %8s %7s %7s %7s\n", "Timer", "Interval", "Calls", "Overruns", "AvgLat", "MaxLat", "MaxRun");
+	for (uint i = 0; i < stats.size(); i++) {
+		const Common::TimerManager::TimerStatistics &timer = stats[i];
+		const uint32 avgLatency = timer.calls ? timer.totalLatency / timer.calls : 0;
+		debugPrintf("%-24s %8dus %8u %8u %5ums %5ums %5ums\n", timer.id.c_str(), timer.interval,
+		            timer.calls, timer.overruns, avgLatency, timer.maxLatency, timer.maxRunTime);
+	}
+	return true;
+}
+
+#ifdef USE_FREETYPE2
+bool Debugger::cmdFontCache(int argc, const char **argv) {
+	if (argc > 1) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			Graphics::resetTTFCacheStats();
+			debugPrintf("Reset the font cache statistics\n");
+		} else {
+			debugPrintf("fontcache [reset]\n");
+		}
+		return true;
+	}
+
+	const Graphics::TTFCacheStats stats = Graphics::getTTFCacheStats();
+	const uint32 lookups = stats.layoutHits + stats.layoutMisses;
+	debugPrintf("Glyph atlas: %u pages, %u KB (peak %u KB, budget %u KB per font), %u evictions\n",
+	            stats.atlasPages, stats.atlasBytes / 1024, stats.atlasPeakBytes / 1024,
+	            stats.atlasBudget / 1024, stats.atlasEvictions);
+	debugPrintf("String layouts: %u cached, %u KB, %u hits, %u misses, hit rate %u%%\n",
+	            stats.layouts, stats.layoutBytes / 1024, stats.layoutHits, stats.layoutMisses,
+	            lookups ? (uint32)(stats.layoutHits * 100ULL / lookups) : 0);
+	return true;
+}
+#endif
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
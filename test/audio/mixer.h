@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/audiostream.h"
+#include "audio/rate_intern.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	void selectRateKernels() {
+		// The null OSystem cannot report CPU features
+		Audio::RateKernels::mixFunc = Audio::RateKernels::mixGeneric;
+		Audio::RateKernels::interpolateFunc = Audio::RateKernels::interpolateGeneric;
+	}
+
+	void playStopTest(bool commandQueue) {
+		selectRateKernels();
+		Audio::MixerImpl impl(22050);
+		impl.setCommandQueueEnabled(commandQueue);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(22050, 1, nullptr, false, false), 7);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(7));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 7);
+
+		mixer.setChannelVolume(handle, 100);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+
+		// A second sound with the same id must be rejected
+		Audio::SoundHandle duplicate;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &duplicate, createSineStream<int16>(22050, 1, nullptr, false, false), 7);
+		TS_ASSERT(!mixer.isSoundHandleActive(duplicate));
+
+		int16 buffer[512 * 2];
+		TS_ASSERT_EQUALS(impl.mixCallback((byte *)buffer, sizeof(buffer)), 512);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		memset(buffer, 0x55, sizeof(buffer));
+		TS_ASSERT_EQUALS(impl.mixCallback((byte *)buffer, sizeof(buffer)), 0);
+		TS_ASSERT_EQUALS(buffer[0], 0);
+	}
+
+public:
+	void test_play_stop() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		playStopTest(false);
+#endif
+	}
+
+	void test_play_stop_command_queue() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		playStopTest(true);
+#endif
+	}
+
+	void test_command_queue_finished_channel() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		selectRateKernels();
+		Audio::MixerImpl impl(22050);
+		impl.setCommandQueueEnabled(true);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		// A 11025 Hz stream of 1 second lasts for 22050 output samples
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(11025, 1, nullptr, false, false));
+
+		int16 buffer[1024 * 2];
+		for (int i = 0; i < 21; i++)
+			impl.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// The audio thread releases the slot once the channel has finished
+		for (int i = 0; i < 4; i++)
+			impl.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+};
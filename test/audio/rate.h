@@ -0,0 +1,287 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate_intern.h"
+#include "audio/mixer.h"
+#include "audio/decoders/raw.h"
+#include "common/random.h"
+#include "common/textconsole.h"
+
+#include "helper.h"
+#include "test/instrset_detect.h"
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	struct KernelSet {
+		const char *name;
+		Audio::RateKernels::MixFunc mix;
+		Audio::RateKernels::InterpolateFunc interpolate;
+		Audio::RateKernels::FilterFunc filter;
+	};
+
+	int getKernelSets(KernelSet *sets) {
+		int count = 0;
+		KernelSet generic = { "generic", Audio::RateKernels::mixGeneric, Audio::RateKernels::interpolateGeneric, Audio::RateKernels::filterGeneric };
+		sets[count++] = generic;
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			KernelSet sse2 = { "SSE2", Audio::RateKernels::mixSSE2, Audio::RateKernels::interpolateSSE2, Audio::RateKernels::filterSSE2 };
+			sets[count++] = sse2;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			KernelSet avx2 = { "AVX2", Audio::RateKernels::mixAVX2, Audio::RateKernels::interpolateAVX2, Audio::RateKernels::filterAVX2 };
+			sets[count++] = avx2;
+		}
+#endif
+		return count;
+	}
+
+	void selectBestKernels() {
+		KernelSet sets[3];
+		const int numSets = getKernelSets(sets);
+
+		// The null OSystem cannot report CPU features
+		Audio::RateKernels::mixFunc = sets[numSets - 1].mix;
+		Audio::RateKernels::interpolateFunc = sets[numSets - 1].interpolate;
+		Audio::RateKernels::filterFunc = sets[numSets - 1].filter;
+	}
+
+	void fillRandom(int16 *buf, uint count, Common::RandomSource &rnd) {
+		for (uint i = 0; i < count; i++) {
+			switch (rnd.getRandomNumber(7)) {
+			case 0:
+				buf[i] = -32768;
+				break;
+			case 1:
+				buf[i] = 32767;
+				break;
+			default:
+				buf[i] = (int16)(rnd.getRandomNumber(65535) - 32768);
+				break;
+			}
+		}
+	}
+
+public:
+	void test_kernels_match_generic() {
+		Common::RandomSource rnd("rate");
+		KernelSet sets[3];
+		const int numSets = getKernelSets(sets);
+
+		const uint frames = 301; // Not a multiple of any vector size
+		int16 in[2 * frames], pairs[4 * frames], coefs[2 * frames], out[2 * frames];
+		int16 expected[2 * frames], actual[2 * frames];
+
+		const Audio::st_volume_t volumes[][2] = { { 256, 256 }, { 0, 256 }, { 255, 1 }, { 128, 200 } };
+
+		for (int v = 0; v < ARRAYSIZE(volumes); v++) {
+			fillRandom(in, ARRAYSIZE(in), rnd);
+			fillRandom(out, ARRAYSIZE(out), rnd);
+			fillRandom(pairs, ARRAYSIZE(pairs), rnd);
+			for (uint i = 0; i < frames; i++) {
+				coefs[2 * i] = (int16)rnd.getRandomNumber(Audio::FRAC_ONE_LOW - 1);
+				coefs[2 * i + 1] = -coefs[2 * i];
+			}
+
+			for (int outStereo = 0; outStereo < 2; outStereo++) {
+				memcpy(expected, out, sizeof(out));
+				Audio::RateKernels::mixGeneric(expected, in, frames, outStereo, volumes[v][0], volumes[v][1]);
+
+				for (int s = 1; s < numSets; s++) {
+					memcpy(actual, out, sizeof(out));
+					sets[s].mix(actual, in, frames, outStereo, volumes[v][0], volumes[v][1]);
+					TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+				}
+			}
+
+			Audio::RateKernels::interpolateGeneric(expected, pairs, coefs, frames);
+			for (int s = 1; s < numSets; s++) {
+				sets[s].interpolate(actual, pairs, coefs, frames);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(actual)), 0);
+			}
+		}
+
+		// Check the filters with random coefficients as well as the real
+		// sub-filters, which have the largest sums
+		int16 history[Audio::POLYPHASE_TAPS], coefs16[Audio::POLYPHASE_TAPS];
+		const int16 *filters = Audio::PolyphaseFilterCache::instance().getFilter(48000, 22050);
+		for (int i = 0; i < 1000; i++) {
+			fillRandom(history, ARRAYSIZE(history), rnd);
+			const int16 *filter = coefs16;
+			if (i & 1) {
+				filter = &filters[(i % (Audio::PolyphaseFilterCache::PHASES + 1)) * Audio::POLYPHASE_TAPS];
+			} else {
+				for (int t = 0; t < Audio::POLYPHASE_TAPS; t++)
+					coefs16[t] = (int16)(rnd.getRandomNumber(4095) - 2048);
+			}
+
+			const Audio::st_sample_t expectedSample = Audio::RateKernels::filterGeneric(history, filter);
+			for (int s = 1; s < numSets; s++)
+				TS_ASSERT_EQUALS(sets[s].filter(history, filter), expectedSample);
+		}
+	}
+
+	void test_interpolate_constant() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		selectBestKernels();
+
+		// A constant signal has to stay constant whatever the rates
+		const int inRate = 11025, outRate = 48000, len = inRate / 4;
+		int16 *data = new int16[len];
+		for (int i = 0; i < len; i++)
+			data[i] = 1000;
+		Audio::AudioStream *s = Audio::makeRawStream((const byte *)data, len * 2, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, true, false);
+		int16 out[2 * 1000];
+		memset(out, 0, sizeof(out));
+		TS_ASSERT_EQUALS(converter->convert(*s, out, 1000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+		// The first frames are still interpolated from silence
+		for (int i = 2 * 8; i < 2 * 1000; i++)
+			TS_ASSERT_EQUALS(out[i], 1000);
+
+		delete converter;
+		delete s;
+#endif
+	}
+
+	void test_polyphase_constant() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		selectBestKernels();
+
+		const int rates[][2] = { { 11025, 48000 }, { 48000, 22050 }, { 22050, 22050 } };
+		for (int r = 0; r < ARRAYSIZE(rates); r++) {
+			const int inRate = rates[r][0], outRate = rates[r][1], len = inRate / 4;
+			int16 *data = new int16[len * 2];
+			for (int i = 0; i < len * 2; i++)
+				data[i] = (i & 1) ? -20000 : 20000;
+			Audio::AudioStream *s = Audio::makeRawStream((const byte *)data, len * 4, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | Audio::FLAG_STEREO, DisposeAfterUse::YES);
+
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, true, true, true, Audio::kResamplerPolyphase);
+			int16 out[2 * 1000];
+			memset(out, 0, sizeof(out));
+			TS_ASSERT_EQUALS(converter->convert(*s, out, 1000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+
+			// Skip the filter latency, then both (reversed) channels must be constant
+			for (int i = 2 * 100; i < 2 * 1000; i += 2) {
+				TS_ASSERT_EQUALS(out[i], -20000);
+				TS_ASSERT_EQUALS(out[i + 1], 20000);
+			}
+
+			delete converter;
+			delete s;
+		}
+#endif
+	}
+
+	void test_polyphase_shared_filters() {
+		Audio::PolyphaseFilterCache &cache = Audio::PolyphaseFilterCache::instance();
+
+		// Same downsampling ratio, same filter
+		const int16 *filter = cache.getFilter(44100, 22050);
+		TS_ASSERT_EQUALS(cache.getFilter(88200, 44100), filter);
+		TS_ASSERT_DIFFERS(cache.getFilter(48000, 22050), filter);
+
+		// All upsampling ratios use the same cutoff frequency
+		TS_ASSERT_EQUALS(cache.getFilter(11025, 48000), cache.getFilter(22050, 44100));
+
+		// Every phase has unity gain
+		for (int phase = 0; phase <= Audio::PolyphaseFilterCache::PHASES; phase++) {
+			int sum = 0;
+			for (int t = 0; t < Audio::POLYPHASE_TAPS; t++)
+				sum += filter[phase * Audio::POLYPHASE_TAPS + t];
+			TS_ASSERT_EQUALS(sum, Audio::FRAC_ONE_LOW);
+		}
+	}
+
+	void test_polyphase_drain() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		selectBestKernels();
+
+		// The last input frames have to come out of the filter at the end
+		// of the stream, without waiting for more input
+		const int rates[][2] = { { 11025, 22050 }, { 22050, 22050 }, { 44100, 22050 } };
+		for (int r = 0; r < ARRAYSIZE(rates); r++) {
+			const int inRate = rates[r][0], outRate = rates[r][1], len = 64;
+			int16 *data = new int16[len];
+			for (int i = 0; i < len; i++)
+				data[i] = 16000;
+			Audio::AudioStream *s = Audio::makeRawStream((const byte *)data, len * 2, inRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, false, Audio::kResamplerPolyphase);
+			int16 out[1000];
+			memset(out, 0, sizeof(out));
+
+			int total = 0, res;
+			while ((res = converter->convert(*s, out + total, ARRAYSIZE(out) - total, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume)) > 0)
+				total += res;
+			TS_ASSERT(!converter->needsDraining());
+
+			// All the input frames have been output, plus the filter delay
+			const int expected = (len + Audio::POLYPHASE_TAPS / 2) * outRate / inRate;
+			TS_ASSERT_LESS_THAN_EQUALS(expected - 1, total);
+			TS_ASSERT_LESS_THAN_EQUALS(total, expected + 1);
+
+			// The output ends on the last input frame, so the level only
+			// starts to drop into the silence which follows
+			TS_ASSERT_LESS_THAN_EQUALS(8000, out[total - 1]);
+			TS_ASSERT_EQUALS(out[total - 1 - 10 * outRate / inRate], 16000);
+			delete converter;
+			delete s;
+		}
+#endif
+	}
+
+	void test_kernel_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		Common::RandomSource rnd("rate");
+		KernelSet sets[3];
+		const int numSets = getKernelSets(sets);
+
+		const uint frames = 256;
+		int16 in[2 * frames], pairs[4 * frames], coefs[2 * frames], out[2 * frames];
+		fillRandom(in, ARRAYSIZE(in), rnd);
+		fillRandom(pairs, ARRAYSIZE(pairs), rnd);
+		for (uint i = 0; i < frames; i++) {
+			coefs[2 * i] = (int16)rnd.getRandomNumber(Audio::FRAC_ONE_LOW - 1);
+			coefs[2 * i + 1] = -coefs[2 * i];
+		}
+
+#ifdef SLOW_TESTS
+		const int iters = 200000;
+#else
+		const int iters = 2000;
+#endif
+
+		for (int s = 0; s < numSets; s++) {
+			memset(out, 0, sizeof(out));
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				sets[s].mix(out, in, frames, true, 200, 100);
+			const uint32 mixTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			start = g_system->getMillis();
+			for (int i = 0; i < iters; i++)
+				sets[s].interpolate(out, pairs, coefs, frames);
+			const uint32 interpolateTime = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			debug("Rate converter %s kernels: mix %f, interpolate %f samples/second\n", sets[s].name,
+				(double)frames * iters * 1000.0 / mixTime, (double)frames * iters * 1000.0 / interpolateTime);
+		}
+#endif
+	}
+};
@@ -0,0 +1,138 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/timer/default/default-timer.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+template<int N>
+static void countTimerCall(void *refCon) {
+	(*(int *)refCon)++;
+}
+
+struct TimerRemoval {
+	DefaultTimerManager *manager;
+	Common::TimerManager::TimerProc victim;
+	int calls;
+	int limit;
+};
+
+static void removeAfterLimit(void *refCon) {
+	TimerRemoval *removal = (TimerRemoval *)refCon;
+	if (++removal->calls == removal->limit)
+		removal->manager->removeTimerProc(removal->victim);
+}
+
+class DefaultTimerManagerTestSuite : public CxxTest::TestSuite {
+	const Common::TimerManager::TimerStatistics *findStatistics(const Common::Array<Common::TimerManager::TimerStatistics> &stats, const char *id) {
+		for (uint i = 0; i < stats.size(); i++) {
+			if (stats[i].id == id)
+				return &stats[i];
+		}
+		return nullptr;
+	}
+
+	public:
+	void test_rates() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		DefaultTimerManager manager;
+		int calls[5] = { 0, 0, 0, 0, 0 };
+		const uint32 start = g_system->getMillis();
+		manager.installTimerProc(countTimerCall<0>, 10000, &calls[0], "10ms");
+		manager.installTimerProc(countTimerCall<1>, 25000, &calls[1], "25ms");
+		manager.installTimerProc(countTimerCall<2>, 1000000, &calls[2], "1s");
+		manager.installTimerProc(countTimerCall<3>, 500, &calls[3], "500us");
+		manager.installTimerProc(countTimerCall<4>, 30000000, &calls[4], "30s");
+
+		// Regular handler calls, like the SDL timer thread does
+		uint32 time = start;
+		while (time < start + 5000) {
+			time += 8;
+			manager.runTimers(time);
+		}
+		TS_ASSERT_DELTA(calls[0], 500, 1);
+		TS_ASSERT_DELTA(calls[1], 200, 1);
+		TS_ASSERT_DELTA(calls[2], 5, 1);
+		TS_ASSERT_DELTA(calls[3], 10000, 2);
+		TS_ASSERT_EQUALS(calls[4], 0);
+
+		// A long pause has the timers catch up with every missed interval,
+		// including the ones sitting on the coarser levels of the wheel
+		manager.runTimers(start + 95000);
+		TS_ASSERT_DELTA(calls[0], 9500, 1);
+		TS_ASSERT_DELTA(calls[2], 95, 1);
+		TS_ASSERT_DELTA(calls[4], 3, 1);
+
+		manager.removeTimerProc(countTimerCall<0>);
+		manager.runTimers(start + 96000);
+		TS_ASSERT_DELTA(calls[0], 9500, 1);
+		TS_ASSERT_DELTA(calls[2], 96, 1);
+#endif
+	}
+
+	void test_remove_from_callback() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		DefaultTimerManager manager;
+		int calls = 0;
+		TimerRemoval self = { &manager, removeAfterLimit, 0, 3 };
+		TimerRemoval other = { &manager, countTimerCall<0>, 0, 5 };
+		const uint32 start = g_system->getMillis();
+		manager.installTimerProc(removeAfterLimit, 10000, &self, "self");
+
+		// Removing itself from the callback
+		manager.runTimers(start + 1000);
+		TS_ASSERT_EQUALS(self.calls, 3);
+
+		// Removing another timer, which is already queued for the same tick
+		const uint32 time = g_system->getMillis();
+		manager.installTimerProc(countTimerCall<0>, 10000, &calls, "victim");
+		manager.installTimerProc(removeAfterLimit, 10000, &other, "other");
+		manager.runTimers(time + 1000);
+		TS_ASSERT_DELTA(other.calls, 100, 1);
+		TS_ASSERT_DELTA(calls, 5, 1);
+		manager.removeTimerProc(removeAfterLimit);
+
+		// The name can be reused once the timer is gone
+		calls = 0;
+		manager.installTimerProc(countTimerCall<1>, 1000, &calls, "victim");
+		manager.runTimers(g_system->getMillis() + 11);
+		TS_ASSERT_DELTA(calls, 10, 1);
+#endif
+	}
+
+	void test_statistics() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		DefaultTimerManager manager;
+		int calls = 0;
+		const uint32 start = g_system->getMillis();
+		manager.installTimerProc(countTimerCall<0>, 10000, &calls, "late");
+
+		// All calls happen at once, most of them over an interval late
+		manager.runTimers(start + 100);
+
+		Common::Array<Common::TimerManager::TimerStatistics> stats;
+		manager.getTimerStatistics(stats);
+		TS_ASSERT_EQUALS(stats.size(), 1u);
+		const Common::TimerManager::TimerStatistics *late = findStatistics(stats, "late");
+		TS_ASSERT(late);
+		if (!late)
+			return;
+		TS_ASSERT_EQUALS(late->interval, 10000);
+		TS_ASSERT_EQUALS(late->calls, (uint32)calls);
+		TS_ASSERT_DELTA(late->calls, 9u, 1u);
+		TS_ASSERT_DELTA(late->overruns, 8u, 1u);
+		TS_ASSERT_DELTA(late->maxLatency, 90u, 1u);
+
+		manager.resetTimerStatistics();
+		manager.getTimerStatistics(stats);
+		TS_ASSERT_EQUALS(stats[0].calls, 0u);
+		TS_ASSERT_EQUALS(stats[0].maxLatency, 0u);
+#endif
+	}
+};
@@ -1,7 +1,19 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/hashmap.h"
+#include "common/flat-hashmap.h"
 #include "common/hash-str.h"
+#include "common/random.h"
+#include "common/system.h"
+#include "common/debug.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
 
 class HashMapTestSuite : public CxxTest::TestSuite
 {
@@ -232,3 +244,186 @@ class HashMapTestSuite : public CxxTest::TestSuite
 
 	// TODO: Add test cases for iterators, find, ...
 };
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	static uint scatter(int i) {
+		// Spread the keys like real hashes would be
+		return (uint)i * 2654435761U >> 3;
+	}
+
+	template<class Map>
+	uint32 timeStringLookups(const Map &map, const Common::String *keys, int count, int iters, int &sum) {
+		const uint32 start = g_system->getMillis();
+		for (int n = 0; n < iters; n++) {
+			for (int i = 0; i < count; i++)
+				sum += map.getValOrDefault(keys[i], 0);
+		}
+		return MAX<uint32>(g_system->getMillis() - start, 1);
+	}
+
+	template<class Map>
+	uint32 timeIntLookups(const Map &map, int count, int iters, int &sum) {
+		const uint32 start = g_system->getMillis();
+		for (int n = 0; n < iters; n++) {
+			for (int i = 0; i < count; i++)
+				sum += map.getValOrDefault(scatter(i), 0);
+		}
+		return MAX<uint32>(g_system->getMillis() - start, 1);
+	}
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("FOO"));
+		TS_ASSERT_EQUALS(container2["Quux"], "blub");
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 5; i++)
+			container[i] = i * 10;
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		container.erase(3);
+		TS_ASSERT(!container.contains(3));
+		TS_ASSERT_EQUALS(container.find(3), container.end());
+		container[1] = 42;
+		TS_ASSERT_EQUALS(container.size(), 4U);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT(!(found & (1 << i->_key)));
+			found |= 1 << i->_key;
+		}
+		TS_ASSERT_EQUALS(found, 1 + 2 + 4 + 16);
+		TS_ASSERT_EQUALS(container[1], 42);
+		TS_ASSERT_EQUALS(container[4], 40);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, int> map1, container2;
+		for (int i = 0; i < 100; i++)
+			map1[i] = -i;
+		map1.erase(50);
+		container2 = map1;
+		Common::FlatHashMap<int, int> container3(container2);
+		TS_ASSERT_EQUALS(container3.size(), 99U);
+		TS_ASSERT(!container3.contains(50));
+		TS_ASSERT_EQUALS(container3[99], -99);
+	}
+
+	void test_matches_hashmap() {
+		// Random inserts and erases must behave exactly like HashMap,
+		// including when the table is full of deleted slots.
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		Common::RandomSource rnd("flathashmap");
+		Common::HashMap<int, int> reference;
+		Common::FlatHashMap<int, int> container;
+
+		for (int n = 0; n < 20000; n++) {
+			const int key = rnd.getRandomNumber(999) * 64;
+			if (rnd.getRandomNumber(2) == 0) {
+				reference.erase(key);
+				container.erase(key);
+			} else {
+				reference[key] = n;
+				container[key] = n;
+			}
+			TS_ASSERT_EQUALS(container.size(), reference.size());
+		}
+
+		for (Common::HashMap<int, int>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(container.getValOrDefault(i->_key, -1), i->_value);
+		uint count = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i, ++count)
+			TS_ASSERT_EQUALS(reference.getValOrDefault(i->_key, -1), i->_value);
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+
+	void test_strided_keys() {
+#if BENCHMARK_TIME
+		// Integer keys hash to themselves, so keys with a power of two stride
+		// only differ in their high bits. They must still be spread over the
+		// groups instead of probing through the whole table.
+		Common::install_null_g_system();
+
+		const int count = 20000;
+		const int strides[] = { 64, 512, 4096, 65536 };
+		for (int s = 0; s < ARRAYSIZE(strides); s++) {
+			Common::HashMap<int, int> reference;
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < count; i++)
+				reference[i * strides[s]] = i;
+			const uint32 referenceTime = g_system->getMillis() - start;
+
+			Common::FlatHashMap<int, int> container;
+			const uint32 flatStart = g_system->getMillis();
+			for (int i = 0; i < count; i++)
+				container[i * strides[s]] = i;
+			for (int i = 0; i < count; i++)
+				TS_ASSERT_EQUALS(container.getValOrDefault(i * strides[s], -1), i);
+			const uint32 flatTime = g_system->getMillis() - flatStart;
+
+			TS_ASSERT_EQUALS(container.size(), (uint)count);
+			TS_ASSERT_LESS_THAN(flatTime, referenceTime * 10 + 100);
+		}
+#endif
+	}
+
+	void test_lookup_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int count = 100000, iters = 100;
+#else
+		const int count = 10000, iters = 20;
+#endif
+		int sum = 0;
+
+		// Half of the lookups are misses
+		Common::String *keys = new Common::String[count];
+		for (int i = 0; i < count; i++)
+			keys[i] = Common::String::format("sound/effects/%d.wav", i);
+
+		Common::HashMap<Common::String, int> stringMap;
+		Common::FlatHashMap<Common::String, int> flatStringMap;
+		Common::HashMap<uint, int> intMap;
+		Common::FlatHashMap<uint, int> flatIntMap;
+		for (int i = 0; i < count; i += 2) {
+			stringMap[keys[i]] = i;
+			flatStringMap[keys[i]] = i;
+			intMap[scatter(i)] = i;
+			flatIntMap[scatter(i)] = i;
+		}
+
+		const uint32 stringTime = timeStringLookups(stringMap, keys, count, iters, sum);
+		const uint32 flatStringTime = timeStringLookups(flatStringMap, keys, count, iters, sum);
+		const uint32 intTime = timeIntLookups(intMap, count, iters, sum);
+		const uint32 flatIntTime = timeIntLookups(flatIntMap, count, iters, sum);
+		delete[] keys;
+
+		debug("HashMap: %u ms for string lookups, %u ms for int lookups\n", stringTime, intTime);
+		debug("FlatHashMap: %u ms for string lookups, %u ms for int lookups (checksum %d)\n", flatStringTime, flatIntTime, sum);
+#endif
+	}
+};
@@ -0,0 +1,165 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/crc.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/compression/unzip.h"
+
+#include "../null_osystem.h"
+
+class MappedReadStreamTestSuite : public CxxTest::TestSuite {
+	struct Member {
+		const char *name;
+		const char *contents;
+		bool badCRC;
+	};
+
+	static const char *getPath() {
+		return "test/mappedreadstream.zip";
+	}
+
+	/** Write a ZIP file holding the members without compression. */
+	static bool writeZip(const Common::FSNode &node, const Member *members, int count) {
+		Common::ScopedPtr<Common::SeekableWriteStream> out(node.createWriteStream());
+		if (!out)
+			return false;
+
+		Common::CRC32 crc;
+		uint32 offsets[8];
+		uint32 crcs[8];
+		for (int i = 0; i < count; i++) {
+			const uint32 size = strlen(members[i].contents);
+			offsets[i] = out->pos();
+			crcs[i] = crc.crcFast((const byte *)members[i].contents, size) ^ (members[i].badCRC ? 1 : 0);
+
+			out->writeUint32LE(0x04034b50);
+			out->writeUint16LE(10);
+			out->writeUint16LE(0);
+			out->writeUint16LE(0);
+			out->writeUint32LE(0);
+			out->writeUint32LE(crcs[i]);
+			out->writeUint32LE(size);
+			out->writeUint32LE(size);
+			out->writeUint16LE(strlen(members[i].name));
+			out->writeUint16LE(0);
+			out->writeString(members[i].name);
+			out->writeString(members[i].contents);
+		}
+
+		const uint32 centralDir = out->pos();
+		for (int i = 0; i < count; i++) {
+			const uint32 size = strlen(members[i].contents);
+			out->writeUint32LE(0x02014b50);
+			out->writeUint16LE(10);
+			out->writeUint16LE(10);
+			out->writeUint16LE(0);
+			out->writeUint16LE(0);
+			out->writeUint32LE(0);
+			out->writeUint32LE(crcs[i]);
+			out->writeUint32LE(size);
+			out->writeUint32LE(size);
+			out->writeUint16LE(strlen(members[i].name));
+			out->writeUint16LE(0);
+			out->writeUint16LE(0);
+			out->writeUint16LE(0);
+			out->writeUint16LE(0);
+			out->writeUint32LE(0);
+			out->writeUint32LE(offsets[i]);
+			out->writeString(members[i].name);
+		}
+
+		const uint32 centralDirEnd = out->pos();
+		out->writeUint32LE(0x06054b50);
+		out->writeUint16LE(0);
+		out->writeUint16LE(0);
+		out->writeUint16LE(count);
+		out->writeUint16LE(count);
+		out->writeUint32LE(centralDirEnd - centralDir);
+		out->writeUint32LE(centralDir);
+		out->writeUint16LE(0);
+
+		out->finalize();
+		return !out->err();
+	}
+
+	static Common::String readAll(Common::SeekableReadStream *stream) {
+		Common::String result;
+		while (!stream->eos()) {
+			const byte b = stream->readByte();
+			if (!stream->eos())
+				result += (char)b;
+		}
+		return result;
+	}
+
+public:
+	void test_mapped_zip_members() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const Member members[] = {
+			{ "first.txt", "The first member", false },
+			{ "dir/second.txt", "The second, somewhat longer member of the archive", false },
+			{ "broken.txt", "A member with a wrong checksum", true }
+		};
+		const Common::FSNode node(getPath());
+		TS_ASSERT(writeZip(node, members, ARRAYSIZE(members)));
+
+		Common::ScopedPtr<Common::MappedReadStream> mapped(node.createMappedReadStream());
+#if defined(POSIX)
+		TS_ASSERT(mapped);
+#endif
+		if (mapped) {
+			Common::ScopedPtr<Common::SeekableReadStream> file(node.createReadStream());
+			TS_ASSERT_EQUALS(mapped->size(), file->size());
+
+			byte *contents = new byte[file->size()];
+			TS_ASSERT_EQUALS(file->read(contents, file->size()), (uint32)file->size());
+			TS_ASSERT_EQUALS(memcmp(mapped->getMappedData(), contents, file->size()), 0);
+			delete[] contents;
+		}
+
+		Common::Archive *archive = Common::makeZipArchive(node);
+		TS_ASSERT(archive);
+		if (!archive)
+			return;
+
+		Common::ScopedPtr<Common::SeekableReadStream> first(archive->createReadStreamForMember("first.txt"));
+		Common::ScopedPtr<Common::SeekableReadStream> second(archive->createReadStreamForMember("dir/second.txt"));
+		Common::ScopedPtr<Common::SeekableReadStream> broken(archive->createReadStreamForMember("broken.txt"));
+		TS_ASSERT(first);
+		TS_ASSERT(second);
+		TS_ASSERT(!broken);
+
+		// The members borrow the mapping, which has to stay valid after the
+		// archive is closed
+		delete archive;
+
+		if (first)
+			TS_ASSERT_EQUALS(readAll(first.get()), members[0].contents);
+		if (second)
+			TS_ASSERT_EQUALS(readAll(second.get()), members[1].contents);
+#endif
+	}
+
+	void test_shared_archive_contents_lifetime() {
+		static const byte data[] = { 'm', 'a', 'p', 'p', 'e', 'd' };
+		int deleted = 0;
+
+		struct CountingStream : public Common::MappedReadStream {
+			int *_deleted;
+			CountingStream(const byte *d, uint32 size, int *deleted) : Common::MappedReadStream(d, size), _deleted(deleted) {}
+			~CountingStream() override { (*_deleted)++; }
+		};
+
+		Common::SharedPtr<Common::MappedReadStream> mapped(new CountingStream(data, sizeof(data), &deleted));
+		{
+			Common::SharedArchiveContents contents(mapped, 2, 3);
+			mapped.reset();
+			TS_ASSERT_EQUALS(deleted, 0);
+		}
+		TS_ASSERT_EQUALS(deleted, 1);
+	}
+};
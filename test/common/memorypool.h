@@ -0,0 +1,84 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memorypool.h"
+
+class MemoryPoolTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_memory_pool() {
+		Common::MemoryPool pool(12);
+		TS_ASSERT_EQUALS(pool.getChunkSize(), (size_t)((12 + sizeof(void *) - 1) & ~(sizeof(void *) - 1)));
+
+		void *chunks[100];
+		for (int i = 0; i < 100; i++) {
+			chunks[i] = pool.allocChunk();
+			memset(chunks[i], i, 12);
+		}
+		TS_ASSERT(pool.getReservedSize() >= 100 * pool.getChunkSize());
+		for (int i = 0; i < 100; i++) {
+			TS_ASSERT_EQUALS(((byte *)chunks[i])[11], i);
+			pool.freeChunk(chunks[i]);
+		}
+
+		pool.freeUnusedPages();
+		TS_ASSERT_EQUALS(pool.getNumPages(), 0U);
+		TS_ASSERT_EQUALS(pool.getReservedSize(), 0U);
+	}
+
+	void test_arena_chunk_size() {
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(0), 8U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(1), 8U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(8), 8U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(9), 16U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(65), 80U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(129), 160U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(500), 512U);
+		TS_ASSERT_EQUALS(Common::SizeClassArena::getChunkSize(513), 513U);
+	}
+
+	void test_arena_alloc_free() {
+		Common::SizeClassArena &arena = Common::SizeClassArena::instance();
+		const Common::SizeClassArena::Stats before = arena.getStats();
+
+		// Enough blocks to go through several magazine refills
+		const int count = 200;
+		void *blocks[count];
+		for (int i = 0; i < count; i++) {
+			const size_t size = 1 + (i * 37) % 600;
+			blocks[i] = arena.alloc(size);
+			TS_ASSERT(blocks[i] != nullptr);
+			memset(blocks[i], i, size);
+		}
+
+		const Common::SizeClassArena::Stats during = arena.getStats();
+		TS_ASSERT(during.usedBytes > before.usedBytes);
+#ifdef USE_ARENA_MAGAZINES
+		TS_ASSERT(during.refills > before.refills);
+#endif
+		TS_ASSERT(during.reservedBytes >= during.usedBytes);
+
+		for (int i = 0; i < count; i++) {
+			const size_t size = 1 + (i * 37) % 600;
+			TS_ASSERT_EQUALS(((byte *)blocks[i])[size - 1], (byte)i);
+			arena.free(blocks[i], size);
+		}
+
+		arena.freeUnusedPages();
+		const Common::SizeClassArena::Stats after = arena.getStats();
+		TS_ASSERT(after.usedBytes <= before.usedBytes);
+		TS_ASSERT(after.reservedBytes < during.reservedBytes);
+#ifdef USE_ARENA_MAGAZINES
+		TS_ASSERT(after.flushes > before.flushes);
+#endif
+	}
+
+	void test_arena_reuse() {
+		Common::SizeClassArena &arena = Common::SizeClassArena::instance();
+
+		// A freed block is the next one handed out for its size class
+		void *block = arena.alloc(40);
+		arena.free(block, 40);
+		TS_ASSERT_EQUALS(arena.alloc(33), block);
+		arena.free(block, 33);
+	}
+};
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/bufferedstream.h"
+
+#include "../null_osystem.h"
+
+class PrefetchingReadStreamTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_traverse() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::PrefetchingReadStream &prs
+			= *Common::wrapPrefetchingReadStream(&ms, 4, DisposeAfterUse::NO);
+
+		byte i, b;
+		for (i = 0; i < 10; ++i) {
+			TS_ASSERT(!prs.eos());
+
+			TS_ASSERT_EQUALS(i, prs.pos());
+
+			prs.read(&b, 1);
+			TS_ASSERT_EQUALS(i, b);
+		}
+
+		TS_ASSERT(!prs.eos());
+
+		TS_ASSERT_EQUALS((uint)0, prs.read(&b, 1));
+		TS_ASSERT(prs.eos());
+
+		// The third block is short, so no read is attempted after it
+		const Common::PrefetchingReadStream::Stats &stats = prs.getStats();
+		TS_ASSERT_EQUALS(stats.hits + stats.misses, 3u);
+
+		delete &prs;
+#endif
+	}
+
+	void test_seek() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableReadStream &prs
+			= *Common::wrapPrefetchingReadStream(&ms, 4, DisposeAfterUse::NO);
+		byte b;
+
+		TS_ASSERT_EQUALS(prs.pos(), 0);
+		TS_ASSERT_EQUALS(prs.size(), 10);
+
+		prs.seek(1, SEEK_SET);
+		TS_ASSERT_EQUALS(prs.pos(), 1);
+		b = prs.readByte();
+		TS_ASSERT_EQUALS(b, 1);
+
+		// Lands in the prefetched block
+		prs.seek(4, SEEK_CUR);
+		TS_ASSERT_EQUALS(prs.pos(), 6);
+		b = prs.readByte();
+		TS_ASSERT_EQUALS(b, 6);
+
+		prs.seek(-3, SEEK_CUR);
+		TS_ASSERT_EQUALS(prs.pos(), 4);
+		b = prs.readByte();
+		TS_ASSERT_EQUALS(b, 4);
+
+		prs.seek(0, SEEK_END);
+		TS_ASSERT_EQUALS(prs.pos(), 10);
+		TS_ASSERT(!prs.eos());
+		b = prs.readByte();
+		TS_ASSERT(prs.eos());
+
+		prs.seek(-3, SEEK_END);
+		TS_ASSERT(!prs.eos());
+		TS_ASSERT_EQUALS(prs.pos(), 7);
+		b = prs.readByte();
+		TS_ASSERT_EQUALS(b, 7);
+
+		prs.seek(-8, SEEK_END);
+		TS_ASSERT_EQUALS(prs.pos(), 2);
+		b = prs.readByte();
+		TS_ASSERT_EQUALS(b, 2);
+
+		byte readBuffer[8];
+		prs.seek(0, SEEK_SET);
+		TS_ASSERT_EQUALS(prs.read(readBuffer, 8), 8u);
+		for (int i = 0; i < 8; i++)
+			TS_ASSERT_EQUALS(readBuffer[i], i);
+		prs.seek(-1, SEEK_CUR);
+		TS_ASSERT_EQUALS(prs.pos(), 7);
+		TS_ASSERT_EQUALS(prs.read(readBuffer, 8), 3u);
+		TS_ASSERT_EQUALS(readBuffer[2], 9);
+		TS_ASSERT(prs.eos());
+
+		delete &prs;
+#endif
+	}
+};
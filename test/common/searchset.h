@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+class SearchSetTestSuite : public CxxTest::TestSuite
+{
+	// Archive with a fixed list of members, each one containing the archive id
+	class TestArchive : public Common::Archive {
+	public:
+		TestArchive(byte id, bool indexable) : _id(id), _indexable(indexable) {}
+
+		void addFile(const char *path) { _files.push_back(Common::Path(path)); }
+		void removeFile(const char *path) {
+			for (uint i = 0; i < _files.size(); i++) {
+				if (_files[i].equalsIgnoreCase(Common::Path(path))) {
+					_files.remove_at(i);
+					return;
+				}
+			}
+		}
+
+		bool hasFile(const Common::Path &path) const override {
+			for (uint i = 0; i < _files.size(); i++) {
+				if (_files[i].equalsIgnoreCase(path))
+					return true;
+			}
+			return false;
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			for (uint i = 0; i < _files.size(); i++)
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_files[i], *this)));
+			return _files.size();
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return Common::ArchiveMemberPtr();
+			return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+		}
+
+		Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+			if (!hasFile(path))
+				return nullptr;
+			return new Common::MemoryReadStream(&_id, 1);
+		}
+
+		bool isMemberListIndexable() const override { return _indexable; }
+
+	private:
+		byte _id;
+		bool _indexable;
+		Common::Array<Common::Path> _files;
+	};
+
+	int openMember(const Common::SearchSet &set, const char *path) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(path));
+		if (!stream)
+			return -1;
+		const int id = stream->readByte();
+		delete stream;
+		return id;
+	}
+
+	public:
+	void test_priority_order() {
+		Common::SearchSet set;
+		TestArchive *a = new TestArchive(1, true);
+		TestArchive *b = new TestArchive(2, false);
+		TestArchive *c = new TestArchive(3, true);
+		a->addFile("shared.dat");
+		a->addFile("a.dat");
+		b->addFile("shared.dat");
+		b->addFile("b.dat");
+		c->addFile("SHARED.DAT");
+		c->addFile("sub/c.dat");
+
+		set.add("a", a, 0);
+		set.add("b", b, 10);
+		set.add("c", c, 20);
+
+		TS_ASSERT_EQUALS(openMember(set, "shared.dat"), 3);
+		TS_ASSERT_EQUALS(openMember(set, "a.dat"), 1);
+		TS_ASSERT_EQUALS(openMember(set, "B.dat"), 2);
+		TS_ASSERT_EQUALS(openMember(set, "sub/c.dat"), 3);
+		TS_ASSERT_EQUALS(openMember(set, "missing.dat"), -1);
+		TS_ASSERT(set.hasFile(Common::Path("A.DAT")));
+		TS_ASSERT(!set.hasFile(Common::Path("c.dat")));
+
+		// Changing the priorities has to be reflected in the lookups
+		set.setPriority("b", 30);
+		TS_ASSERT_EQUALS(openMember(set, "shared.dat"), 2);
+		set.remove("b");
+		TS_ASSERT_EQUALS(openMember(set, "shared.dat"), 3);
+		set.setPriority("a", 40);
+		TS_ASSERT_EQUALS(openMember(set, "shared.dat"), 1);
+
+		Common::Archive *container = nullptr;
+		TS_ASSERT(set.getMember(Common::Path("sub/c.dat"), &container));
+		TS_ASSERT_EQUALS(container, c);
+
+		// A file gone from an indexed archive is looked up in the next ones
+		a->removeFile("shared.dat");
+		TS_ASSERT_EQUALS(openMember(set, "shared.dat"), 3);
+		TS_ASSERT(set.hasFile(Common::Path("a.dat")));
+	}
+
+	void test_list_matching_members() {
+		Common::SearchSet set;
+		TestArchive *a = new TestArchive(1, true);
+		TestArchive *b = new TestArchive(2, false);
+		a->addFile("music.001");
+		a->addFile("music.002");
+		a->addFile("sub/music.003");
+		b->addFile("music.004");
+		b->addFile("speech.001");
+
+		set.add("a", a, 10);
+		set.add("b", b, 0);
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, Common::Path("music.*")), 3);
+		TS_ASSERT_EQUALS(list.size(), 3u);
+		TS_ASSERT_EQUALS(list.front()->getPathInArchive(), Common::Path("music.001"));
+		TS_ASSERT_EQUALS(list.back()->getPathInArchive(), Common::Path("music.004"));
+
+		list.clear();
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, Common::Path("*/MUSIC.*"), true), 1);
+
+		Common::ArchiveMemberDetailsList details;
+		TS_ASSERT_EQUALS(set.listMatchingMembers(details, Common::Path("*.001")), 2);
+		TS_ASSERT_EQUALS(details.front().arcName, "a");
+		TS_ASSERT_EQUALS(details.back().arcName, "b");
+
+		list.clear();
+		TS_ASSERT_EQUALS(set.listMembers(list), 5);
+	}
+};
@@ -0,0 +1,43 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/thread.h"
+
+#include "../null_osystem.h"
+
+static void incrementJob(void *param) {
+	(*(int *)param)++;
+}
+
+class WorkerPoolTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_wait() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Whether the jobs run on workers or on the waiting thread, they
+		// all have to be done once wait() returns
+		Common::WorkerPool pool(2);
+		int counters[100];
+		memset(counters, 0, sizeof(counters));
+
+		Common::WorkerPool::JobGroup group1, group2;
+		for (int i = 0; i < 100; i++)
+			pool.submit((i & 1) ? group1 : group2, incrementJob, &counters[i]);
+
+		pool.wait(group1);
+		TS_ASSERT(pool.isDone(group1));
+		for (int i = 1; i < 100; i += 2)
+			TS_ASSERT_EQUALS(counters[i], 1);
+
+		pool.wait(group2);
+		TS_ASSERT(pool.isDone(group2));
+		for (int i = 0; i < 100; i++)
+			TS_ASSERT_EQUALS(counters[i], 1);
+
+		// Groups can be reused
+		pool.submit(group1, incrementJob, &counters[0]);
+		pool.wait(group1);
+		TS_ASSERT_EQUALS(counters[0], 2);
+#endif
+	}
+};
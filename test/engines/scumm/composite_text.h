@@ -0,0 +1,55 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/scumm/gfx.h"
+
+#include "test/instrset_detect.h"
+
+/**
+ * Checks the SIMD variants of compositeText against the generic one.
+ */
+class CompositeTextTestSuite : public CxxTest::TestSuite {
+	enum {
+		kPitch = 96,
+		kHeight = 8
+	};
+
+	uint32 _seed;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+public:
+	void test_composite_text_variants() {
+		Scumm::CompositeTextProc procs[2];
+		int numProcs = 0;
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			procs[numProcs++] = Scumm::compositeTextSSE2;
+#endif
+
+		byte src[kPitch * kHeight], text[kPitch * kHeight];
+		byte expected[kPitch * kHeight], actual[kPitch * kHeight];
+
+		_seed = 1;
+		for (int i = 0; i < kPitch * kHeight; i++) {
+			src[i] = nextRandom();
+			// About half of the text pixels let the game graphics through
+			text[i] = (nextRandom() & 1) ? CHARSET_MASK_TRANSPARENCY : nextRandom();
+		}
+
+		for (int p = 0; p < numProcs; p++) {
+			// Widths below, at and above the SIMD width, with and without a
+			// remainder for the generic code
+			for (int width = 4; width <= 80; width += 4) {
+				memset(expected, 0, sizeof(expected));
+				memset(actual, 0, sizeof(actual));
+
+				Scumm::compositeText(expected, kPitch, src, kPitch, text, kPitch, width, kHeight);
+				procs[p](actual, kPitch, src, kPitch, text, kPitch, width, kHeight);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(expected)), 0);
+			}
+		}
+	}
+};
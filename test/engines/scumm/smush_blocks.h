@@ -0,0 +1,191 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/util.h"
+
+#include "engines/scumm/smush/codec37.h"
+#include "engines/scumm/smush/codec47.h"
+
+#include "test/instrset_detect.h"
+
+namespace Scumm {
+// The codecs use bompDecodeLine() of bomp.o, which also scales BOMP images
+// with this table from akos.o. Linking akos.o would pull in the whole engine,
+// and the codecs never scale anything.
+extern const byte bigCostumeScaleTable[768];
+const byte bigCostumeScaleTable[768] = { 0 };
+}
+
+/**
+ * Checks the SIMD block kernels of the SMUSH codecs 37 and 47 against the
+ * scalar ones, by decoding the same frames with both.
+ */
+class SmushBlocksTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 64,
+		kHeight = 48,
+		kFrames = 32
+	};
+
+	uint32 _seed;
+
+	byte nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) & 0xFF;
+	}
+
+	int getKernels(Scumm::SmushKernels *kernels) {
+		int count = 0;
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			kernels[count++] = Scumm::kSmushKernelsSSE2;
+#endif
+		return count;
+	}
+
+	/**
+	 * Build a codec 37 frame object. The first frame holds raw pixels, the
+	 * others random block codes of the delta frame types.
+	 */
+	void makeDeltaBlocksFrame(byte *frame, int num) {
+		const int blocks = (kWidth / 4) * (kHeight / 4);
+		static const byte types[] = { 1, 3, 4 };
+
+		memset(frame, 0, 16);
+		frame[0] = num == 0 ? 0 : types[nextRandom() % ARRAYSIZE(types)];
+		frame[1] = nextRandom() % 3;
+		WRITE_LE_UINT16(frame + 2, num);
+		WRITE_LE_UINT32(frame + 4, kWidth * kHeight);
+		frame[12] = nextRandom() & 5;
+
+		byte *dst = frame + 16;
+		if (frame[0] != 3 && frame[0] != 4) {
+			// Raw pixels, or the run length codes of type 1 which always
+			// stop at the end of the frame
+			for (int i = 0; i < blocks * 64; i++)
+				*dst++ = nextRandom();
+			return;
+		}
+
+		const bool fdfe = (frame[12] & 4) != 0;
+		for (int remaining = blocks; remaining > 0;) {
+			const byte code = nextRandom();
+			*dst++ = code;
+			if (code == 0x00 && frame[0] == 4) {
+				// Runs of unchanged blocks must not pass the end of the frame
+				const byte length = nextRandom() % MIN(remaining, 256);
+				*dst++ = length;
+				remaining -= length + 1;
+				continue;
+			}
+
+			if (code == 0xFF) {
+				for (int i = 0; i < 16; i++)
+					*dst++ = nextRandom();
+			} else if (code == 0xFE && fdfe) {
+				for (int i = 0; i < 4; i++)
+					*dst++ = nextRandom();
+			} else if (code == 0xFD && fdfe) {
+				*dst++ = nextRandom();
+			}
+			remaining--;
+		}
+	}
+
+	/**
+	 * Write a random codec 47 block. Only the block codes which copy from
+	 * the same place in another buffer are used, so that the random data
+	 * never moves the blocks out of the frame.
+	 */
+	byte *makeDeltaGlyphsBlock(byte *dst, int level) {
+		static const byte codes[] = { 0x00, 0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF };
+		const byte code = codes[nextRandom() % ARRAYSIZE(codes)];
+		*dst++ = code;
+
+		if (code == 0xFF) {
+			if (level == 3) {
+				for (int i = 0; i < 4; i++)
+					*dst++ = nextRandom();
+			} else {
+				for (int i = 0; i < 4; i++)
+					dst = makeDeltaGlyphsBlock(dst, level + 1);
+			}
+		} else if (code == 0xFE) {
+			*dst++ = nextRandom();
+		} else if (code == 0xFD && level < 3) {
+			for (int i = 0; i < 3; i++)
+				*dst++ = nextRandom();
+		}
+		return dst;
+	}
+
+	/** Build a codec 47 frame object of the block decoding type. */
+	int makeDeltaGlyphsFrame(byte *frame, int num) {
+		memset(frame, 0, 26);
+		WRITE_LE_UINT16(frame + 0, num);
+		frame[2] = 2;
+		frame[3] = nextRandom() % 3;
+		for (int i = 8; i < 14; i++)
+			frame[i] = nextRandom();
+
+		byte *dst = frame + 26;
+		for (int i = 0; i < (kWidth / 8) * (kHeight / 8); i++)
+			dst = makeDeltaGlyphsBlock(dst, 1);
+		return dst - frame;
+	}
+
+public:
+	void test_delta_blocks_kernels() {
+		Scumm::SmushKernels kernels[2];
+		const int numKernels = getKernels(kernels);
+
+		byte *frame = new byte[16 + (kWidth / 4) * (kHeight / 4) * 64];
+		byte *expected = new byte[kWidth * kHeight];
+		byte *actual = new byte[kWidth * kHeight];
+
+		for (int k = 0; k < numKernels; k++) {
+			Scumm::SmushDeltaBlocksDecoder scalar(kWidth, kHeight);
+			Scumm::SmushDeltaBlocksDecoder simd(kWidth, kHeight);
+			simd.setKernels(kernels[k]);
+
+			_seed = 1;
+			for (int i = 0; i < kFrames; i++) {
+				makeDeltaBlocksFrame(frame, i);
+				scalar.decode(expected, frame);
+				simd.decode(actual, frame);
+				TS_ASSERT_EQUALS(memcmp(expected, actual, kWidth * kHeight), 0);
+			}
+		}
+
+		delete[] frame;
+		delete[] expected;
+		delete[] actual;
+	}
+
+	void test_delta_glyphs_kernels() {
+		Scumm::SmushKernels kernels[2];
+		const int numKernels = getKernels(kernels);
+
+		// Each 8x8 block takes at most 1 + 4 * (1 + 4 * 5) bytes
+		byte *frame = new byte[26 + (kWidth / 8) * (kHeight / 8) * 85];
+		byte *expected = new byte[kWidth * kHeight];
+		byte *actual = new byte[kWidth * kHeight];
+
+		for (int k = 0; k < numKernels; k++) {
+			Scumm::SmushDeltaGlyphsDecoder scalar(kWidth, kHeight);
+			Scumm::SmushDeltaGlyphsDecoder simd(kWidth, kHeight);
+			simd.setKernels(kernels[k]);
+
+			_seed = 1;
+			for (int i = 0; i < kFrames; i++) {
+				makeDeltaGlyphsFrame(frame, i);
+				TS_ASSERT(scalar.decode(expected, frame));
+				TS_ASSERT(simd.decode(actual, frame));
+				TS_ASSERT_EQUALS(memcmp(expected, actual, kWidth * kHeight), 0);
+			}
+		}
+
+		delete[] frame;
+		delete[] expected;
+		delete[] actual;
+	}
+};
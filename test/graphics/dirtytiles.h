@@ -0,0 +1,98 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/dirtytiles.h"
+#include "graphics/surface.h"
+
+class DirtyTileTrackerTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	void checkHashFunc(Graphics::TileHashFunc hashTile) {
+		byte tile[16 * 64];
+		_seed = 1;
+		for (int i = 0; i < ARRAYSIZE(tile); i++)
+			tile[i] = nextRandom();
+
+		for (uint rowBytes = 1; rowBytes <= 64; rowBytes++) {
+			for (uint rows = 1; rows <= 16; rows += 5)
+				TS_ASSERT_EQUALS(hashTile(tile, 64, rowBytes, rows),
+					Graphics::DirtyTileTracker::hashTileGeneric(tile, 64, rowBytes, rows));
+		}
+	}
+
+	public:
+	void test_hash() {
+		byte tile[32 * 16];
+		memset(tile, 0x55, sizeof(tile));
+		const uint64 hash = Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 32, 16);
+		const uint64 narrowHash = Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 31, 16);
+
+		// Only the bytes inside the tile are hashed
+		tile[16 * 32 - 1] = 0;
+		TS_ASSERT_EQUALS(Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 31, 16), narrowHash);
+		TS_ASSERT_DIFFERS(Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 32, 16), hash);
+
+		// Swapping two pixels has to change the hash
+		tile[16 * 32 - 1] = 0x55;
+		tile[3] = 0x54;
+		const uint64 swapped = Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 32, 16);
+		tile[3] = 0x55;
+		tile[35] = 0x54;
+		TS_ASSERT_DIFFERS(Graphics::DirtyTileTracker::hashTileGeneric(tile, 32, 32, 16), swapped);
+
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkHashFunc(Graphics::DirtyTileTracker::hashTileSSE2);
+#endif
+	}
+
+	void test_update() {
+		Graphics::Surface surface;
+		surface.create(100, 70, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		surface.fillRect(Common::Rect(100, 70), 0x1234);
+
+		Graphics::DirtyTileTracker tracker(Graphics::DirtyTileTracker::hashTileGeneric);
+		Common::Array<Common::Rect> dirtyRects;
+
+		// Everything has changed the first time
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(10, 10, 20, 20), dirtyRects), 100u * 70u);
+		TS_ASSERT_EQUALS(dirtyRects.size(), 1u);
+		TS_ASSERT_EQUALS(dirtyRects[0], Common::Rect(100, 70));
+
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(100, 70), dirtyRects), 0u);
+		TS_ASSERT(dirtyRects.empty());
+
+		// A single pixel in the clipped last tile
+		surface.setPixel(99, 69, 0);
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(100, 70), dirtyRects), 4u * 6u);
+		TS_ASSERT_EQUALS(dirtyRects.size(), 1u);
+		TS_ASSERT_EQUALS(dirtyRects[0], Common::Rect(96, 64, 100, 70));
+
+		// Changes outside of the area are not looked at
+		surface.setPixel(0, 0, 0);
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(16, 0, 100, 70), dirtyRects), 0u);
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(0, 0, 1, 1), dirtyRects), 16u * 16u);
+		TS_ASSERT_EQUALS(dirtyRects[0], Common::Rect(16, 16));
+
+		// Adjacent tiles are merged
+		surface.fillRect(Common::Rect(20, 20, 40, 50), 0);
+		surface.setPixel(70, 20, 0);
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(100, 70), dirtyRects), 32u * 48u + 16u * 16u);
+		TS_ASSERT_EQUALS(dirtyRects.size(), 2u);
+		TS_ASSERT_EQUALS(dirtyRects[0], Common::Rect(16, 16, 48, 64));
+		TS_ASSERT_EQUALS(dirtyRects[1], Common::Rect(64, 16, 80, 32));
+
+		TS_ASSERT_EQUALS(tracker.getChangedPixels(), 100u * 70u + 4u * 6u + 16u * 16u + 32u * 48u + 16u * 16u);
+
+		// Forgetting the checksums makes everything changed again
+		tracker.reset();
+		TS_ASSERT_EQUALS(tracker.update(surface, Common::Rect(), dirtyRects), 100u * 70u);
+
+		surface.free();
+	}
+};
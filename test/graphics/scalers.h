@@ -0,0 +1,116 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/thread.h"
+
+#include "graphics/scalerplugin.h"
+
+#include "../null_osystem.h"
+
+PluginObject *g_NORMAL_getObject();
+#ifdef USE_SCALERS
+PluginObject *g_ADVMAME_getObject();
+PluginObject *g_DOTMATRIX_getObject();
+PluginObject *g_PM_getObject();
+PluginObject *g_SAI_getObject();
+PluginObject *g_SUPEREAGLE_getObject();
+PluginObject *g_SUPERSAI_getObject();
+PluginObject *g_TV_getObject();
+#ifdef USE_HQ_SCALERS
+PluginObject *g_HQ_getObject();
+#endif
+#endif
+
+class ScalerTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return _seed >> 8;
+	}
+
+	// Scale a rect in the middle of a larger surface at once and in bands
+	void checkBands(Common::WorkerPool &pool, PluginObject *object, const Graphics::PixelFormat &format, int width) {
+		ScalerPluginObject *plugin = (ScalerPluginObject *)object;
+		TS_ASSERT(plugin->isThreadSafe());
+
+		const int height = 70, x = 4, y = 5, border = 4;
+		const int srcWidth = x + width + border, srcHeight = y + height + border;
+		const uint bpp = format.bytesPerPixel;
+		const uint32 srcPitch = srcWidth * bpp;
+
+		// Use few colors for the scalers to find edges
+		const uint32 colors[4] = {
+			format.RGBToColor(0, 0, 0), format.RGBToColor(255, 255, 255),
+			format.RGBToColor(200, 40, 40), format.RGBToColor(40, 40, 200)
+		};
+		byte *src = new byte[srcHeight * srcPitch];
+		_seed = 1;
+		for (int i = 0; i < srcWidth * srcHeight; i++) {
+			const uint32 color = colors[nextRandom() & 3];
+			if (bpp == 2)
+				((uint16 *)src)[i] = color;
+			else
+				((uint32 *)src)[i] = color;
+		}
+		const byte *srcPtr = src + y * srcPitch + x * bpp;
+
+		Scaler *scaler = plugin->createInstance(format);
+		const Common::Array<uint> &factors = plugin->getFactors();
+		for (uint i = 0; i < factors.size(); i++) {
+			scaler->setFactor(factors[i]);
+			const uint32 dstPitch = width * factors[i] * bpp;
+			const uint dstSize = height * factors[i] * dstPitch;
+			byte *expected = new byte[dstSize];
+			byte *actual = new byte[dstSize];
+
+			scaler->scale(srcPtr, srcPitch, expected, dstPitch, width, height, x, y);
+			for (uint numBands = 2; numBands <= 7; numBands += 5) {
+				memset(actual, 0, dstSize);
+				scaler->scaleInBands(pool, numBands, srcPtr, srcPitch, actual, dstPitch, width, height, x, y);
+				TSM_ASSERT_EQUALS(Common::String::format("%s %dx, %d bands", plugin->getName(), factors[i], numBands).c_str(), memcmp(expected, actual, dstSize), 0);
+			}
+
+			delete[] expected;
+			delete[] actual;
+		}
+
+		delete scaler;
+		delete[] src;
+		delete object;
+	}
+
+	void checkBands(PluginObject *(*getObject)()) {
+		Common::WorkerPool pool(2);
+
+		// Some scalers have a faster path for widths multiple of 8
+		for (int width = 37; width <= 48; width += 11) {
+			checkBands(pool, getObject(), Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), width);
+			checkBands(pool, getObject(), Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), width);
+		}
+	}
+
+	public:
+	void test_scale_in_bands() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		checkBands(g_NORMAL_getObject);
+#ifdef USE_SCALERS
+		checkBands(g_ADVMAME_getObject);
+		checkBands(g_DOTMATRIX_getObject);
+		checkBands(g_PM_getObject);
+		checkBands(g_SAI_getObject);
+		checkBands(g_SUPEREAGLE_getObject);
+		checkBands(g_SUPERSAI_getObject);
+		checkBands(g_TV_getObject);
+#ifdef USE_HQ_SCALERS
+		checkBands(g_HQ_getObject);
+#endif
+#endif
+#endif
+	}
+};
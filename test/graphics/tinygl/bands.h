@@ -0,0 +1,137 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/system.h"
+
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zblit_public.h"
+#include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/zspan.h"
+
+#include "../../null_osystem.h"
+
+class TinyGLBandsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 160,
+		kHeight = 120
+	};
+
+	uint32 _seed;
+
+	float nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 8) & 0xFFFF) / 65535.0f;
+	}
+
+	void drawScene() {
+		_seed = 1;
+
+		Graphics::Surface imageSurface;
+		imageSurface.create(32, 24, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		for (int y = 0; y < imageSurface.h; y++) {
+			for (int x = 0; x < imageSurface.w; x++)
+				*(uint32 *)imageSurface.getBasePtr(x, y) = imageSurface.format.ARGBToColor((x ^ y) * 8, x * 8, y * 10, 255 - x * 4);
+		}
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, imageSurface, 0, false);
+		imageSurface.free();
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0, kWidth, kHeight, 0, -1, 1);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClearDepth(1.0);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglDepthFunc(TGL_LESS);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+
+		// Large overlapping triangles crossing several bands, alternating the
+		// state the draw calls capture
+		for (int i = 0; i < 24; i++) {
+			if (i & 1)
+				tglEnable(TGL_BLEND);
+			else
+				tglDisable(TGL_BLEND);
+			tglShadeModel((i & 2) ? TGL_FLAT : TGL_SMOOTH);
+
+			tglBegin(TGL_TRIANGLES);
+			for (int v = 0; v < 3; v++) {
+				tglColor4f(nextRandom(), nextRandom(), nextRandom(), 0.25f + nextRandom() * 0.75f);
+				tglVertex3f(nextRandom() * kWidth * 1.2f - kWidth * 0.1f, nextRandom() * kHeight * 1.2f - kHeight * 0.1f, nextRandom() * 1.8f - 0.9f);
+			}
+			tglEnd();
+
+			// Blits run on the main context, in between the bands
+			if (i % 8 == 4)
+				tglBlit(image, i * 5, i * 3);
+		}
+		tglDeleteBlitImage(image);
+
+		tglDisable(TGL_BLEND);
+		tglBegin(TGL_LINE_STRIP);
+		for (int v = 0; v < 16; v++) {
+			tglColor3f(nextRandom(), nextRandom(), nextRandom());
+			tglVertex3f(nextRandom() * kWidth, nextRandom() * kHeight, -0.95f);
+		}
+		tglEnd();
+
+		tglBegin(TGL_POINTS);
+		for (int v = 0; v < 64; v++) {
+			tglColor3f(nextRandom(), nextRandom(), nextRandom());
+			tglVertex3f(nextRandom() * kWidth, nextRandom() * kHeight, -0.95f);
+		}
+		tglEnd();
+	}
+
+	Graphics::Surface *render(bool dirtyRects, uint numBands) {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, true, dirtyRects);
+
+		// The bands are set up when presenting the previous frame
+		TinyGL::enableTiledRasterization(numBands != 0, numBands);
+		TinyGL::presentBuffer();
+		TS_ASSERT_EQUALS(TinyGL::gl_get_context()->_rasterizationBands.size(), numBands);
+
+		drawScene();
+		TinyGL::presentBuffer();
+
+		Graphics::Surface surface;
+		TinyGL::getSurfaceRef(surface);
+		Graphics::Surface *copy = new Graphics::Surface();
+		copy->copyFrom(surface);
+
+		TinyGL::destroyContext(context);
+		return copy;
+	}
+
+public:
+	void test_bands_match_serial() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		TinyGL::SpanFiller::init(nullptr);
+
+		for (int dirtyRects = 0; dirtyRects < 2; dirtyRects++) {
+			Graphics::Surface *serial = render(dirtyRects, 0);
+			const uint numBands[] = { 2, 3, 7 };
+			for (int i = 0; i < ARRAYSIZE(numBands); i++) {
+				Graphics::Surface *banded = render(dirtyRects, numBands[i]);
+				for (int y = 0; y < kHeight; y++)
+					TS_ASSERT_EQUALS(memcmp(serial->getBasePtr(0, y), banded->getBasePtr(0, y), kWidth * 4), 0);
+				banded->free();
+				delete banded;
+			}
+			serial->free();
+			delete serial;
+		}
+#endif
+	}
+};
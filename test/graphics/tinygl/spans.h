@@ -0,0 +1,191 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "graphics/tinygl/zbuffer.h"
+
+#include "../../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class TinyGLSpanFillerTestSuite : public CxxTest::TestSuite {
+	struct Config {
+		bool smooth;
+		bool blending;
+		bool depthTest;
+		bool depthWrite;
+		int depthFunc;
+		bool scissor;
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % max;
+	}
+
+	void setupFrameBuffer(TinyGL::FrameBuffer &fb, const Config &config) {
+		fb.enableBlending(config.blending);
+		fb.setBlendingFactors(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		fb.enableAlphaTest(false);
+		fb.enableDepthTest(config.depthTest);
+		fb.setDepthFunc(config.depthFunc);
+		fb.enableDepthWrite(config.depthWrite);
+		fb.enableStencilTest(false);
+		fb.enablePolygonStipple(false);
+		fb.setOffsetStates(0);
+		fb.setFogEnabled(false);
+		if (config.scissor)
+			fb.setScissorRectangle(Common::Rect(13, 7, 101, 83));
+		else
+			fb.resetScissorRectangle();
+		fb.clear(true, 1 << 23, true, 40, 80, 120, false, 0);
+	}
+
+	void randomPoint(TinyGL::ZBufferPoint &p, int width, int height) {
+		p.x = nextRandom(width);
+		p.y = nextRandom(height);
+		p.z = nextRandom(1 << 24);
+		p.r = nextRandom(ZB_POINT_RED_MAX);
+		p.g = nextRandom(ZB_POINT_GREEN_MAX);
+		p.b = nextRandom(ZB_POINT_BLUE_MAX);
+		p.a = nextRandom(ZB_POINT_ALPHA_MAX);
+	}
+
+	void drawTriangles(TinyGL::FrameBuffer &fb, const Config &config, int count, uint32 seed) {
+		_seed = seed;
+		for (int i = 0; i < count; i++) {
+			TinyGL::ZBufferPoint p0, p1, p2;
+			randomPoint(p0, fb.getPixelBufferWidth(), fb.getPixelBufferHeight());
+			randomPoint(p1, fb.getPixelBufferWidth(), fb.getPixelBufferHeight());
+			randomPoint(p2, fb.getPixelBufferWidth(), fb.getPixelBufferHeight());
+			if (config.smooth)
+				fb.fillTriangleSmooth(&p0, &p1, &p2);
+			else
+				fb.fillTriangleFlat(&p0, &p1, &p2);
+		}
+	}
+
+	void checkKernel(TinyGL::ShadedSpanFunc kernel, const Graphics::PixelFormat &format) {
+		static const int depthFuncs[] = {
+			TGL_NEVER, TGL_LESS, TGL_EQUAL, TGL_LEQUAL, TGL_GREATER, TGL_NOTEQUAL, TGL_GEQUAL, TGL_ALWAYS
+		};
+		const int width = 123, height = 91;
+
+		for (int variant = 0; variant < 64; variant++) {
+			Config config;
+			config.smooth = variant & 1;
+			config.blending = variant & 2;
+			config.depthTest = variant & 4;
+			config.depthWrite = variant & 8;
+			config.scissor = variant & 16;
+			config.depthFunc = TGL_LESS;
+
+			for (int i = 0; i < ARRAYSIZE(depthFuncs); i++) {
+				config.depthFunc = depthFuncs[i];
+
+				TinyGL::FrameBuffer expected(width, height, format, false);
+				TinyGL::FrameBuffer actual(width, height, format, false);
+				setupFrameBuffer(expected, config);
+				setupFrameBuffer(actual, config);
+
+				TinyGL::SpanFiller::shadedSpanFunc = nullptr;
+				drawTriangles(expected, config, 40, variant * 8 + i);
+				TinyGL::SpanFiller::shadedSpanFunc = kernel;
+				drawTriangles(actual, config, 40, variant * 8 + i);
+				TinyGL::SpanFiller::shadedSpanFunc = nullptr;
+
+				TS_ASSERT_EQUALS(memcmp(expected.getPixelBuffer(), actual.getPixelBuffer(), height * expected.getPixelBufferPitch()), 0);
+				TS_ASSERT_EQUALS(memcmp(expected.getZBuffer(), actual.getZBuffer(), width * height * sizeof(uint)), 0);
+
+				if (!config.depthTest)
+					break;
+			}
+		}
+	}
+
+	void checkKernel(TinyGL::ShadedSpanFunc kernel) {
+		checkKernel(kernel, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		checkKernel(kernel, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		checkKernel(kernel, Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24));
+	}
+
+public:
+	void test_shaded_spans() {
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			checkKernel(TinyGL::SpanFiller::fillShadedSpanSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			checkKernel(TinyGL::SpanFiller::fillShadedSpanAVX2);
+#endif
+	}
+
+	void test_shaded_triangle_throughput() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		TinyGL::ShadedSpanFunc kernel = nullptr;
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			kernel = TinyGL::SpanFiller::fillShadedSpanSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			kernel = TinyGL::SpanFiller::fillShadedSpanAVX2;
+#endif
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 2;
+#endif
+		const int triangles = 500;
+
+		Config config;
+		config.smooth = true;
+		config.depthTest = true;
+		config.depthWrite = true;
+		config.depthFunc = TGL_LESS;
+		config.scissor = false;
+
+		for (int blending = 0; blending < 2; blending++) {
+			config.blending = blending;
+			TinyGL::FrameBuffer fb(640, 480, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), false);
+
+			TinyGL::SpanFiller::shadedSpanFunc = nullptr;
+			uint32 scalarStart = g_system->getMillis();
+			for (int i = 0; i < iters; i++) {
+				setupFrameBuffer(fb, config);
+				drawTriangles(fb, config, triangles, i);
+			}
+			uint32 scalarTime = g_system->getMillis() - scalarStart;
+
+			TinyGL::SpanFiller::shadedSpanFunc = kernel;
+			uint32 simdStart = g_system->getMillis();
+			for (int i = 0; i < iters; i++) {
+				setupFrameBuffer(fb, config);
+				drawTriangles(fb, config, triangles, i);
+			}
+			uint32 simdTime = g_system->getMillis() - simdStart;
+			TinyGL::SpanFiller::shadedSpanFunc = nullptr;
+
+			debug("TinyGL %s smooth triangles (scalar) time for %d x %d triangles (in milliseconds): %d\n",
+			      blending ? "blended" : "opaque", iters, triangles, scalarTime);
+			debug("TinyGL %s smooth triangles (SIMD) time for %d x %d triangles (in milliseconds): %d\n",
+			      blending ? "blended" : "opaque", iters, triangles, simdTime);
+		}
+#endif
+	}
+};
@@ -0,0 +1,263 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/file.h"
+#include "common/ptr.h"
+#include "common/ustr.h"
+
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/surface.h"
+
+#include "../null_osystem.h"
+
+class TTFFontTestSuite : public CxxTest::TestSuite {
+#ifdef USE_FREETYPE2
+	static Graphics::Font *loadFont(int size, const uint32 *mapping = nullptr) {
+		Common::File file;
+		if (!file.open("FreeSans.ttf"))
+			return nullptr;
+		return Graphics::loadTTFFont(file, size, Graphics::kTTFSizeModeCharacter, 0, 0, Graphics::kTTFRenderModeLight, mapping);
+	}
+
+	/** Lay out a string without the layout cache, like drawString used to. */
+	template<class StringType>
+	static Common::Array<int> layOutString(const Graphics::Font &font, const StringType &str) {
+		Common::Array<int> penX;
+		int x = 0;
+		typename StringType::unsigned_type last = 0;
+		for (uint i = 0; i < str.size(); ++i) {
+			const typename StringType::unsigned_type cur = str[i];
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+			penX.push_back(x);
+			x += font.getCharWidth(cur);
+		}
+		penX.push_back(x);
+		return penX;
+	}
+
+	template<class StringType>
+	void checkLayout(const Graphics::Font &font, const StringType &str) {
+		const Common::Array<int> expected = layOutString(font, str);
+		const Common::Array<int> *layout = font.getStringLayout(str);
+		TS_ASSERT(layout);
+		if (!layout)
+			return;
+
+		TS_ASSERT_EQUALS(layout->size(), expected.size());
+		for (uint i = 0; i < expected.size() && i < layout->size(); ++i)
+			TS_ASSERT_EQUALS((*layout)[i], expected[i]);
+		TS_ASSERT_EQUALS(font.getStringWidth(str), expected.back());
+	}
+
+	static Graphics::Surface *drawChars(const Graphics::Font &font, const char *chars) {
+		const int count = strlen(chars);
+		const int cellWidth = font.getMaxCharWidth() * 2;
+		Graphics::Surface *surface = new Graphics::Surface();
+		surface->create(cellWidth * count, font.getFontHeight() * 2, Graphics::PixelFormat::createFormatCLUT8());
+		for (int i = 0; i < count; ++i)
+			font.drawChar(surface, (byte)chars[i], i * cellWidth + cellWidth / 4, font.getFontHeight() / 2, 255);
+		return surface;
+	}
+
+	static bool equalSurfaces(const Graphics::Surface &a, const Graphics::Surface &b) {
+		for (int y = 0; y < a.h; ++y) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w))
+				return false;
+		}
+		return true;
+	}
+#endif
+
+public:
+	void test_layouts_match_uncached() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Common::ScopedPtr<Graphics::Font> font(loadFont(16));
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		const char *texts[] = { "", "AV", "Hello, World!", "To Wa Yo LT", "The quick brown fox jumps over the lazy dog" };
+		for (int i = 0; i < ARRAYSIZE(texts); ++i) {
+			checkLayout(*font, Common::String(texts[i]));
+			checkLayout(*font, Common::U32String(texts[i]));
+			// The second query comes from the cache
+			checkLayout(*font, Common::String(texts[i]));
+		}
+
+		Common::U32String unicode;
+		unicode += (Common::u32char_type_t)0x3A9;
+		unicode += (Common::u32char_type_t)0x414;
+		unicode += (Common::u32char_type_t)0x20AC;
+		unicode += Common::U32String("AVA");
+		checkLayout(*font, unicode);
+
+		// Strings too long to be cached are laid out without the cache
+		Common::String longString;
+		for (int i = 0; i < 1100; ++i)
+			longString += 'a' + i % 26;
+		TS_ASSERT(!font->getStringLayout(longString));
+		TS_ASSERT_EQUALS(font->getStringWidth(longString), layOutString(*font, longString).back());
+#endif
+	}
+
+	void test_layout_lru() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		const Graphics::TTFCacheStats before = Graphics::getTTFCacheStats();
+		Graphics::Font *font = loadFont(16);
+		TS_ASSERT(font);
+		if (!font)
+			return;
+
+		// Fill the 256 layouts of the font, then one more evicts the least
+		// recently used one, which is not the first since that was used again
+		for (int i = 0; i < 256; ++i)
+			font->getStringLayout(Common::String::format("%d", i));
+		font->getStringLayout(Common::String("0"));
+		font->getStringLayout(Common::String("overflow"));
+
+		Graphics::TTFCacheStats stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_EQUALS(stats.layouts, before.layouts + 256);
+		TS_ASSERT_LESS_THAN(before.layoutBytes, stats.layoutBytes);
+
+		const uint32 hits = stats.layoutHits, misses = stats.layoutMisses;
+		font->getStringLayout(Common::String("0"));
+		font->getStringLayout(Common::String("overflow"));
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_EQUALS(stats.layoutHits, hits + 2);
+		TS_ASSERT_EQUALS(stats.layoutMisses, misses);
+
+		font->getStringLayout(Common::String("1"));
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_EQUALS(stats.layoutMisses, misses + 1);
+
+		// The layouts are freed with the font
+		delete font;
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_EQUALS(stats.layouts, before.layouts);
+		TS_ASSERT_EQUALS(stats.layoutBytes, before.layoutBytes);
+#endif
+	}
+
+	void test_atlas_eviction() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		Graphics::TTFCacheStats stats = Graphics::getTTFCacheStats();
+		const uint32 pages = stats.atlasPages;
+
+		// The glyphs of a small font are packed into a few pages
+		Graphics::Font *small = loadFont(16);
+		TS_ASSERT(small);
+		if (!small)
+			return;
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_LESS_THAN(pages, stats.atlasPages);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.atlasPages, pages + 2);
+		delete small;
+
+		const uint32 bytes = stats.atlasBytes;
+		const uint32 evictions = stats.atlasEvictions;
+		Common::ScopedPtr<Graphics::Font> font(loadFont(120));
+		TS_ASSERT(font);
+		if (!font)
+			return;
+		const uint32 loadedBytes = Graphics::getTTFCacheStats().atlasBytes - bytes;
+
+		const char *chars = "AgjW@%&";
+		Common::ScopedPtr<Graphics::Surface> before(drawChars(*font, chars));
+
+		// Caching many more glyphs goes over the budget of the font, which
+		// reuses its least recently used pages instead
+		for (uint32 chr = 0x100; chr < 0x500; ++chr)
+			font->getCharWidth(chr);
+
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_LESS_THAN(evictions, stats.atlasEvictions);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.atlasBytes - bytes, MAX(stats.atlasBudget, loadedBytes));
+
+		// The glyphs cached again at other places of the atlas are drawn the
+		// same way
+		Common::ScopedPtr<Graphics::Surface> after(drawChars(*font, chars));
+		TS_ASSERT(equalSurfaces(*before, *after));
+
+		before->free();
+		after->free();
+#endif
+	}
+
+	void test_atlas_fonts() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// A font with a mapping cannot cache its glyphs again, so it keeps
+		// all of its pages
+		uint32 mapping[256];
+		for (int i = 0; i < 256; ++i)
+			mapping[i] = i;
+		Common::ScopedPtr<Graphics::Font> mapped(loadFont(120, mapping));
+		Common::ScopedPtr<Graphics::Font> large(loadFont(120));
+		Common::ScopedPtr<Graphics::Font> reference(loadFont(120));
+		TS_ASSERT(mapped && large && reference);
+		if (!mapped || !large || !reference)
+			return;
+
+		const char *chars = "AgjW@%&";
+		Common::ScopedPtr<Graphics::Surface> mappedBefore(drawChars(*mapped, chars));
+		Common::ScopedPtr<Graphics::Surface> largeBefore(drawChars(*large, chars));
+
+		Common::Array<int> kerning;
+		for (uint32 left = 'A'; left <= 'z'; ++left) {
+			for (uint32 right = 'A'; right <= 'z'; ++right)
+				kerning.push_back(reference->getKerningOffset(left, right));
+		}
+
+		// The large font goes over its own budget
+		Graphics::TTFCacheStats stats = Graphics::getTTFCacheStats();
+		uint32 evictions = stats.atlasEvictions;
+		for (uint32 chr = 0x100; chr < 0x500; ++chr)
+			large->getCharWidth(chr);
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_LESS_THAN(evictions, stats.atlasEvictions);
+
+		// Another font still gets more than one page for its glyphs without
+		// evicting any, whatever the other fonts use
+		const uint32 bytes = stats.atlasBytes;
+		evictions = stats.atlasEvictions;
+		Common::ScopedPtr<Graphics::Font> small(loadFont(32));
+		TS_ASSERT(small);
+		if (!small)
+			return;
+		const uint32 loadedBytes = Graphics::getTTFCacheStats().atlasBytes;
+		for (uint32 chr = 0x100; chr < 0x300; ++chr)
+			small->getCharWidth(chr);
+		stats = Graphics::getTTFCacheStats();
+		TS_ASSERT_EQUALS(stats.atlasEvictions, evictions);
+		TS_ASSERT_LESS_THAN(loadedBytes + 256 * 256, stats.atlasBytes);
+		TS_ASSERT_LESS_THAN_EQUALS(stats.atlasBytes - bytes, stats.atlasBudget);
+
+		// The kerning of glyphs dropped from the atlas and cached again is
+		// still found
+		uint i = 0;
+		for (uint32 left = 'A'; left <= 'z'; ++left) {
+			for (uint32 right = 'A'; right <= 'z'; ++right, ++i)
+				TS_ASSERT_EQUALS(large->getKerningOffset(left, right), kerning[i]);
+		}
+
+		Common::ScopedPtr<Graphics::Surface> mappedAfter(drawChars(*mapped, chars));
+		Common::ScopedPtr<Graphics::Surface> largeAfter(drawChars(*large, chars));
+		TS_ASSERT(equalSurfaces(*mappedBefore, *mappedAfter));
+		TS_ASSERT(equalSurfaces(*largeBefore, *largeAfter));
+
+		mappedBefore->free();
+		mappedAfter->free();
+		largeBefore->free();
+		largeAfter->free();
+#endif
+	}
+};
@@ -24,9 +24,13 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/bufferedstream.h"
+#include "common/archive.h"
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/system.h"
+#include "common/thread.h"
 
 namespace Video {
 
@@ -76,6 +80,26 @@ void VideoDecoder::close() {
 }
 
 bool VideoDecoder::loadFile(const Common::Path &filename) {
+	// When a worker thread is available, read the file ahead of the
+	// decoder so that sequential playback does not wait on the disk. The
+	// worker reads the file on its own, so this is limited to plain files,
+	// which have a handle of their own.
+	if (prefetchFile() && Common::WorkerPool::instance().getNumThreads() > 0) {
+		Common::Archive *container = nullptr;
+		Common::ArchiveMemberPtr member = SearchMan.getMember(filename, &container);
+		Common::SeekableReadStream *file = nullptr;
+		if (member && dynamic_cast<Common::FSDirectory *>(container))
+			file = member->createReadStream();
+
+		if (file) {
+			Common::SeekableReadStream *stream = Common::wrapPrefetchingReadStream(file, 64 * 1024, DisposeAfterUse::YES);
+			bool result = loadStream(stream);
+			if (!result)
+				delete stream;
+			return result;
+		}
+	}
+
 	Common::File *file = new Common::File();
 
 	if (!file->open(filename)) {
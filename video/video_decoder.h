@@ -469,6 +469,16 @@ public:
 	uint getAudioTrackCount() const;
 
 protected:
+	/**
+	 * Whether loadFile() may read the file ahead of the decoder on a
+	 * worker thread. This only pays off for decoders which read their
+	 * file sequentially, so it is off by default.
+	 *
+	 * Only files found directly in a game directory are prefetched, as
+	 * archive members may share one file handle with the other members.
+	 */
+	virtual bool prefetchFile() const { return false; }
+
 	/**
 	 * An abstract representation of a track in a movie. Since tracks here are designed
 	 * to work independently, they should not reference any other track(s) in the video.